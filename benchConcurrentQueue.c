@@ -0,0 +1,233 @@
+#define _GNU_SOURCE
+
+#include "ExtLib/ConcurrentQueue.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NBITEMS 10000000
+#define NBPINGS 200000
+#define BATCH 32
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+
+typedef struct {
+    SpscQueue q;
+    bool batch;
+    long sum;
+} SpscArgs;
+
+static void *spscProducer(SpscArgs *args) {
+    long buf[BATCH];
+
+    for(long i=0; i<NBITEMS; ) {
+        if(args->batch) {
+            int nb = NBITEMS-i < BATCH ? NBITEMS-i : BATCH;
+            for(int k=0; k<nb; k++)
+                buf[k] = i+k;
+            int pushed = 0;
+            while((pushed += spscQueuePushMany(args->q, buf+pushed, nb-pushed)) < nb)
+                sched_yield();
+            i += nb;
+        }
+        else {
+            while(!spscQueuePush(args->q, i))
+                sched_yield();
+            i++;
+        }
+    }
+
+    return NULL;
+}
+
+static void *spscConsumer(SpscArgs *args) {
+    long buf[BATCH];
+    long v;
+
+    for(long i=0; i<NBITEMS; ) {
+        if(args->batch) {
+            int nb = spscQueuePopMany(args->q, buf, BATCH);
+            for(int k=0; k<nb; k++)
+                args->sum += buf[k];
+            i += nb;
+            if(!nb)
+                sched_yield();
+        }
+        else if(spscQueuePop(args->q, v)) {
+            args->sum += v;
+            i++;
+        }
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void benchSpsc(bool batch) {
+    SpscArgs args = {spscQueueNew(EL_LONG, 1024), batch, 0};
+    pthread_t prod, cons;
+
+    double start = now();
+    pthread_create(&prod, NULL, (void *(*)(void *))spscProducer, &args);
+    pthread_create(&cons, NULL, (void *(*)(void *))spscConsumer, &args);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    double elapsed = now() - start;
+
+    long expected = (long)NBITEMS*(NBITEMS-1)/2;
+    printf("SPSC %-6s : %6.1f Mitems/s %s\n", batch ? "batch" : "single", NBITEMS/elapsed/1e6, args.sum == expected ? "ok" : "LOST ITEMS");
+
+    spscQueueDel(args.q);
+}
+
+
+
+typedef struct {
+    MpmcQueue q;
+    int id;
+    int nbThreads;
+    bool batch;
+    long sum;
+} MpmcArgs;
+
+static void *mpmcProducer(MpmcArgs *args) {
+    long buf[BATCH];
+
+    // Producer id sends id, id+n, id+2n...
+    for(long i=args->id; i<NBITEMS; ) {
+        if(args->batch) {
+            int nb = 0;
+            for(; nb<BATCH && i<NBITEMS; nb++, i+=args->nbThreads)
+                buf[nb] = i;
+            int pushed = 0;
+            while((pushed += mpmcQueuePushMany(args->q, buf+pushed, nb-pushed)) < nb)
+                sched_yield();
+        }
+        else {
+            while(!mpmcQueuePush(args->q, i))
+                sched_yield();
+            i += args->nbThreads;
+        }
+    }
+
+    return NULL;
+}
+
+static long consumed;
+
+static void *mpmcConsumer(MpmcArgs *args) {
+    long buf[BATCH];
+
+    while(__atomic_load_n(&consumed, __ATOMIC_RELAXED) < NBITEMS) {
+        int nb = mpmcQueuePopMany(args->q, buf, args->batch ? BATCH : 1);
+
+        for(int k=0; k<nb; k++)
+            args->sum += buf[k];
+
+        if(nb)
+            __atomic_add_fetch(&consumed, nb, __ATOMIC_RELAXED);
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void benchMpmc(int pairs, bool batch) {
+    MpmcQueue q = mpmcQueueNew(EL_LONG, 1024);
+    MpmcArgs *args = malloc(2*pairs*sizeof(MpmcArgs));
+    pthread_t *threads = malloc(2*pairs*sizeof(pthread_t));
+
+    consumed = 0;
+
+    double start = now();
+    for(int i=0; i<2*pairs; i++) {
+        args[i] = (MpmcArgs){q, i%pairs, pairs, batch, 0};
+        pthread_create(&threads[i], NULL, (void *(*)(void *))(i < pairs ? mpmcProducer : mpmcConsumer), &args[i]);
+    }
+
+    long sum = 0;
+    for(int i=0; i<2*pairs; i++) {
+        pthread_join(threads[i], NULL);
+        sum += args[i].sum;
+    }
+    double elapsed = now() - start;
+
+    long expected = (long)NBITEMS*(NBITEMS-1)/2;
+    printf("MPMC %-6s %d+%d threads : %6.1f Mitems/s %s\n", batch ? "batch" : "single", pairs, pairs, NBITEMS/elapsed/1e6, sum == expected ? "ok" : "LOST ITEMS");
+
+    free(threads);
+    free(args);
+    mpmcQueueDel(q);
+}
+
+
+
+typedef struct {
+    SpscQueue ping;
+    SpscQueue pong;
+} PingArgs;
+
+static void *ponger(PingArgs *args) {
+    long v;
+
+    for(int i=0; i<NBPINGS; i++) {
+        while(!spscQueuePop(args->ping, v))
+            sched_yield();
+        while(!spscQueuePush(args->pong, v))
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+// Round trip through 2 SPSC queues between 2 threads
+static void benchLatency() {
+    PingArgs args = {spscQueueNew(EL_LONG, 64), spscQueueNew(EL_LONG, 64)};
+    pthread_t thread;
+    long v;
+
+    pthread_create(&thread, NULL, (void *(*)(void *))ponger, &args);
+
+    double start = now();
+    for(long i=0; i<NBPINGS; i++) {
+        while(!spscQueuePush(args.ping, i))
+            sched_yield();
+        while(!spscQueuePop(args.pong, v))
+            sched_yield();
+    }
+    double elapsed = now() - start;
+
+    pthread_join(thread, NULL);
+
+    printf("SPSC round trip latency : %.0f ns\n", elapsed/NBPINGS*1e9);
+
+    spscQueueDel(args.ping);
+    spscQueueDel(args.pong);
+}
+
+
+
+int main() {
+    benchSpsc(false);
+    benchSpsc(true);
+
+    for(int pairs=1; pairs<=4; pairs*=2) {
+        benchMpmc(pairs, false);
+        benchMpmc(pairs, true);
+    }
+
+    benchLatency();
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/String.h"
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NBKEYS (1<<20)
+
+static unsigned long djb2(const void *data, int length) {
+    const unsigned char *str = data;
+    unsigned long hash = 5381;
+
+    for(int i=0; i<length; i++)
+        hash = ((hash << 5) + hash) + str[i];
+
+    return hash;
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+
+static double pow1(double x, int n) {
+    double r = 1.0;
+    while(n) {
+        if(n&1)
+            r *= x;
+        x *= x;
+        n >>= 1;
+    }
+    return r;
+}
+
+// Ratio between the number of collisions in a power of two table and the number expected from a random function
+static double collisionRatio(unsigned long *hashes, int nb, int bits) {
+    int size = 1<<bits;
+    int *buckets = calloc(size, sizeof(int));
+    long collisions = 0;
+
+    for(int i=0; i<nb; i++)
+        if(buckets[hashes[i] & (size-1)]++)
+            collisions++;
+
+    free(buckets);
+
+    double expected = nb - size + size*pow1(1.0 - 1.0/size, nb);
+    return collisions / expected;
+}
+
+// Mean deviation from 50% of the probability that an output bit flips when one input bit flips
+static double avalancheBias(unsigned long (*fct)(const void *, int), int length) {
+    unsigned char buf[64];
+    long flips[64][64] = {{0}};
+    int rounds = 2000;
+
+    srand(42);
+
+    for(int r=0; r<rounds; r++) {
+        for(int i=0; i<length; i++)
+            buf[i] = rand();
+
+        unsigned long base = fct(buf, length);
+
+        for(int bit=0; bit<8*length && bit<64; bit++) {
+            buf[bit/8] ^= 1<<(bit%8);
+            unsigned long diff = base ^ fct(buf, length);
+            buf[bit/8] ^= 1<<(bit%8);
+
+            for(int o=0; o<64; o++)
+                flips[bit][o] += (diff>>o)&1;
+        }
+    }
+
+    int inBits = 8*length < 64 ? 8*length : 64;
+    double bias = 0;
+    for(int bit=0; bit<inBits; bit++)
+        for(int o=0; o<64; o++) {
+            double p = (double)flips[bit][o]/rounds;
+            bias += p > 0.5 ? p - 0.5 : 0.5 - p;
+        }
+
+    return 2 * bias / (inBits*64);
+}
+
+static void testQuality(const char *name, unsigned long (*fct)(const void *, int)) {
+    unsigned long *hashes = malloc(NBKEYS*sizeof(unsigned long));
+    char buf[32];
+
+    printf("%s\n", name);
+
+    // Sequential integers
+    for(int i=0; i<NBKEYS; i++)
+        hashes[i] = fct(&i, sizeof(int));
+    printf("\tsequential ints : collision ratio %.3f\n", collisionRatio(hashes, NBKEYS, 20));
+
+    // Integers with a large power of two stride
+    for(int i=0; i<NBKEYS; i++) {
+        long k = (long)i << 16;
+        hashes[i] = fct(&k, sizeof(long));
+    }
+    printf("\tstrided longs   : collision ratio %.3f\n", collisionRatio(hashes, NBKEYS, 20));
+
+    // Short similar words
+    for(int i=0; i<NBKEYS; i++) {
+        int len = sprintf(buf, "key%d", i);
+        hashes[i] = fct(buf, len);
+    }
+    printf("\tshort words     : collision ratio %.3f\n", collisionRatio(hashes, NBKEYS, 20));
+
+    printf("\tavalanche bias (8 bytes)  : %.4f\n", avalancheBias(fct, 8));
+    printf("\tavalanche bias (40 bytes) : %.4f\n", avalancheBias(fct, 40));
+
+    free(hashes);
+}
+
+static void testThroughput(const char *name, unsigned long (*fct)(const void *, int)) {
+    int sizes[] = {8, 32, 256, 4096};
+    char *buf = malloc(1<<16);
+    unsigned long sink = 0;
+
+    for(int i=0; i<(1<<16); i++)
+        buf[i] = rand();
+
+    printf("%s\n", name);
+
+    for(int s=0; s<4; s++) {
+        long total = 1L<<28;
+        int nb = total / sizes[s];
+
+        double start = now();
+        for(int i=0; i<nb; i++)
+            sink += fct(buf + (i&255), sizes[s]);
+        double elapsed = now() - start;
+
+        printf("\t%5d bytes : %8.1f MB/s, %6.1f Mhash/s\n", sizes[s], total/elapsed/1e6, nb/elapsed/1e6);
+    }
+
+    free(buf);
+
+    if(sink == 42)
+        printf("\n");
+}
+
+static void testHashTable() {
+    int nb = 1000000;
+    long found = 0;
+
+    Hash h = hashNew(EL_INT, EL_INT, NULL);
+
+    double start = now();
+    for(int i=0; i<nb; i++) {
+        int k = i*64;
+        hashSet(h, k, i);
+    }
+    double inserted = now();
+    for(int i=0; i<nb; i++) {
+        int k = i*64;
+        found += hashContains(h, k);
+    }
+    double end = now();
+
+    printf("Hash(EL_INT) with default hash function\n");
+    printf("\t%d inserts in %.3f s, %ld/%d lookups in %.3f s\n", nb, inserted-start, found, nb, end-inserted);
+
+    hashDel(h);
+}
+
+
+
+int main() {
+    testQuality("DJB2", djb2);
+    testQuality("hashBytes", hashBytes);
+
+    testThroughput("DJB2", djb2);
+    testThroughput("hashBytes", hashBytes);
+
+    testHashTable();
+
+    return 0;
+}
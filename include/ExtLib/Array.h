@@ -15,10 +15,14 @@
 #define EXTLIB_ARRAY_H
 
 #include "Common.h"
+#include "ThreadPool.h"
 
 /** Array : type for an array. */
 typedef struct _Array *Array;
 
+/** ArrayIndex : type for a search index over a sorted array. */
+typedef struct _ArrayIndex *ArrayIndex;
+
 
 
 /** \brief Creates a new array.
@@ -29,6 +33,18 @@ typedef struct _Array *Array;
  */
 Array arrayNew(int elemSize);
 
+/** \brief Creates a new array from a contiguous buffer of elements, which is taken over instead of copied.
+ * Pointer-sized elements (like EL_LONG, EL_DOUBLE or pointers) are used as is, smaller ones are spread in place over a buffer enlarged with realloc.
+ * Bigger elements don't fit in the array storage : they are copied, then the buffer is freed.
+ *
+ * \param elemSize : the size in bytes of each element of the array. You can use the EL_* constants for the basic types, this will automatically link the comparison function too.
+ * \param rawData : buffer allocated with malloc, owned by the array afterwards.
+ * \param nbElements : number of elements in rawData.
+ * \return New array holding the elements of rawData.
+ *
+ */
+Array arrayNewFromRaw(int elemSize, Ptr rawData, int nbElements);
+
 /** \brief Destroys an array and all its content.
  *
  * \param a : Array to destroy.
@@ -58,6 +74,16 @@ void arrayComparable(Array a, ElCmpFct fct);
  */
 void arrayElementInstanciable(Array a, ElCopyFct copyFct, ElDelFct delFct);
 
+/** \brief Sets how the capacity of the array follows its length. Pushing into a full array multiplies the capacity by growthFactor, and removing elements shrinks it once the length drops to 1/shrinkDivisor of it.
+ *
+ * \param a : Array in which you set the policy.
+ * \param growthFactor : factor greater than 1, EL_DEFGROWTH by default.
+ * \param shrinkDivisor : divisor greater than growthFactor (raised if needed), EL_DEFSHRINK by default. EL_NEVER_SHRINK keeps the capacity, even when the array is cleared.
+ * \return nothing.
+ *
+ */
+void arrayCapacityPolicy(Array a, float growthFactor, int shrinkDivisor);
+
 
 
 /** \brief Copies an array and all its content.
@@ -116,6 +142,24 @@ int arrayLength(const Array a);
  */
 void arrayTrimCapacity(Array a);
 
+/** \brief Makes the capacity of the array at least a given number of elements, in a single allocation.
+ *
+ * \param a : Array to grow.
+ * \param capacity : number of elements the array can hold without reallocating.
+ * \return nothing.
+ *
+ */
+void arrayReserve(Array a, int capacity);
+
+/** \brief Sets the number of elements of the array. Elements after the new length are destroyed, new elements are filled with zero bytes (the copy function isn't called, the deletion function will be).
+ *
+ * \param a : Array to resize.
+ * \param length : new number of elements.
+ * \return nothing.
+ *
+ */
+void arrayResize(Array a, int length);
+
 
 
 /** \brief Tells whether the array contains an element or not, arrayComparable must have been called or the array must have been created with a EL_* constant.
@@ -145,6 +189,42 @@ int arrayIndexOf(const Array a, const Ptr data);
  */
 int arrayLastIndexOf(const Array a, const Ptr data);
 
+/** \brief Returns the number of occurrences of an element in the array, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \param data : Element to count.
+ * \return number of occurrences.
+ *
+ */
+int arrayCount(const Array a, const Ptr data);
+
+/** \brief Returns the index of the first smallest element of the array, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \return index of the smallest element, -1 if the array is empty.
+ *
+ */
+int arrayMinIndex(const Array a);
+
+/** \brief Returns the index of the first greatest element of the array, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \return index of the greatest element, -1 if the array is empty.
+ *
+ */
+int arrayMaxIndex(const Array a);
+
+/** \brief Computes the sum of the elements of an array created with a EL_* constant of a number type (not EL_POINTER nor EL_BOOL). Integers wrap around on overflow, floating numbers may be added in any order.
+ *
+ * \param a : Array to sum.
+ * \param dest : Pointer to the memory receiving the sum, of the type of the elements. Untouched if the array isn't of a number type.
+ * \return nothing.
+ *
+ */
+void arraySum_base(const Array a, Ptr dest);
+/** Automatic macro to send the address of dest to arraySum_base */
+#define arraySum(a, dest) arraySum_base(a, &(dest))
+
 /** \brief Returns the index of an element in the array, array must be sorted in ascending order, arrayComparable must have been called or the vector must have been created with a EL_* constant.
  *
  * \param a : Array to look into.
@@ -154,6 +234,35 @@ int arrayLastIndexOf(const Array a, const Ptr data);
  */
 int arrayBSearch(const Array a, const Ptr data);
 
+/** \brief Returns the position of the first element which is not lower than an element, array must be sorted in ascending order, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \param data : Element to seek.
+ * \return position of the first element >= data, the length of the array if there is none.
+ *
+ */
+int arrayLowerBound(const Array a, const Ptr data);
+
+/** \brief Returns the position of the first element which is greater than an element, array must be sorted in ascending order, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \param data : Element to seek.
+ * \return position of the first element > data, the length of the array if there is none.
+ *
+ */
+int arrayUpperBound(const Array a, const Ptr data);
+
+/** \brief Returns the range of positions of the elements equal to an element, array must be sorted in ascending order, arrayComparable must have been called or the vector must have been created with a EL_* constant.
+ *
+ * \param a : Array to look into.
+ * \param data : Element to seek.
+ * \param from : receives the first position of the range (included), as arrayLowerBound.
+ * \param to : receives the last position of the range (excluded), as arrayUpperBound.
+ * \return nothing.
+ *
+ */
+void arrayEqualRange(const Array a, const Ptr data, int *from, int *to);
+
 
 
 /** \brief Returns the element at a given position in an array.
@@ -205,6 +314,27 @@ void arrayAdd_base(Array a, int pos, const Ptr data);
 #define arrayAdd(a, pos, data) arrayAdd_base(a, pos, &(data))
 #define arrayAddI(a, pos, data, type) {type tmp = (data); arrayAdd_base(a, pos, &(tmp));}
 
+/** \brief Adds elements at the end of an array, growing it at most once.
+ *
+ * \param a : Array to add in.
+ * \param data : Pointer to a contiguous array of elements.
+ * \param nbElements : number of elements in data.
+ * \return nothing.
+ *
+ */
+void arrayPushMany(Array a, const Ptr data, int nbElements);
+
+/** \brief Adds elements at a given position in an array, moving the following ones only once.
+ *
+ * \param a : Array to add in.
+ * \param pos : Position for the first element, 0 is start.
+ * \param data : Pointer to a contiguous array of elements.
+ * \param nbElements : number of elements in data.
+ * \return nothing.
+ *
+ */
+void arrayInsertRange(Array a, int pos, const Ptr data, int nbElements);
+
 
 
 /** \brief Removes the last element in the array.
@@ -224,6 +354,16 @@ void arrayPop(Array a);
  */
 void arrayRemove(Array a, int pos);
 
+/** \brief Removes the elements between two positions in the array, moving the following ones only once.
+ *
+ * \param a : Array to remove in.
+ * \param from : Position of the first element to remove (included).
+ * \param to : Position of the last element to remove (excluded).
+ * \return nothing.
+ *
+ */
+void arrayRemoveRange(Array a, int from, int to);
+
 
 
 /** \brief Sorts the array with a quick sort, arrayComparable must have been called or the vector must have been created with a EL_* constant.
@@ -380,4 +520,148 @@ void arrayItRemove(ArrayIt *it);
  */
 void arrayForEach(Array a, ElActFct actFct, Ptr infos);
 
+/** \brief Copies all the elements of the array bit by bit to a contiguous buffer, with a single memcpy when the elements fill their slots.
+ *
+ * \param a : Array to copy.
+ * \param dest : buffer of at least arrayLength(a) elements.
+ * \return nothing.
+ *
+ */
+void arrayCopyToRaw(const Array a, Ptr dest);
+
+
+
+/** \brief Saves an array to a binary file, which can be loaded back by arrayLoad or mapped in memory by arrayViewOpen. Elements are written bit by bit, so they mustn't have copy or delete functions, nor be pointers (EL_POINTER).
+ *
+ * \param a : Array to save.
+ * \param path : path of the file to write.
+ * \return true on success, false if the file can't be written or the array has copy or delete functions or holds pointers.
+ *
+ */
+bool arraySave(const Array a, const char *path);
+
+/** \brief Loads an array saved by arraySave. The comparison function is linked again if the array was created with an EL_* constant.
+ *
+ * \param path : path of the file to read.
+ * \return New array, or NULL if the file can't be read, isn't a valid array file, is truncated, or the memory can't be allocated.
+ *
+ */
+Array arrayLoad(const char *path);
+
+
+
+// Search index : a copy of a sorted array in BFS order (Eytzinger layout), the first levels of the tree share a few cache lines
+
+/** \brief Creates a search index over an array sorted in ascending order, arrayComparable must have been called or the vector must have been created with a EL_* constant. The array must not be modified nor destroyed while the index is used.
+ *
+ * \param a : Array to index.
+ * \return New search index.
+ *
+ */
+ArrayIndex arrayIndexNew(const Array a);
+
+/** \brief Destroys a search index, the array is left untouched.
+ *
+ * \param idx : ArrayIndex to destroy.
+ * \return void
+ *
+ */
+void arrayIndexDel(ArrayIndex idx);
+
+/** \brief Returns the position in the array of the first element which is not lower than an element, like arrayLowerBound.
+ *
+ * \param idx : ArrayIndex to look into.
+ * \param data : Element to seek.
+ * \return position of the first element >= data, the length of the array if there is none.
+ *
+ */
+int arrayIndexLowerBound(const ArrayIndex idx, const Ptr data);
+
+/** \brief Returns the position in the array of an element.
+ *
+ * \param idx : ArrayIndex to look into.
+ * \param data : Element to seek.
+ * \return first position of the element if found, -1 otherwise.
+ *
+ */
+int arrayIndexFind(const ArrayIndex idx, const Ptr data);
+
+/** \brief Details the heap usage of a given search index
+ *
+ * \param idx : ArrayIndex to dump
+ * \return void
+ *
+ */
+void arrayIndexDump(const ArrayIndex idx);
+
+// Parallel algorithms : small arrays are processed on the calling thread
+
+/** \brief Sorts the array in parallel : chunks are sorted by the threads of a pool then merged, arrayComparable must have been called or the vector must have been created with a EL_* constant. The comparison function must be thread-safe.
+ *
+ * \param a : Array to sort.
+ * \param method : must be EL_ASC or EL_DESC.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return nothing.
+ *
+ */
+void arrayParallelSort(Array a, int method, ThreadPool pool);
+
+/** \brief Returns the position of the first occurence of an element in the array, searching in parallel. The comparison function must be thread-safe.
+ *
+ * \param a : Array to look into.
+ * \param data : Element to seek.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return position of the element if found, -1 otherwise.
+ *
+ */
+int arrayParallelIndexOf(const Array a, const Ptr data, ThreadPool pool);
+
+/** \brief Returns a new array with the elements for which a predicate is true, in the same order, evaluating the predicate in parallel. The predicate and the copy function must be thread-safe.
+ *
+ * \param a : Array to filter.
+ * \param predFct : Pointer to a function called for each element of the array.
+ * \param infos : pointer broadcasted to predFct.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return a new array.
+ *
+ */
+Array arrayParallelFilter(const Array a, ElPredFct predFct, Ptr infos, ThreadPool pool);
+
+/** \brief Makes an action for every element of the array, the elements being split in chunks processed in parallel. The action function must be thread-safe, it may modify the elements but not the array.
+ *
+ * \param a : Array to iterate.
+ * \param actFct : Pointer to a function called for each element of the array.
+ * \param infos : pointer broadcasted to actFct.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return nothing.
+ *
+ */
+void arrayParallelForEach(Array a, ElActFct actFct, Ptr infos, ThreadPool pool);
+
+/** \brief Returns a new array whose elements are computed in parallel from the elements of the array, in the same order. The mapping function must be thread-safe.
+ *
+ * \param a : Array to map.
+ * \param elemSize : the size in bytes of each element of the new array. You can use the EL_* constants for the basic types.
+ * \param mapFct : Pointer to a function initializing an element of the new array from the element of a at the same position.
+ * \param infos : pointer broadcasted to mapFct.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return a new array.
+ *
+ */
+Array arrayMap(const Array a, int elemSize, ElMapFct mapFct, Ptr infos, ThreadPool pool);
+
+/** \brief Accumulates all the elements of the array in parallel : each chunk is accumulated in its own copy of the initial value, then the partial results are combined in order. Both functions must be thread-safe.
+ *
+ * \param a : Array to reduce.
+ * \param acc : Pointer to the accumulator. It must hold a neutral initial value (like 0 for a sum) and receives the result.
+ * \param accSize : the size in bytes of the accumulator. You can use the EL_* constants for the basic types.
+ * \param reduceFct : Pointer to a function accumulating an element into an accumulator.
+ * \param combineFct : Pointer to a function merging an accumulator into another, it must be associative.
+ * \param infos : pointer broadcasted to reduceFct.
+ * \param pool : ThreadPool to use, NULL for the default pool.
+ * \return nothing.
+ *
+ */
+void arrayReduce(const Array a, Ptr acc, int accSize, ElReduceFct reduceFct, ElCombineFct combineFct, Ptr infos, ThreadPool pool);
+
 #endif
@@ -0,0 +1,320 @@
+/**
+ * \file Cache.h
+ * \brief Primitives functions for bounded caches
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A cache maps keys to values like a Hash, but holds at most a fixed number of entries : once full, every new key
+ * evicts an older one, chosen by the eviction policy of the cache. All entries are preallocated when the cache is
+ * created, and every operation is O(1).
+ * EL_CACHE_LRU evicts the least recently used entry, tracked by a list threaded through the entries.
+ * EL_CACHE_CLOCK approximates LRU with a reference bit per entry, so a hit writes a single byte.
+ * EL_CACHE_TINYLFU (W-TinyLFU) sends new keys to a small LRU window, and only lets them into the main area if they
+ * are used more often than the entry they would evict, as estimated by a count-min sketch. It resists scans.
+ * A ShardedCache splits a cache in independently locked shards, for threads sharing it.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_CACHE_H
+#define EXTLIB_CACHE_H
+
+#include "Common.h"
+
+/** Least recently used eviction. */
+#define EL_CACHE_LRU     0
+/** Second chance eviction with a clock hand. */
+#define EL_CACHE_CLOCK   1
+/** Window TinyLFU : LRU window, frequency-based admission to a segmented LRU. */
+#define EL_CACHE_TINYLFU 2
+
+/** Cache : type for a bounded cache. */
+typedef struct _Cache *Cache;
+
+/** ShardedCache : type for a bounded cache shared by threads. */
+typedef struct _ShardedCache *ShardedCache;
+
+/** CacheStats : counters of the accesses to a cache. */
+typedef struct {
+    long hits;      //!< Lookups which found their key.
+    long misses;    //!< Lookups which didn't find their key.
+    long evictions; //!< Entries removed to make room for others (W-TinyLFU counts the new keys it didn't admit).
+} CacheStats;
+
+
+
+/** \brief Creates a new cache.
+ *
+ * \param keySize : the size in bytes of each key of the cache. You can use the EL_* constants for the basic types, this will automatically link the comparison function too. Other keys are compared bit by bit, unless cacheComparable is called.
+ * \param elemSize : the size in bytes of each value of the cache. You can use the EL_* constants for the basic types.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant, the default hash function of that type is then used.
+ * \param capacity : maximum number of entries, at least 1.
+ * \param policy : eviction policy, EL_CACHE_LRU, EL_CACHE_CLOCK or EL_CACHE_TINYLFU.
+ * \return New empty cache.
+ *
+ */
+Cache cacheNew(int keySize, int elemSize, ElHashFct hashFct, int capacity, int policy);
+
+/** \brief Creates a new cache with strings as keys. The cache stores its own copies of the strings.
+ *
+ * \param elemSize : the size in bytes of each value of the cache. You can use the EL_* constants for the basic types.
+ * \param capacity : maximum number of entries, at least 1.
+ * \param policy : eviction policy, EL_CACHE_LRU, EL_CACHE_CLOCK or EL_CACHE_TINYLFU.
+ * \return New empty cache.
+ *
+ */
+Cache cacheNewStr(int elemSize, int capacity, int policy);
+
+/** \brief Destroys a cache and all its content.
+ *
+ * \param c : Cache to destroy.
+ * \return void
+ *
+ */
+void cacheDel(Cache c);
+
+
+
+/** \brief Sets the function to compare 2 keys of this cache, note that if you declared the cache key with EL_*, the comparison function of the specified type is automatically linked.
+ *
+ * \param c : Cache in which you set the fonction.
+ * \param fct : pointer to the function, the function must take 2 pointers to the keys and return an int which is =0 if the keys are equal.
+ * \return nothing.
+ *
+ */
+void cacheComparable(Cache c, ElCmpFct fct);
+
+/** \brief Sets the functions to copy a key and to delete a key of this cache. If not called, the keys will be copied bit by bit. /!\ Must be set before any Cache update
+ *
+ * \param c : Cache in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated key to initialize and the second is the source key and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the key to destroy. Note that this pointer will be automatically freed, so delFct must'nt do this.
+ * \return nothing.
+ *
+ */
+void cacheKeyInstanciable(Cache c, ElCopyFct copyFct, ElDelFct delFct);
+
+/** \brief Sets the functions to copy a value and to delete a value of this cache. If not called, the values will be copied bit by bit. Values are deleted when they are replaced, removed or evicted. /!\ Must be set before any Cache update
+ *
+ * \param c : Cache in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated value to initialize and the second is the source value and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the value to destroy. Note that this pointer will be automatically freed, so delFct must'nt do this.
+ * \return nothing.
+ *
+ */
+void cacheElementInstanciable(Cache c, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Removes the whole content of a cache. The counters are kept.
+ *
+ * \param c : Cache to clear.
+ * \return nothing.
+ *
+ */
+void cacheClear(Cache c);
+
+
+
+/** \brief Returns the number of entries of the cache.
+ *
+ * \param c : Cache to count entries.
+ * \return Number of entries.
+ *
+ */
+int cacheLength(const Cache c);
+
+/** \brief Returns the maximum number of entries of the cache.
+ *
+ * \param c : Cache to look in.
+ * \return Capacity of the cache.
+ *
+ */
+int cacheCapacity(const Cache c);
+
+
+
+/** \brief Looks for a key in the cache, and counts a hit or a miss. A hit makes the entry less likely to be evicted.
+ *
+ * \param c : Cache to look into.
+ * \param key : A key.
+ * \return A pointer to the value of the key, valid until the next update of the cache, or NULL if the key isn't cached.
+ *
+ */
+Ptr cacheGet_base(Cache c, const Ptr key);
+#define cacheGet(c, key) cacheGet_base(c, &(key))
+#define cacheGetPtr(c, key, type) ((type*)cacheGet_base(c, &(key)))
+
+/** \brief Tells whether the cache contains a key or not, without counting the access nor changing the eviction order.
+ *
+ * \param c : Cache to look into.
+ * \param key : A key.
+ * \return true if found, false otherwise.
+ *
+ */
+bool cacheContains_base(const Cache c, const Ptr key);
+#define cacheContains(c, key) cacheContains_base(c, &(key))
+
+/** \brief Sets the value of a key. If the key is new and the cache is full, an entry is evicted.
+ *
+ * \param c : Cache to modify.
+ * \param key : A key.
+ * \param data : The value.
+ * \return nothing.
+ *
+ */
+void cachePut_base(Cache c, const Ptr key, const Ptr data);
+#define cachePut(c, key, data) cachePut_base(c, &(key), &(data))
+#define cachePutI(c, key, data, type) {type tmp = (data); cachePut_base(c, &(key), &(tmp));}
+
+/** \brief Removes a key from a cache.
+ *
+ * \param c : Cache to remove in.
+ * \param key : A key.
+ * \return true if the key was removed, false if it wasn't cached.
+ *
+ */
+bool cacheRemove_base(Cache c, const Ptr key);
+#define cacheRemove(c, key) cacheRemove_base(c, &(key))
+
+
+
+/** \brief Returns the counters of the accesses to a cache.
+ *
+ * \param c : Cache to look in.
+ * \return Hits, misses and evictions since the creation of the cache or the last cacheResetStats.
+ *
+ */
+CacheStats cacheGetStats(const Cache c);
+
+/** \brief Resets the counters of a cache.
+ *
+ * \param c : Cache to modify.
+ * \return nothing.
+ *
+ */
+void cacheResetStats(Cache c);
+
+
+
+/** \brief Prints informations about the memory usage of a cache.
+ *
+ * \param c : Cache to dump.
+ * \return nothing.
+ *
+ */
+void cacheDump(const Cache c);
+
+
+
+// Sharded cache
+
+/** \brief Creates a new cache shared by threads. Keys are spread on shards by their hash, and each shard is a Cache with its own lock, so threads using different shards don't wait for each other.
+ *
+ * \param keySize : the size in bytes of each key of the cache. You can use the EL_* constants for the basic types.
+ * \param elemSize : the size in bytes of each value of the cache. You can use the EL_* constants for the basic types.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant, the default hash function of that type is then used.
+ * \param capacity : maximum number of entries, split evenly between the shards.
+ * \param policy : eviction policy of each shard, EL_CACHE_LRU, EL_CACHE_CLOCK or EL_CACHE_TINYLFU.
+ * \param nbShards : number of shards, rounded up to a power of 2. A few times the number of threads is a good choice.
+ * \return New empty cache.
+ *
+ */
+ShardedCache shardedCacheNew(int keySize, int elemSize, ElHashFct hashFct, int capacity, int policy, int nbShards);
+
+/** \brief Destroys a sharded cache and all its content. No thread may use it anymore.
+ *
+ * \param c : ShardedCache to destroy.
+ * \return void
+ *
+ */
+void shardedCacheDel(ShardedCache c);
+
+/** \brief Sets the function to compare 2 keys in every shard, see cacheComparable. /!\ Must be set before the cache is shared.
+ *
+ * \param c : ShardedCache in which you set the fonction.
+ * \param fct : pointer to the comparison function.
+ * \return nothing.
+ *
+ */
+void shardedCacheComparable(ShardedCache c, ElCmpFct fct);
+
+/** \brief Sets the functions to copy and delete keys in every shard, see cacheKeyInstanciable. /!\ Must be set before the cache is shared.
+ *
+ * \param c : ShardedCache in which you set the fonctions.
+ * \param copyFct : pointer to the copy function.
+ * \param delFct : pointer to the deletion function.
+ * \return nothing.
+ *
+ */
+void shardedCacheKeyInstanciable(ShardedCache c, ElCopyFct copyFct, ElDelFct delFct);
+
+/** \brief Sets the functions to copy and delete values in every shard, see cacheElementInstanciable. The copy function is also used by shardedCacheGet. /!\ Must be set before the cache is shared.
+ *
+ * \param c : ShardedCache in which you set the fonctions.
+ * \param copyFct : pointer to the copy function.
+ * \param delFct : pointer to the deletion function.
+ * \return nothing.
+ *
+ */
+void shardedCacheElementInstanciable(ShardedCache c, ElCopyFct copyFct, ElDelFct delFct);
+
+/** \brief Removes the whole content of a sharded cache.
+ *
+ * \param c : ShardedCache to clear.
+ * \return nothing.
+ *
+ */
+void shardedCacheClear(ShardedCache c);
+
+/** \brief Returns the number of entries of a sharded cache. Other threads may change it at any time.
+ *
+ * \param c : ShardedCache to count entries.
+ * \return Number of entries.
+ *
+ */
+int shardedCacheLength(ShardedCache c);
+
+/** \brief Looks for a key in a sharded cache, and copies its value. The value must be copied, as another thread may evict the entry as soon as the shard is unlocked.
+ *
+ * \param c : ShardedCache to look into.
+ * \param key : A key.
+ * \param dest : where to copy the value, if found.
+ * \return true if the key was found, false otherwise.
+ *
+ */
+bool shardedCacheGet_base(ShardedCache c, const Ptr key, Ptr dest);
+#define shardedCacheGet(c, key, dest) shardedCacheGet_base(c, &(key), &(dest))
+
+/** \brief Sets the value of a key in a sharded cache. If the key is new and its shard is full, an entry of that shard is evicted.
+ *
+ * \param c : ShardedCache to modify.
+ * \param key : A key.
+ * \param data : The value.
+ * \return nothing.
+ *
+ */
+void shardedCachePut_base(ShardedCache c, const Ptr key, const Ptr data);
+#define shardedCachePut(c, key, data) shardedCachePut_base(c, &(key), &(data))
+#define shardedCachePutI(c, key, data, type) {type tmp = (data); shardedCachePut_base(c, &(key), &(tmp));}
+
+/** \brief Removes a key from a sharded cache.
+ *
+ * \param c : ShardedCache to remove in.
+ * \param key : A key.
+ * \return true if the key was removed, false if it wasn't cached.
+ *
+ */
+bool shardedCacheRemove_base(ShardedCache c, const Ptr key);
+#define shardedCacheRemove(c, key) shardedCacheRemove_base(c, &(key))
+
+/** \brief Returns the counters of the accesses to a sharded cache, summed over its shards.
+ *
+ * \param c : ShardedCache to look in.
+ * \return Hits, misses and evictions.
+ *
+ */
+CacheStats shardedCacheGetStats(ShardedCache c);
+
+#endif
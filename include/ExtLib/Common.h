@@ -19,7 +19,9 @@ typedef enum {
     LIST,
     STRING,
     HEAP,
-    HASH
+    HASH,
+    DEQUE,
+    HASHSET
 } RealType;
 
 /** Ascendant sorting */
@@ -27,6 +29,13 @@ typedef enum {
 /** Descendant sorting */
 #define EL_DESC       -1
 
+/** Default growth factor of the capacity of arrays and heaps */
+#define EL_DEFGROWTH       2.0f
+/** Default shrink divisor : the capacity shrinks when the length drops to a quarter of it */
+#define EL_DEFSHRINK       4
+/** Shrink divisor keeping the capacity, even when cleared */
+#define EL_NEVER_SHRINK    0
+
 /** Pointer type representation */
 #define EL_POINTER    0
 /** char type representation */
@@ -73,6 +82,18 @@ typedef void(*ElDelFct)(Ptr obj);
 /** ElActFct : An action function. must take 2 generic pointers (Ptr) 1st to an object, 2nd to additional informations sent by the caller and return nothing */
 typedef void(*ElActFct)(Ptr obj, Ptr infos);
 
+/** ElPredFct : A predicate function. must take 2 generic pointers (Ptr) 1st to an object, 2nd to additional informations sent by the caller and return a bool */
+typedef bool(*ElPredFct)(Ptr obj, Ptr infos);
+
+/** ElMapFct : A mapping function. must take 3 generic pointers (Ptr) 1st to the destination object to initialize, 2nd to the source object, 3rd to additional informations sent by the caller and return nothing */
+typedef void(*ElMapFct)(Ptr dest, Ptr src, Ptr infos);
+
+/** ElReduceFct : An accumulation function. must take 3 generic pointers (Ptr) 1st to the accumulator to update, 2nd to an object, 3rd to additional informations sent by the caller and return nothing */
+typedef void(*ElReduceFct)(Ptr acc, Ptr obj, Ptr infos);
+
+/** ElCombineFct : A combination function. must take 2 generic pointers (Ptr) 1st to the accumulator to update, 2nd to the accumulator to merge into the 1st and return nothing */
+typedef void(*ElCombineFct)(Ptr acc, Ptr other);
+
 /** ElHashFct : A hash function. must take a generic pointer (Ptr) to a key object and return an int */
 typedef unsigned long(*ElHashFct)(Ptr key);
 
@@ -86,6 +107,15 @@ typedef unsigned long(*ElHashFct)(Ptr key);
  */
 //void throwExc(char *module, char *msg);
 
+/** \brief Hashes a buffer of bytes with a fast, well-mixed function (8 bytes per step).
+ *
+ * \param data : the buffer to hash.
+ * \param length : number of bytes to hash.
+ * \return the hash of the buffer.
+ *
+ */
+unsigned long hashBytes(const void *data, int length);
+
 /** \brief Returns the comparison function from a type
  *
  * \param type : A predefined type (EL_*).
@@ -94,8 +124,25 @@ typedef unsigned long(*ElHashFct)(Ptr key);
  */
 ElCmpFct _elCompareFct(int type);
 
+/** \brief Returns the hash function from a type
+ *
+ * \param type : A predefined type (EL_*).
+ * \return ElHashFct : the hash function associated to type
+ *
+ */
+ElHashFct _elHashFct(int type);
+
 //! \{
 int _elSizeFct(int type);
+unsigned long _elHashMix(unsigned long long x);
+unsigned long long _elHashMix64(unsigned long long x);
+unsigned long long _elHashBytes64(const void *data, int length);
+int _elGrowSize(int size, int minSize, float growth);
+int _elShrinkSize(int size, int length, int minSize, float growth, int shrinkDivisor);
+unsigned long _elHashString(Ptr key);
+int _elCompareString(Ptr key1, Ptr key2);
+void _elCopyString(Ptr dest, Ptr src);
+void _elDelString(Ptr key);
 //! \}
 
 #endif
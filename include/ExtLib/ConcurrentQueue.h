@@ -0,0 +1,235 @@
+/**
+ * \file ConcurrentQueue.h
+ * \brief Primitives functions for bounded lock-free queues
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Bounded queues to pass elements between threads without locks.
+ * SpscQueue may be used by one producer thread and one consumer thread only.
+ * MpmcQueue may be used by any number of producer and consumer threads.
+ * Elements are stored inline, the capacity is rounded up to a power of 2.
+ * Popping an element moves it bit by bit to the caller, who becomes responsible for it : the deletion function is only called on the elements left in the queue when it is destroyed.
+ * These queues are not Collections.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_CONCURRENTQUEUE_H
+#define EXTLIB_CONCURRENTQUEUE_H
+
+#include "Common.h"
+
+/** SpscQueue : type for a single-producer single-consumer queue. */
+typedef struct _SpscQueue *SpscQueue;
+
+/** MpmcQueue : type for a multi-producer multi-consumer queue. */
+typedef struct _MpmcQueue *MpmcQueue;
+
+
+
+/** \brief Creates a new single-producer single-consumer queue.
+ *
+ * \param elemSize : the size in bytes of each element of the queue. You can use the EL_* constants for the basic types.
+ * \param capacity : the maximal number of elements in the queue, rounded up to a power of 2.
+ * \return New empty queue.
+ *
+ */
+SpscQueue spscQueueNew(int elemSize, int capacity);
+
+/** \brief Destroys a queue and all its content. No thread may use the queue anymore.
+ *
+ * \param q : SpscQueue to destroy.
+ * \return void
+ *
+ */
+void spscQueueDel(SpscQueue q);
+
+/** \brief Sets the functions to copy an element and to delete an element of this queue. If not called, the elements will be copied bit by bit. /!\ Must be set before any SpscQueue update
+ *
+ * \param q : SpscQueue in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated element to initialize and the second is the source element and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the element to destroy.
+ * \return nothing.
+ *
+ */
+void spscQueueElementInstanciable(SpscQueue q, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Returns the capacity of the queue.
+ *
+ * \param q : SpscQueue.
+ * \return Maximal number of elements.
+ *
+ */
+int spscQueueCapacity(const SpscQueue q);
+
+/** \brief Returns the number of elements in the queue. The result is only a snapshot if other threads use the queue.
+ *
+ * \param q : SpscQueue.
+ * \return Number of elements.
+ *
+ */
+int spscQueueLength(const SpscQueue q);
+
+
+
+/** \brief Adds an element at the end of the queue. Must only be called by the producer thread.
+ *
+ * \param q : SpscQueue to add in.
+ * \param data : Pointer to the data to add.
+ * \return true if added, false if the queue is full.
+ *
+ */
+bool spscQueuePush_base(SpscQueue q, const Ptr data);
+/** Automatic macro to send the address of data to spscQueuePush_base */
+#define spscQueuePush(q, data) spscQueuePush_base(q, &(data))
+
+/** \brief Adds up to nb consecutive elements at the end of the queue. Must only be called by the producer thread.
+ *
+ * \param q : SpscQueue to add in.
+ * \param data : Pointer to the first element to add.
+ * \param nb : Number of elements to add.
+ * \return Number of elements added, less than nb if the queue is full.
+ *
+ */
+int spscQueuePushMany(SpscQueue q, const Ptr data, int nb);
+
+
+
+/** \brief Removes the first element of the queue and moves it to dest. Must only be called by the consumer thread.
+ *
+ * \param q : SpscQueue to remove in.
+ * \param dest : Pointer to the memory receiving the element.
+ * \return true if an element was removed, false if the queue is empty.
+ *
+ */
+bool spscQueuePop_base(SpscQueue q, Ptr dest);
+/** Automatic macro to send the address of dest to spscQueuePop_base */
+#define spscQueuePop(q, dest) spscQueuePop_base(q, &(dest))
+
+/** \brief Removes up to nb elements from the beginning of the queue and moves them to dest. Must only be called by the consumer thread.
+ *
+ * \param q : SpscQueue to remove in.
+ * \param dest : Pointer to the memory receiving the elements, room for nb elements is needed.
+ * \param nb : Maximal number of elements to remove.
+ * \return Number of elements removed.
+ *
+ */
+int spscQueuePopMany(SpscQueue q, Ptr dest, int nb);
+
+
+
+/** \brief Details the heap usage of a given queue
+ *
+ * \param q : SpscQueue to dump
+ * \return void
+ *
+ */
+void spscQueueDump(const SpscQueue q);
+
+
+
+/** \brief Creates a new multi-producer multi-consumer queue.
+ *
+ * \param elemSize : the size in bytes of each element of the queue. You can use the EL_* constants for the basic types.
+ * \param capacity : the maximal number of elements in the queue, rounded up to a power of 2 (at least 2).
+ * \return New empty queue.
+ *
+ */
+MpmcQueue mpmcQueueNew(int elemSize, int capacity);
+
+/** \brief Destroys a queue and all its content. No thread may use the queue anymore.
+ *
+ * \param q : MpmcQueue to destroy.
+ * \return void
+ *
+ */
+void mpmcQueueDel(MpmcQueue q);
+
+/** \brief Sets the functions to copy an element and to delete an element of this queue. If not called, the elements will be copied bit by bit. /!\ Must be set before any MpmcQueue update
+ *
+ * \param q : MpmcQueue in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated element to initialize and the second is the source element and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the element to destroy.
+ * \return nothing.
+ *
+ */
+void mpmcQueueElementInstanciable(MpmcQueue q, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Returns the capacity of the queue.
+ *
+ * \param q : MpmcQueue.
+ * \return Maximal number of elements.
+ *
+ */
+int mpmcQueueCapacity(const MpmcQueue q);
+
+/** \brief Returns the number of elements in the queue. The result is only a snapshot if other threads use the queue.
+ *
+ * \param q : MpmcQueue.
+ * \return Number of elements.
+ *
+ */
+int mpmcQueueLength(const MpmcQueue q);
+
+
+
+/** \brief Adds an element at the end of the queue.
+ *
+ * \param q : MpmcQueue to add in.
+ * \param data : Pointer to the data to add.
+ * \return true if added, false if the queue is full.
+ *
+ */
+bool mpmcQueuePush_base(MpmcQueue q, const Ptr data);
+/** Automatic macro to send the address of data to mpmcQueuePush_base */
+#define mpmcQueuePush(q, data) mpmcQueuePush_base(q, &(data))
+
+/** \brief Adds up to nb consecutive elements at the end of the queue, the added elements are contiguous in the queue.
+ *
+ * \param q : MpmcQueue to add in.
+ * \param data : Pointer to the first element to add.
+ * \param nb : Number of elements to add.
+ * \return Number of elements added, less than nb if the queue is full.
+ *
+ */
+int mpmcQueuePushMany(MpmcQueue q, const Ptr data, int nb);
+
+
+
+/** \brief Removes the first element of the queue and moves it to dest.
+ *
+ * \param q : MpmcQueue to remove in.
+ * \param dest : Pointer to the memory receiving the element.
+ * \return true if an element was removed, false if the queue is empty.
+ *
+ */
+bool mpmcQueuePop_base(MpmcQueue q, Ptr dest);
+/** Automatic macro to send the address of dest to mpmcQueuePop_base */
+#define mpmcQueuePop(q, dest) mpmcQueuePop_base(q, &(dest))
+
+/** \brief Removes up to nb consecutive elements from the beginning of the queue and moves them to dest.
+ *
+ * \param q : MpmcQueue to remove in.
+ * \param dest : Pointer to the memory receiving the elements, room for nb elements is needed.
+ * \param nb : Maximal number of elements to remove.
+ * \return Number of elements removed.
+ *
+ */
+int mpmcQueuePopMany(MpmcQueue q, Ptr dest, int nb);
+
+
+
+/** \brief Details the heap usage of a given queue
+ *
+ * \param q : MpmcQueue to dump
+ * \return void
+ *
+ */
+void mpmcQueueDump(const MpmcQueue q);
+
+#endif
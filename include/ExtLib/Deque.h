@@ -0,0 +1,251 @@
+/**
+ * \file Deque.h
+ * \brief Primitives functions for double-ended queues
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * All the basic functions to manage double-ended queues.
+ * Elements are stored inline in a growable circular buffer : adding or removing at both ends and random access are O(1) and never allocate once the capacity is reached.
+ * Deque is an Iterable Collection.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_DEQUE_H
+#define EXTLIB_DEQUE_H
+
+#include "Common.h"
+
+/** Deque : type for a double-ended queue. */
+typedef struct _Deque *Deque;
+
+
+
+/** \brief Creates a new double-ended queue.
+ *
+ * \param elemSize : the size in bytes of each element of the deque. You can use the EL_* constants for the basic types, this will automatically link the comparison function too.
+ * \return New empty deque.
+ *
+ */
+Deque dequeNew(int elemSize);
+
+/** \brief Destroys a deque and all its content.
+ *
+ * \param d : Deque to destroy.
+ * \return void
+ *
+ */
+void dequeDel(Deque d);
+
+
+
+/** \brief Sets the function to compare 2 elements of this deque, note that if you declared the deque with EL_*, the comparison function of the specified type is automatically linked.
+ *
+ * \param d : Deque in which you set the fonction.
+ * \param fct : pointer to the function, the function must take 2 pointers to the data and return an int which is <0 if 1st value is lower tha 2nd, >0 for the opposite and =0 if 1st value equals 2nd value.
+ * \return nothing.
+ *
+ */
+void dequeComparable(Deque d, ElCmpFct fct);
+
+/** \brief Sets the functions to copy an element and to delete an element of this collection. If not called, the elements will be copied bit by bit. /!\ Must be set before any Deque update
+ *
+ * \param d : Deque in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated element to initialize and the second is the source element and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the element to destroy. Note that this pointer will be automatically freed, so delFct must'nt do this.
+ * \return nothing.
+ *
+ */
+void dequeElementInstanciable(Deque d, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Copies a deque and all its content.
+ *
+ * \param d : Deque to copy.
+ * \return Copy of the deque
+ *
+ */
+Deque dequeClone(const Deque d);
+
+
+
+/** \brief Removes the whole content of a deque.
+ *
+ * \param d : Deque to clear.
+ * \return nothing.
+ *
+ */
+void dequeClear(Deque d);
+
+
+
+/** \brief Tells whether a deque is empty or not
+ *
+ * \param d : Deque to look in.
+ * \return true if empty, false if not.
+ *
+ */
+bool dequeIsEmpty(const Deque d);
+
+/** \brief Returns the length of the deque.
+ *
+ * \param d : Deque to count elements.
+ * \return Number of elements.
+ *
+ */
+int dequeLength(const Deque d);
+
+
+
+/** \brief Grows the capacity of a deque so that it can hold at least capacity elements without reallocating.
+ *
+ * \param d : Deque to grow.
+ * \param capacity : minimal number of elements.
+ * \return nothing.
+ *
+ */
+void dequeReserve(Deque d, int capacity);
+
+
+
+/** \brief Tells whether the deque contains an element or not, dequeComparable must have been called or the deque must have been created with a EL_* constant.
+ *
+ * \param d : Deque to look into.
+ * \param data : Element to seek.
+ * \return true if found, false otherwise.
+ *
+ */
+bool dequeContains(const Deque d, const Ptr data);
+
+/** \brief Returns the position of the first occurence of an element in the deque, dequeComparable must have been called or the deque must have been created with a EL_* constant.
+ *
+ * \param d : Deque to look into.
+ * \param data : Element to seek.
+ * \return position of the element if found, -1 otherwise.
+ *
+ */
+int dequeIndexOf(const Deque d, const Ptr data);
+
+
+
+/** \brief Returns the element at a given position in a deque, 0 being the first element.
+ *
+ * \param d : Deque to seek in.
+ * \param pos : Position of the element.
+ * \return Pointer to data.
+ *
+ */
+const Ptr dequeGet_base(const Deque d, int pos);
+#define dequeGet(d, pos, type) (*(type*)dequeGet_base(d, pos))
+
+/** \brief Returns the first element of a deque.
+ *
+ * \param d : Deque to seek in.
+ * \return Pointer to data.
+ *
+ */
+const Ptr dequeGetFirst_base(const Deque d);
+#define dequeGetFirst(d, type) (*(type*)dequeGetFirst_base(d))
+
+/** \brief Returns the last element of a deque.
+ *
+ * \param d : Deque to seek in.
+ * \return Pointer to data.
+ *
+ */
+const Ptr dequeGetLast_base(const Deque d);
+#define dequeGetLast(d, type) (*(type*)dequeGetLast_base(d))
+
+
+
+/** \brief Updates the element at a given position in a deque.
+ *
+ * \param d : Deque to update.
+ * \param pos : Position of the element.
+ * \param data : Pointer to the new data.
+ * \return nothing.
+ *
+ */
+void dequeSet_base(Deque d, int pos, const Ptr data);
+/** Automatic macro to send the address of data to dequeSet_base */
+#define dequeSet(d, pos, data) dequeSet_base(d, pos, &(data))
+#define dequeSetI(d, pos, data, type) {type tmp = (data); dequeSet_base(d, pos, &(tmp));}
+
+
+
+/** \brief Adds a new element at the beginning of the deque.
+ *
+ * \param d : Deque to add in.
+ * \param data : Pointer to the data to add.
+ * \return nothing.
+ *
+ */
+void dequeAddFirst_base(Deque d, const Ptr data);
+/** Automatic macro to send the address of data to dequeAddFirst_base */
+#define dequeAddFirst(d, data) dequeAddFirst_base(d, &(data))
+#define dequeAddFirstI(d, data, type) {type tmp = (data); dequeAddFirst_base(d, &(tmp));}
+
+/** \brief Adds a new element at the end of the deque.
+ *
+ * \param d : Deque to add in.
+ * \param data : Pointer to the data to add.
+ * \return nothing.
+ *
+ */
+void dequeAddLast_base(Deque d, const Ptr data);
+/** Automatic macro to send the address of data to dequeAddLast_base */
+#define dequeAddLast(d, data) dequeAddLast_base(d, &(data))
+#define dequeAddLastI(d, data, type) {type tmp = (data); dequeAddLast_base(d, &(tmp));}
+
+
+
+/** \brief Removes the first element of a deque.
+ *
+ * \param d : Deque to remove in.
+ * \return nothing.
+ *
+ */
+void dequeRemoveFirst(Deque d);
+
+/** \brief Removes the last element of a deque.
+ *
+ * \param d : Deque to remove in.
+ * \return nothing.
+ *
+ */
+void dequeRemoveLast(Deque d);
+
+
+
+/** \brief Details the heap usage of a given deque
+ *
+ * \param d : Deque to dump
+ * \return void
+ *
+ */
+void dequeDump(const Deque d);
+
+
+
+/** \brief makes an action for every element of the deque, from the first to the last
+ *
+ * \param d : Deque to iterate.
+ * \param actFct : Pointer to a function called for each element of the deque.
+ * \param infos : pointer broadcasted to actFct. Useful to share additional informations to the function.
+ * \return nothing.
+ *
+ */
+void dequeForEach(Deque d, ElActFct actFct, Ptr infos);
+
+/** \brief Copies all the elements of the deque bit by bit to a contiguous buffer, from the first to the last, with at most 2 memcpy.
+ *
+ * \param d : Deque to copy.
+ * \param dest : buffer of at least dequeLength(d) elements.
+ * \return nothing.
+ *
+ */
+void dequeCopyToRaw(const Deque d, Ptr dest);
+
+#endif
@@ -0,0 +1,344 @@
+/**
+ * \file Filter.h
+ * \brief Approximate membership filters
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A filter tells whether a key may be in a set, in a few bits per key : it never misses a key that was added, but may
+ * answer yes for a key that wasn't, with a configurable false positive rate. Put in front of a Hash, it skips most of the
+ * lookups of missing keys.
+ * BloomFilter is a split block Bloom filter : each key sets 8 bits in one block of 32 bytes, tested at once with SIMD
+ * instructions when the compiler targets them. Keys can't be removed.
+ * CuckooFilter stores fingerprints of 8 or 16 bits in buckets of 4, and supports the removal of keys that were added.
+ * XorFilter is static : it is built once from a set of keys, and uses about 1.23 fingerprints per key.
+ * Keys are only read by the hash function of the filter. Filters are saved with their table, and the same hash function
+ * must be given back when they are loaded, unless they were created with an EL_* constant.
+ * These filters are not Collections.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_FILTER_H
+#define EXTLIB_FILTER_H
+
+#include "Common.h"
+#include "Array.h"
+#include "Hash.h"
+
+/** BloomFilter : type for a blocked Bloom filter. */
+typedef struct _BloomFilter *BloomFilter;
+
+/** CuckooFilter : type for a cuckoo filter. */
+typedef struct _CuckooFilter *CuckooFilter;
+
+/** XorFilter : type for a static xor filter. */
+typedef struct _XorFilter *XorFilter;
+
+
+
+/** \brief Creates a new Bloom filter.
+ *
+ * \param keySize : the size in bytes of each key. You can use the EL_* constants for the basic types, this will automatically link the hash function too.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant.
+ * \param capacity : number of keys the filter is sized for.
+ * \param fpRate : false positive rate once capacity keys are added, between 0 and 1.
+ * \return New empty filter.
+ *
+ */
+BloomFilter bloomFilterNew(int keySize, ElHashFct hashFct, int capacity, double fpRate);
+
+/** \brief Destroys a Bloom filter.
+ *
+ * \param f : BloomFilter to destroy.
+ * \return void
+ *
+ */
+void bloomFilterDel(BloomFilter f);
+
+/** \brief Removes all the keys of a Bloom filter.
+ *
+ * \param f : BloomFilter to clear.
+ * \return nothing.
+ *
+ */
+void bloomFilterClear(BloomFilter f);
+
+/** \brief Returns the number of keys added to a Bloom filter, counting a key added twice twice.
+ *
+ * \param f : BloomFilter.
+ * \return Number of additions.
+ *
+ */
+long bloomFilterLength(const BloomFilter f);
+
+/** \brief Adds a key to a Bloom filter.
+ *
+ * \param f : BloomFilter to modify.
+ * \param key : A key.
+ * \return nothing.
+ *
+ */
+void bloomFilterAdd_base(BloomFilter f, const Ptr key);
+#define bloomFilterAdd(f, key) bloomFilterAdd_base(f, &(key))
+#define bloomFilterAddI(f, key, type) {type tmp = (key); bloomFilterAdd_base(f, &(tmp));}
+
+/** \brief Adds the keys of a contiguous buffer to a Bloom filter.
+ *
+ * \param f : BloomFilter to modify.
+ * \param keys : buffer of keys, packed.
+ * \param nbKeys : number of keys in the buffer.
+ * \return nothing.
+ *
+ */
+void bloomFilterAddMany(BloomFilter f, const Ptr keys, int nbKeys);
+
+/** \brief Tells whether a key may be in a Bloom filter.
+ *
+ * \param f : BloomFilter to look into.
+ * \param key : A key.
+ * \return true if the key may have been added, false if it surely wasn't.
+ *
+ */
+bool bloomFilterContains_base(const BloomFilter f, const Ptr key);
+#define bloomFilterContains(f, key) bloomFilterContains_base(f, &(key))
+
+/** \brief Looks up the keys of a contiguous buffer in a Bloom filter. The blocks of a batch of keys are prefetched before being tested.
+ *
+ * \param f : BloomFilter to look into.
+ * \param keys : buffer of keys, packed.
+ * \param nbKeys : number of keys in the buffer.
+ * \param results : array of nbKeys booleans, set like bloomFilterContains. May be NULL.
+ * \return Number of keys which may be in the filter.
+ *
+ */
+int bloomFilterContainsMany(const BloomFilter f, const Ptr keys, int nbKeys, bool *results);
+
+/** \brief Saves a Bloom filter to a binary file.
+ *
+ * \param f : BloomFilter to save.
+ * \param path : path of the file to write.
+ * \return true on success, false otherwise.
+ *
+ */
+bool bloomFilterSave(const BloomFilter f, const char *path);
+
+/** \brief Loads a Bloom filter saved by bloomFilterSave.
+ *
+ * \param path : path of the file.
+ * \param hashFct : the hash function the filter was created with. May be NULL if it was created with an EL_* constant.
+ * \return New filter, or NULL if the file can't be read, isn't a valid Bloom filter file, or no hash function is known.
+ *
+ */
+BloomFilter bloomFilterLoad(const char *path, ElHashFct hashFct);
+
+/** \brief Prints informations about the memory usage of a Bloom filter.
+ *
+ * \param f : BloomFilter to dump.
+ * \return nothing.
+ *
+ */
+void bloomFilterDump(const BloomFilter f);
+
+
+
+/** \brief Creates a new cuckoo filter.
+ *
+ * \param keySize : the size in bytes of each key. You can use the EL_* constants for the basic types, this will automatically link the hash function too.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant.
+ * \param capacity : number of keys the filter must hold.
+ * \param fpRate : maximal false positive rate, between 0 and 1. Fingerprints have 8 bits above 3%, 16 bits below.
+ * \return New empty filter.
+ *
+ */
+CuckooFilter cuckooFilterNew(int keySize, ElHashFct hashFct, int capacity, double fpRate);
+
+/** \brief Destroys a cuckoo filter.
+ *
+ * \param f : CuckooFilter to destroy.
+ * \return void
+ *
+ */
+void cuckooFilterDel(CuckooFilter f);
+
+/** \brief Removes all the keys of a cuckoo filter.
+ *
+ * \param f : CuckooFilter to clear.
+ * \return nothing.
+ *
+ */
+void cuckooFilterClear(CuckooFilter f);
+
+/** \brief Returns the number of keys in a cuckoo filter.
+ *
+ * \param f : CuckooFilter.
+ * \return Number of keys.
+ *
+ */
+long cuckooFilterLength(const CuckooFilter f);
+
+/** \brief Adds a key to a cuckoo filter. A key added twice must be removed twice.
+ *
+ * \param f : CuckooFilter to modify.
+ * \param key : A key.
+ * \return true if the key was added, false if the filter is full.
+ *
+ */
+bool cuckooFilterAdd_base(CuckooFilter f, const Ptr key);
+#define cuckooFilterAdd(f, key) cuckooFilterAdd_base(f, &(key))
+
+/** \brief Removes a key from a cuckoo filter. Only keys that were added may be removed.
+ *
+ * \param f : CuckooFilter to modify.
+ * \param key : A key.
+ * \return true if the key was found and removed, false otherwise.
+ *
+ */
+bool cuckooFilterRemove_base(CuckooFilter f, const Ptr key);
+#define cuckooFilterRemove(f, key) cuckooFilterRemove_base(f, &(key))
+
+/** \brief Tells whether a key may be in a cuckoo filter.
+ *
+ * \param f : CuckooFilter to look into.
+ * \param key : A key.
+ * \return true if the key may be in the filter, false if it surely isn't.
+ *
+ */
+bool cuckooFilterContains_base(const CuckooFilter f, const Ptr key);
+#define cuckooFilterContains(f, key) cuckooFilterContains_base(f, &(key))
+
+/** \brief Looks up the keys of a contiguous buffer in a cuckoo filter. The buckets of a batch of keys are prefetched before being tested.
+ *
+ * \param f : CuckooFilter to look into.
+ * \param keys : buffer of keys, packed.
+ * \param nbKeys : number of keys in the buffer.
+ * \param results : array of nbKeys booleans, set like cuckooFilterContains. May be NULL.
+ * \return Number of keys which may be in the filter.
+ *
+ */
+int cuckooFilterContainsMany(const CuckooFilter f, const Ptr keys, int nbKeys, bool *results);
+
+/** \brief Saves a cuckoo filter to a binary file.
+ *
+ * \param f : CuckooFilter to save.
+ * \param path : path of the file to write.
+ * \return true on success, false otherwise.
+ *
+ */
+bool cuckooFilterSave(const CuckooFilter f, const char *path);
+
+/** \brief Loads a cuckoo filter saved by cuckooFilterSave.
+ *
+ * \param path : path of the file.
+ * \param hashFct : the hash function the filter was created with. May be NULL if it was created with an EL_* constant.
+ * \return New filter, or NULL if the file can't be read, isn't a valid cuckoo filter file, or no hash function is known.
+ *
+ */
+CuckooFilter cuckooFilterLoad(const char *path, ElHashFct hashFct);
+
+/** \brief Prints informations about the memory usage of a cuckoo filter.
+ *
+ * \param f : CuckooFilter to dump.
+ * \return nothing.
+ *
+ */
+void cuckooFilterDump(const CuckooFilter f);
+
+
+
+/** \brief Creates a xor filter holding the keys of a contiguous buffer. Duplicate keys are allowed.
+ *
+ * \param keySize : the size in bytes of each key. You can use the EL_* constants for the basic types, this will automatically link the hash function too.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant.
+ * \param keys : buffer of keys, packed.
+ * \param nbKeys : number of keys in the buffer.
+ * \param fpRate : maximal false positive rate, between 0 and 1. Fingerprints have 8 bits above 1/256, 16 bits below.
+ * \return New filter, or NULL if it can't be built.
+ *
+ */
+XorFilter xorFilterNew(int keySize, ElHashFct hashFct, const Ptr keys, int nbKeys, double fpRate);
+
+/** \brief Creates a xor filter holding the elements of an array.
+ *
+ * \param a : Array of keys.
+ * \param keySize : the EL_* constant or the size in bytes of the elements of the array.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant.
+ * \param fpRate : maximal false positive rate, between 0 and 1.
+ * \return New filter, or NULL if it can't be built.
+ *
+ */
+XorFilter xorFilterNewFromArray(const Array a, int keySize, ElHashFct hashFct, double fpRate);
+
+/** \brief Creates a xor filter holding the keys of a hash table, hashed with its own hash function.
+ *
+ * \param h : Hash whose keys are read.
+ * \param fpRate : maximal false positive rate, between 0 and 1.
+ * \return New filter, or NULL if it can't be built.
+ *
+ */
+XorFilter xorFilterNewFromHash(const Hash h, double fpRate);
+
+/** \brief Destroys a xor filter.
+ *
+ * \param f : XorFilter to destroy.
+ * \return void
+ *
+ */
+void xorFilterDel(XorFilter f);
+
+/** \brief Returns the number of distinct keys of a xor filter.
+ *
+ * \param f : XorFilter.
+ * \return Number of keys.
+ *
+ */
+long xorFilterLength(const XorFilter f);
+
+/** \brief Tells whether a key may be in a xor filter.
+ *
+ * \param f : XorFilter to look into.
+ * \param key : A key.
+ * \return true if the key may be in the filter, false if it surely isn't.
+ *
+ */
+bool xorFilterContains_base(const XorFilter f, const Ptr key);
+#define xorFilterContains(f, key) xorFilterContains_base(f, &(key))
+
+/** \brief Looks up the keys of a contiguous buffer in a xor filter. The fingerprints of a batch of keys are prefetched before being read.
+ *
+ * \param f : XorFilter to look into.
+ * \param keys : buffer of keys, packed.
+ * \param nbKeys : number of keys in the buffer.
+ * \param results : array of nbKeys booleans, set like xorFilterContains. May be NULL.
+ * \return Number of keys which may be in the filter.
+ *
+ */
+int xorFilterContainsMany(const XorFilter f, const Ptr keys, int nbKeys, bool *results);
+
+/** \brief Saves a xor filter to a binary file.
+ *
+ * \param f : XorFilter to save.
+ * \param path : path of the file to write.
+ * \return true on success, false otherwise.
+ *
+ */
+bool xorFilterSave(const XorFilter f, const char *path);
+
+/** \brief Loads a xor filter saved by xorFilterSave.
+ *
+ * \param path : path of the file.
+ * \param hashFct : the hash function the filter was created with. May be NULL if it was created with an EL_* constant.
+ * \return New filter, or NULL if the file can't be read, isn't a valid xor filter file, or no hash function is known.
+ *
+ */
+XorFilter xorFilterLoad(const char *path, ElHashFct hashFct);
+
+/** \brief Prints informations about the memory usage of a xor filter.
+ *
+ * \param f : XorFilter to dump.
+ * \return nothing.
+ *
+ */
+void xorFilterDump(const XorFilter f);
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * \file FrozenHash.h
+ * \brief Immutable hash tables with a minimal perfect hash function
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A frozen hash table is built once from a Hash, then only read. Its keys are placed by a minimal perfect hash function
+ * (hash and displace, like CHD or PTHash) : n keys fill exactly n slots, and each key has its own slot, found with a
+ * single probe. Keys and values are stored inline in the slots, plus about 1 byte of hash function per key.
+ * The table has the layout of its file, so it can be saved and then mapped in memory by another process.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_FROZENHASH_H
+#define EXTLIB_FROZENHASH_H
+
+#include "Common.h"
+#include "Hash.h"
+
+/** FrozenHash : type for an immutable hash table. */
+typedef struct _FrozenHash *FrozenHash;
+
+
+
+/** \brief Creates a frozen hash table holding all the keys and values of a hash table, which is left unchanged.
+ * Keys and values are copied bit by bit : values mustn't have a copy function, keys neither unless they are strings (hashNewStr, hashNewInterned).
+ *
+ * \param h : Hash to freeze.
+ * \return New frozen hash table, or NULL if the keys or values can't be copied.
+ *
+ */
+FrozenHash hashFreeze(const Hash h);
+
+/** \brief Maps a file saved by frozenHashSave. The table reads the mapping in place.
+ *
+ * \param path : path of the file.
+ * \return New frozen hash table, or NULL if the file can't be mapped or isn't a valid frozen hash table file.
+ *
+ */
+FrozenHash frozenHashOpen(const char *path);
+
+/** \brief Destroys a frozen hash table, or unmaps its file.
+ *
+ * \param fh : FrozenHash to destroy.
+ * \return nothing.
+ *
+ */
+void frozenHashDel(FrozenHash fh);
+
+/** \brief Saves a frozen hash table to a binary file, for frozenHashOpen.
+ *
+ * \param fh : FrozenHash to save.
+ * \param path : path of the file to write.
+ * \return true on success, false otherwise.
+ *
+ */
+bool frozenHashSave(const FrozenHash fh, const char *path);
+
+
+
+/** \brief Returns the number of elements in a frozen hash table.
+ *
+ * \param fh : FrozenHash.
+ * \return Number of elements.
+ *
+ */
+int frozenHashLength(const FrozenHash fh);
+
+/** \brief Tells whether the keys of a frozen hash table are strings.
+ *
+ * \param fh : FrozenHash.
+ * \return true for string keys, false for keys compared bit by bit.
+ *
+ */
+bool frozenHashHasStringKeys(const FrozenHash fh);
+
+/** \brief Returns the value at a key in a frozen hash table. Keys are compared bit by bit.
+ *
+ * \param fh : FrozenHash whose keys aren't strings.
+ * \param key : pointer to the key.
+ * \return Pointer to the value, aligned on 8 bytes, or NULL if there is no such key.
+ *
+ */
+const Ptr frozenHashGet_base(const FrozenHash fh, const Ptr key);
+/** Automatic macro to send the address of key to frozenHashGet_base */
+#define frozenHashGet(fh, key) frozenHashGet_base(fh, &(key))
+
+/** \brief Returns the value at a string key in a frozen hash table.
+ *
+ * \param fh : FrozenHash whose keys are strings.
+ * \param key : the key.
+ * \return Pointer to the value, aligned on 8 bytes, or NULL if there is no such key.
+ *
+ */
+const Ptr frozenHashGetStr(const FrozenHash fh, const char *key);
+
+
+
+/** \brief Prints informations about the memory usage of a frozen hash table.
+ *
+ * \param fh : FrozenHash to dump.
+ * \return nothing.
+ *
+ */
+void frozenHashDump(const FrozenHash fh);
+
+#endif
@@ -5,6 +5,8 @@
  * \date 2016-12-04
  *
  * All the basic functions to manage dynamic hash tables.
+ * Entries are kept in insertion order in a contiguous array, so iterations, copies and saves scan the live entries
+ * only, whatever the size of the table. Updating the value of a key keeps its position.
  * Hash is an Iterable Collection.
  *
  * Copyright 2014-2016
@@ -19,8 +21,6 @@
 /** Hash : type for a hash table. */
 typedef struct _Hash *Hash;
 
-/** HashNode : type for a node in a hash table. */
-typedef struct _HashNode *HashNode;
 
 
 
@@ -28,7 +28,7 @@ typedef struct _HashNode *HashNode;
  *
  * \param keySize : the size in bytes of each key of the hash table. You can use the EL_* constants for the basic types, this will automatically link the comparison function too.
  * \param elemSize : the size in bytes of each element of the hash table.
- * \param hashFct : a hash function.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant, the default hash function of that type is then used.
  * \return New empty hash table.
  *
  */
@@ -42,6 +42,14 @@ Hash hashNew(int keySize, int elemSize, ElHashFct hashFct);
  */
 Hash hashNewStr(int elemSize);
 
+/** \brief Creates a new hash table whose keys are strings interned in a StringPool. Keys are neither copied nor read : they are hashed with their precomputed hash and compared by pointer.
+ *
+ * \param elemSize : the size in bytes of each element of the hash table.
+ * \return New empty hash table.
+ *
+ */
+Hash hashNewInterned(int elemSize);
+
 /** \brief Destroys a hash table and all its content.
  *
  * \param h : Hash to destroy.
@@ -71,9 +79,49 @@ void hashComparable(Hash h, ElCmpFct fct);
  */
 void hashElementInstanciable(Hash h, ElCopyFct copyFct, ElDelFct delFct);
 
+/** \brief Returns the size in bytes of each key of the hash table.
+ *
+ * \param h : Hash.
+ * \return Size of a key.
+ *
+ */
+int hashGetKeySize(const Hash h);
+
+/** \brief Returns the function to copy a key in the hash table (NULL if not defined).
+ *
+ * \param h : Hash.
+ * \return a copy function or NULL.
+ *
+ */
+ElCopyFct hashGetKeyCopyFunction(const Hash h);
+
+/** \brief Returns the function to delete a key in the hash table (NULL if not defined).
+ *
+ * \param h : Hash.
+ * \return a deletion function or NULL.
+ *
+ */
+ElDelFct hashGetKeyDelFunction(const Hash h);
+
+/** \brief Returns the function hashing the keys of the hash table.
+ *
+ * \param h : Hash.
+ * \return a hash function.
+ *
+ */
+ElHashFct hashGetHashFunction(const Hash h);
+
+/** \brief Tells whether the keys of the hash table are strings (created by hashNewStr or hashNewInterned).
+ *
+ * \param h : Hash.
+ * \return true for string keys, false otherwise.
+ *
+ */
+bool hashHasStringKeys(const Hash h);
+
 
 
-/** \brief Copies a hash table and all its content.
+/** \brief Copies a hash table and all its content. Without copy functions, the entries are copied in a single block.
  *
  * \param h : Hash to copy.
  * \return Copy of the hash table
@@ -128,7 +176,7 @@ bool hashContains_base(const Hash h, const Ptr key);
  *
  * \param h : Hash to seek in.
  * \param key : A key.
- * \return Pointer to data.
+ * \return Pointer to data, valid until the next hashSet or hashUnset : entries are stored in a single array, which they may move or reallocate.
  *
  */
 const Ptr hashGet_base(const Hash h, const Ptr key);
@@ -136,7 +184,7 @@ const Ptr hashGet_base(const Hash h, const Ptr key);
 
 
 
-/** \brief Sets the element at a given position in a hash table.
+/** \brief Sets the element at a given position in a hash table. Adding a key may grow or compact the entries, which invalidates the pointers returned by hashGet and the iterators.
  *
  * \param h : Hash to modify.
  * \param key : A key.
@@ -152,7 +200,7 @@ void hashSet_base(Hash h, const Ptr key, const Ptr data);
 
 
 
-/** \brief Removes the element for given key in the hash table.
+/** \brief Removes the element for given key in the hash table. Once most entries are removed, the remaining ones are compacted, which invalidates the pointers returned by hashGet and the iterators.
  *
  * \param h : Hash to remove in.
  * \param key : A key.
@@ -170,14 +218,12 @@ bool hashUnset_base(Hash h, const Ptr key);
 typedef struct {
     Hash hash;
     int index;
-    HashNode node;
-    HashNode lastNode;
     bool onNext;
 } HashIt;
 
 
 
-/** \brief Creates an iterator on the hash table (Starting with the first element).
+/** \brief Creates an iterator on the hash table (Starting with the first element inserted). The iterator is valid until the next hashSet or hashUnset, hashItRemove keeps it valid.
  *
  * \param h : Hash to iterate.
  * \return Iterator on this hash table.
@@ -247,4 +293,45 @@ void hashItSet_base(HashIt *it, const Ptr data);
  */
 void hashItRemove(HashIt *it);
 
+
+
+/** \brief makes an action for every element of the hash table, in insertion order
+ *
+ * \param h : Hash to iterate.
+ * \param actFct : Pointer to a function called for each element (not key) of the hash table.
+ * \param infos : pointer broadcasted to actFct. Useful to share additional informations to the function.
+ * \return nothing.
+ *
+ */
+void hashForEach(Hash h, ElActFct actFct, Ptr infos);
+
+/** \brief Returns the size in bytes of a key/value pair copied by hashCopyToRaw. The value of a pair starts at the key size rounded up to a multiple of 8 bytes, and pairs are aligned on 8 bytes.
+ *
+ * \param h : Hash.
+ * \return Size of a pair.
+ *
+ */
+int hashGetPairSize(const Hash h);
+
+/** \brief Copies all the keys and values of the hash table bit by bit to a contiguous buffer of pairs, in insertion order.
+ *
+ * \param h : Hash to copy.
+ * \param dest : buffer of at least hashLength(h)*hashGetPairSize(h) bytes.
+ * \return nothing.
+ *
+ */
+void hashCopyToRaw(const Hash h, Ptr dest);
+
+
+
+/** \brief Saves a hash table to a binary file, which can be mapped in memory by hashViewOpen for read-only lookups.
+ * Keys and values are written bit by bit : values mustn't have a copy function, keys neither unless they are strings (hashNewStr, hashNewInterned).
+ *
+ * \param h : Hash to save.
+ * \param path : path of the file to write.
+ * \return true on success, false if the file can't be written or the keys or values can't be saved.
+ *
+ */
+bool hashSave(const Hash h, const char *path);
+
 #endif
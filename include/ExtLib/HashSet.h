@@ -0,0 +1,283 @@
+/**
+ * \file HashSet.h
+ * \brief Primitives functions for hash sets
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A hash set only stores keys, in a flat open-addressing table : each slot holds a key inline, and a control byte
+ * tells whether it is empty, deleted, or full with 7 bits of the hash of its key. Lookups compare a whole group of
+ * 16 control bytes at once (with SSE2 when the compiler targets it), and only read the keys whose 7 bits match.
+ * An entry costs its key plus one control byte, with a load factor up to 7/8.
+ * HashSet is an Iterable Collection, whose elements are the keys.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_HASHSET_H
+#define EXTLIB_HASHSET_H
+
+#include "Common.h"
+
+/** HashSet : type for a hash set. */
+typedef struct _HashSet *HashSet;
+
+
+
+/** \brief Creates a new hash set.
+ *
+ * \param keySize : the size in bytes of each key of the hash set. You can use the EL_* constants for the basic types, this will automatically link the comparison function too. Other keys are compared bit by bit, unless hashSetComparable is called.
+ * \param hashFct : a hash function. May be NULL if keySize is an EL_* constant, the default hash function of that type is then used.
+ * \return New empty hash set.
+ *
+ */
+HashSet hashSetNew(int keySize, ElHashFct hashFct);
+
+/** \brief Creates a new hash set of strings. The set stores its own copies of the strings.
+ *
+ * \return New empty hash set.
+ *
+ */
+HashSet hashSetNewStr(void);
+
+/** \brief Destroys a hash set and all its content.
+ *
+ * \param s : HashSet to destroy.
+ * \return void
+ *
+ */
+void hashSetDel(HashSet s);
+
+
+
+/** \brief Sets the function to compare 2 keys of this hash set, note that if you declared the hash set key with EL_*, the comparison function of the specified type is automatically linked.
+ *
+ * \param s : HashSet in which you set the fonction.
+ * \param fct : pointer to the function, the function must take 2 pointers to the keys and return an int which is =0 if the keys are equal.
+ * \return nothing.
+ *
+ */
+void hashSetComparable(HashSet s, ElCmpFct fct);
+
+/** \brief Sets the functions to copy a key and to delete a key of this hash set. If not called, the keys will be copied bit by bit. /!\ Must be set before any HashSet update
+ *
+ * \param s : HashSet in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated key to initialize and the second is the source key and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the key to destroy. Note that this pointer will be automatically freed, so delFct must'nt do this.
+ * \return nothing.
+ *
+ */
+void hashSetElementInstanciable(HashSet s, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Copies a hash set and all its content.
+ *
+ * \param s : HashSet to copy.
+ * \return Copy of the hash set
+ *
+ */
+HashSet hashSetClone(const HashSet s);
+
+
+
+/** \brief Removes the whole content of a hash set.
+ *
+ * \param s : HashSet to clear.
+ * \return nothing.
+ *
+ */
+void hashSetClear(HashSet s);
+
+/** \brief Makes room for a number of keys, so that the hash set doesn't grow until it holds them.
+ *
+ * \param s : HashSet to prepare.
+ * \param capacity : number of keys.
+ * \return nothing.
+ *
+ */
+void hashSetReserve(HashSet s, int capacity);
+
+
+
+/** \brief Tells whether a hash set is empty or not
+ *
+ * \param s : HashSet to look in.
+ * \return true if empty, false if not.
+ *
+ */
+bool hashSetIsEmpty(const HashSet s);
+
+/** \brief Returns the length of the hash set.
+ *
+ * \param s : HashSet to count keys.
+ * \return Number of keys.
+ *
+ */
+int hashSetLength(const HashSet s);
+
+
+
+/** \brief Tells whether the hash set contains a key or not.
+ *
+ * \param s : HashSet to look into.
+ * \param key : A key.
+ * \return true if found, false otherwise.
+ *
+ */
+bool hashSetContains_base(const HashSet s, const Ptr key);
+#define hashSetContains(s, key) hashSetContains_base(s, &(key))
+
+/** \brief Adds a key to a hash set, if it isn't already in it.
+ *
+ * \param s : HashSet to modify.
+ * \param key : A key.
+ * \return true if the key was added, false if it was already in the set.
+ *
+ */
+bool hashSetInsert_base(HashSet s, const Ptr key);
+#define hashSetInsert(s, key) hashSetInsert_base(s, &(key))
+#define hashSetInsertI(s, key, type) {type tmp = (key); hashSetInsert_base(s, &(tmp));}
+
+/** \brief Removes a key from a hash set.
+ *
+ * \param s : HashSet to remove in.
+ * \param key : A key.
+ * \return true if the key was removed, false if it wasn't in the set.
+ *
+ */
+bool hashSetRemove_base(HashSet s, const Ptr key);
+#define hashSetRemove(s, key) hashSetRemove_base(s, &(key))
+#define hashSetRemoveI(s, key, type) {type tmp = (key); hashSetRemove_base(s, &(tmp));}
+
+
+
+/** \brief Creates the union of 2 hash sets with the same type of keys. The biggest set is cloned, and the keys of the other one are added.
+ *
+ * \param a : first HashSet.
+ * \param b : second HashSet.
+ * \return New hash set of the keys in a or b.
+ *
+ */
+HashSet hashSetUnion(const HashSet a, const HashSet b);
+
+/** \brief Creates the intersection of 2 hash sets with the same type of keys. The keys of the smallest set are looked up in the other one.
+ *
+ * \param a : first HashSet.
+ * \param b : second HashSet.
+ * \return New hash set of the keys in both a and b.
+ *
+ */
+HashSet hashSetIntersection(const HashSet a, const HashSet b);
+
+/** \brief Creates the difference of 2 hash sets with the same type of keys. If a is the smallest, its keys are looked up in b, else the keys of b are removed from a clone of a.
+ *
+ * \param a : HashSet of the keys to keep.
+ * \param b : HashSet of the keys to leave out.
+ * \return New hash set of the keys in a but not in b.
+ *
+ */
+HashSet hashSetDifference(const HashSet a, const HashSet b);
+
+
+
+// Iteration
+
+typedef struct {
+    HashSet set;
+    int index;
+} HashSetIt;
+
+
+
+/** \brief Creates an iterator on the hash set (Starting with the first key).
+ *
+ * \param s : HashSet to iterate.
+ * \return Iterator on this hash set.
+ *
+ */
+HashSetIt hashSetItNew(const HashSet s);
+
+
+
+/** \brief Determines whether the key pointed by the iterator exists or it is the end of the iteration
+ *
+ * \param it : Iterator on a hash set.
+ * \return true if key exists, false otherwise.
+ *
+ */
+bool hashSetItExists(const HashSetIt *it);
+
+
+
+/** \brief Positions the iterator on the next key
+ *
+ * \param it : Iterator on a hash set.
+ * \return nothing.
+ *
+ */
+void hashSetItNext(HashSetIt *it);
+
+
+
+/** \brief Returns the key pointed by the iterator
+ *
+ * \param it : Iterator on a hash set.
+ * \return key.
+ *
+ */
+const Ptr hashSetItGet_base(const HashSetIt *it);
+#define hashSetItGet(it, type) (*(type*)hashSetItGet_base(it))
+
+
+
+/** \brief Removes the key pointed by the iterator. hashSetItNext must be called before reading the next key.
+ *
+ * \param it : Iterator on a hash set.
+ * \return nothing.
+ *
+ */
+void hashSetItRemove(HashSetIt *it);
+
+
+
+/** \brief makes an action for every key of the hash set, in no particular order
+ *
+ * \param s : HashSet to iterate.
+ * \param actFct : Pointer to a function called for each key of the hash set.
+ * \param infos : pointer broadcasted to actFct. Useful to share additional informations to the function.
+ * \return nothing.
+ *
+ */
+void hashSetForEach(HashSet s, ElActFct actFct, Ptr infos);
+
+/** \brief Adds the keys of a contiguous buffer to a hash set.
+ *
+ * \param s : HashSet to modify.
+ * \param rawData : buffer of keys, packed.
+ * \param nbElements : number of keys in the buffer.
+ * \return nothing.
+ *
+ */
+void hashSetAddRaw(HashSet s, Ptr rawData, int nbElements);
+
+/** \brief Copies all the keys of the hash set bit by bit to a contiguous buffer, in no particular order.
+ *
+ * \param s : HashSet to copy.
+ * \param dest : buffer of at least hashSetLength(s) keys.
+ * \return nothing.
+ *
+ */
+void hashSetCopyToRaw(const HashSet s, Ptr dest);
+
+
+
+/** \brief Prints informations about the memory usage of a hash set.
+ *
+ * \param s : HashSet to dump.
+ * \return nothing.
+ *
+ */
+void hashSetDump(const HashSet s);
+
+#endif
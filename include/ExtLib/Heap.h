@@ -59,6 +59,16 @@ void heapComparable(Heap h, ElCmpFct fct);
  */
 void heapElementInstanciable(Heap h, ElCopyFct copyFct, ElDelFct delFct);
 
+/** \brief Sets how the capacity of the heap follows its length. Pushing into a full heap multiplies the capacity by growthFactor, and removing elements shrinks it once the length drops to 1/shrinkDivisor of it.
+ *
+ * \param h : Heap in which you set the policy.
+ * \param growthFactor : factor greater than 1, EL_DEFGROWTH by default.
+ * \param shrinkDivisor : divisor greater than growthFactor (raised if needed), EL_DEFSHRINK by default. EL_NEVER_SHRINK keeps the capacity, even when the heap is cleared.
+ * \return nothing.
+ *
+ */
+void heapCapacityPolicy(Heap h, float growthFactor, int shrinkDivisor);
+
 
 
 /** \brief Copies a heap and all its content.
@@ -97,6 +107,15 @@ bool heapIsEmpty(const Heap h);
  */
 int heapLength(const Heap h);
 
+/** \brief Makes the capacity of the heap at least a given number of elements, in a single allocation.
+ *
+ * \param h : Heap to grow.
+ * \param capacity : number of elements the heap can hold without reallocating.
+ * \return nothing.
+ *
+ */
+void heapReserve(Heap h, int capacity);
+
 
 
 /** \brief Returns the element with the highest priority in the heap.
@@ -145,6 +164,23 @@ void heapDump(const Heap h);
 
 
 
-//void heapHeapify(Ptr data, unsigned int count);
+/** \brief makes an action for every element of the heap, in no particular order
+ *
+ * \param h : Heap to iterate.
+ * \param actFct : Pointer to a function called for each element of the heap. It mustn't change the order of the elements.
+ * \param infos : pointer broadcasted to actFct. Useful to share additional informations to the function.
+ * \return nothing.
+ *
+ */
+void heapForEach(Heap h, ElActFct actFct, Ptr infos);
+
+/** \brief Copies all the elements of the heap bit by bit to a contiguous buffer, in no particular order, with a single memcpy when the elements fill their slots.
+ *
+ * \param h : Heap to copy.
+ * \param dest : buffer of at least heapLength(h) elements.
+ * \return nothing.
+ *
+ */
+void heapCopyToRaw(const Heap h, Ptr dest);
 
 #endif
@@ -17,6 +17,65 @@
 #include "SimpleList.h"
 #include "List.h"
 #include "Heap.h"
+#include "Deque.h"
+#include "Hash.h"
+#include "HashSet.h"
+
+/** \brief Returns the number of elements of a collection of any type.
+ *
+ * \param c : collection.
+ * \return Number of elements.
+ *
+ */
+int collectionLength(Collection c);
+
+/** \brief makes an action for every element of a collection of any type. The elements of a hash table are its values.
+ *
+ * \param c : collection to iterate.
+ * \param actFct : Pointer to a function called for each element of the collection.
+ * \param infos : pointer broadcasted to actFct. Useful to share additional informations to the function.
+ * \return nothing.
+ *
+ */
+void collectionForEach(Collection c, ElActFct actFct, Ptr infos);
+
+/** \brief Removes all the elements of a collection of any type.
+ *
+ * \param c : collection to clear.
+ * \return nothing.
+ *
+ */
+void collectionClear(Collection c);
+
+
+
+/** \brief Returns the size in bytes of each element copied by collectionCopyToRaw : the element size, or the size of a key/value pair for a hash table (see hashGetPairSize).
+ *
+ * \param c : collection.
+ * \return Size of a copied element.
+ *
+ */
+int collectionGetRawElemSize(Collection c);
+
+/** \brief Copies all the elements of a collection of any type bit by bit to a contiguous buffer, in the order of collectionForEach.
+ * Elements stored inline are copied with a single memcpy per block. A hash table gives its key/value pairs (see hashCopyToRaw).
+ *
+ * \param c : collection to copy.
+ * \param dest : buffer of at least collectionLength(c)*collectionGetRawElemSize(c) bytes.
+ * \return nothing.
+ *
+ */
+void collectionCopyToRaw(Collection c, Ptr dest);
+
+/** \brief Same as collectionCopyToRaw, in a new buffer.
+ *
+ * \param c : collection to copy.
+ * \return a buffer allocated with malloc, to be freed by the caller.
+ *
+ */
+Ptr collectionToRaw(Collection c);
+
+
 
 /** \brief Returns a new array containing all the elements of the collection. The copy and delete functions are forwarded to the array.
  *
@@ -50,9 +109,62 @@ List toList(Collection src);
  */
 Heap toHeap(Collection src);
 
+/** \brief Returns a new double-ended queue containing all the elements of the collection. The copy and delete functions are forwarded to the deque.
+ *
+ * \param src : collection.
+ * \return a deque.
+ *
+ */
+Deque toDeque(Collection src);
+
+
+
+// Move conversions : the source is destroyed and its elements are moved bit by bit into the new collection, without calling
+// their copy and delete functions. The element settings (size, comparison, copy and delete functions) are forwarded.
+
+/** \brief Moves all the elements of a doubly-linked list to a new array, in the same order, and destroys the list.
+ *
+ * \param l : List to move, destroyed.
+ * \return an array.
+ *
+ */
+Array arrayFromListMove(List l);
+
+/** \brief Moves all the elements of a singly-linked list to a new array, in the same order, and destroys the list.
+ *
+ * \param l : SimpleList to move, destroyed.
+ * \return an array.
+ *
+ */
+Array arrayFromSimpleListMove(SimpleList l);
+
+/** \brief Moves all the elements of a heap to a new array, in heap order, and destroys the heap. The array takes over the storage of the heap, no element is moved in memory.
+ *
+ * \param h : Heap to move, destroyed.
+ * \return an array.
+ *
+ */
+Array arrayFromHeapMove(Heap h);
+
+/** \brief Moves all the elements of an array to a new heap, and destroys the array. The heap takes over the storage of the array and reorders it in place, in linear time. A comparison function must have been set in the array.
+ *
+ * \param a : Array to move, destroyed.
+ * \return a heap.
+ *
+ */
+Heap heapFromArrayMove(Array a);
+
+/** \brief Moves all the elements of an array to a new doubly-linked list, in the same order, and destroys the array.
+ *
+ * \param a : Array to move, destroyed.
+ * \return a doubly-linked list.
+ *
+ */
+List listFromArrayMove(Array a);
+
 
 
-/** \brief Adds all the elements of src in dest. Elements must be the same type in src and dest.
+/** \brief Adds all the elements of src in dest. Elements must be the same type in src and dest. Sources storing their elements contiguously are copied in bulk. dest can't be a string or a hash table.
  *
  * \param dest : destination collection.
  * \param src : source collection.
@@ -63,7 +175,7 @@ void collectionAddAll(Collection dest, Collection src);
 
 
 
-/** \brief Adds all the elements from data which is a contiguous array of nbElements elements to dest.
+/** \brief Adds all the elements from data which is a contiguous array of nbElements elements to dest. dest can't be a string or a hash table.
  *
  * \param dest : destination collection.
  * \param rawData : source array.
@@ -0,0 +1,201 @@
+/**
+ * \file Iterator.h
+ * \brief Lazy iterators over collections
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * An iterator gives the elements of a source one at a time, when asked. Adaptors (filter, map, take, skip, zip, chain) wrap
+ * other iterators into pipelines : each element goes through the whole pipeline before the next one is read, and no
+ * intermediate collection is built. Terminal operations (collect, reduce, any, all...) run a pipeline and destroy it.
+ * Adaptors take the ownership of the iterators they wrap, so a pipeline is destroyed with its last iterator.
+ * The source collections mustn't be modified while an iterator reads them.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_ITERATOR_H
+#define EXTLIB_ITERATOR_H
+
+#include "Common.h"
+#include "Collection.h"
+#include "Array.h"
+#include "Hash.h"
+
+/** Iterator : type for a lazy iterator. */
+typedef struct _Iterator *Iterator;
+
+/** Returns the address of the second object of a pair made by iteratorZip, from the size of the first one. */
+#define iteratorPairSecond(pair, firstSize) ((void *)(pair) + (((firstSize) + 7) & ~7))
+
+
+
+/** \brief Creates an iterator over the elements of a collection, in the order of its own iterator. The elements of a hash table are its values.
+ *
+ * \param c : Array, List, SimpleList, Hash or HashSet to read.
+ * \return New iterator, or NULL for other types of collections.
+ *
+ */
+Iterator iteratorNew(Collection c);
+
+/** \brief Creates an iterator over the keys of a hash table, in the same order as iteratorNew gives its values.
+ *
+ * \param h : Hash to read.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorNewKeys(Hash h);
+
+/** \brief Destroys an iterator and all the iterators it wraps.
+ *
+ * \param it : Iterator to destroy.
+ * \return nothing.
+ *
+ */
+void iteratorDel(Iterator it);
+
+/** \brief Returns the next element of an iterator.
+ *
+ * \param it : Iterator.
+ * \return Pointer to the element, valid until the next call, or NULL once there are no more elements.
+ *
+ */
+Ptr iteratorNext(Iterator it);
+
+/** \brief Returns the size in bytes of the elements of an iterator.
+ *
+ * \param it : Iterator.
+ * \return Size of an element.
+ *
+ */
+int iteratorGetElemSize(const Iterator it);
+
+
+
+/** \brief Creates an iterator giving only the elements of another one for which a predicate holds.
+ *
+ * \param src : Iterator to filter, owned by the new one.
+ * \param predFct : Pointer to the predicate, which keeps the element when it returns true.
+ * \param infos : pointer broadcasted to predFct.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorFilter(Iterator src, ElPredFct predFct, Ptr infos);
+
+/** \brief Creates an iterator giving the image of each element of another one. The images have no copy nor delete function : they are handed over bit by bit.
+ *
+ * \param src : Iterator to map, owned by the new one.
+ * \param elemSize : the size in bytes of the images. You can use the EL_* constants for the basic types, this will automatically link the comparison function too.
+ * \param mapFct : Pointer to a function initializing an image from an element.
+ * \param infos : pointer broadcasted to mapFct.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorMap(Iterator src, int elemSize, ElMapFct mapFct, Ptr infos);
+
+/** \brief Creates an iterator giving at most the first n elements of another one. It stops reading the source once they are given.
+ *
+ * \param src : Iterator, owned by the new one.
+ * \param n : maximum number of elements.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorTake(Iterator src, int n);
+
+/** \brief Creates an iterator giving the elements of another one after the first n.
+ *
+ * \param src : Iterator, owned by the new one.
+ * \param n : number of elements to skip.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorSkip(Iterator src, int n);
+
+/** \brief Creates an iterator giving pairs of elements read together from 2 iterators, until one of them ends.
+ * The first object of a pair is at its start, the second one is at iteratorPairSecond(pair, size of the first). Pairs have no copy nor delete function.
+ *
+ * \param first : Iterator of the first objects, owned by the new one.
+ * \param second : Iterator of the second objects, owned by the new one.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorZip(Iterator first, Iterator second);
+
+/** \brief Creates an iterator giving all the elements of an iterator, then all those of another one. Elements must be the same type in both.
+ *
+ * \param first : first Iterator, owned by the new one.
+ * \param second : second Iterator, owned by the new one.
+ * \return New iterator.
+ *
+ */
+Iterator iteratorChain(Iterator first, Iterator second);
+
+
+
+/** \brief Puts all the remaining elements of an iterator into a new array, then destroys the iterator. The comparison, copy and delete functions of the source are forwarded to the array.
+ *
+ * \param it : Iterator to consume.
+ * \return an array.
+ *
+ */
+Array iteratorCollectArray(Iterator it);
+
+/** \brief Sets all the remaining pairs of an iterator made by iteratorZip in a hash table, the first object being the key and the second the value, then destroys the iterator.
+ *
+ * \param it : Iterator of pairs to consume.
+ * \param h : Hash receiving the pairs, its keys and elements must be the types of the first and second objects.
+ * \return nothing.
+ *
+ */
+void iteratorCollectHash(Iterator it, Hash h);
+
+/** \brief Makes an action for all the remaining elements of an iterator, then destroys it.
+ *
+ * \param it : Iterator to consume.
+ * \param actFct : Pointer to a function called for each element.
+ * \param infos : pointer broadcasted to actFct.
+ * \return nothing.
+ *
+ */
+void iteratorForEach(Iterator it, ElActFct actFct, Ptr infos);
+
+/** \brief Accumulates all the remaining elements of an iterator, then destroys it.
+ *
+ * \param it : Iterator to consume.
+ * \param acc : Pointer to the accumulator. It must hold the initial value and receives the result.
+ * \param reduceFct : Pointer to a function accumulating an element into acc.
+ * \param infos : pointer broadcasted to reduceFct.
+ * \return nothing.
+ *
+ */
+void iteratorReduce(Iterator it, Ptr acc, ElReduceFct reduceFct, Ptr infos);
+
+/** \brief Counts the remaining elements of an iterator, then destroys it.
+ *
+ * \param it : Iterator to consume.
+ * \return Number of elements.
+ *
+ */
+int iteratorCount(Iterator it);
+
+/** \brief Tells whether a predicate holds for at least one remaining element of an iterator, then destroys it. Reading stops at the first such element.
+ *
+ * \param it : Iterator to consume.
+ * \param predFct : Pointer to the predicate.
+ * \param infos : pointer broadcasted to predFct.
+ * \return true if an element satisfies the predicate, false otherwise.
+ *
+ */
+bool iteratorAny(Iterator it, ElPredFct predFct, Ptr infos);
+
+/** \brief Tells whether a predicate holds for all the remaining elements of an iterator, then destroys it. Reading stops at the first element failing it.
+ *
+ * \param it : Iterator to consume.
+ * \param predFct : Pointer to the predicate.
+ * \param infos : pointer broadcasted to predFct.
+ * \return true if all the elements satisfy the predicate (or if there are none), false otherwise.
+ *
+ */
+bool iteratorAll(Iterator it, ElPredFct predFct, Ptr infos);
+
+#endif
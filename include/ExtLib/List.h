@@ -32,6 +32,15 @@ typedef struct _ListNode *ListNode;
  */
 List listNew(int elemSize);
 
+/** \brief Creates a new unrolled doubly-linked list : each node holds several elements stored contiguously, which makes scans nearly as fast as on an array while keeping O(1) insertion at an iterator.
+ *
+ * \param elemSize : the size in bytes of each element of the list. You can use the EL_* constants for the basic types, this will automatically link the comparison function too.
+ * \param nodeSize : the size in bytes of the elements of a node (0 for the default of 256 bytes). A node holds at least 2 elements.
+ * \return New empty list.
+ *
+ */
+List listNewUnrolled(int elemSize, int nodeSize);
+
 /** \brief Destroys a list and all its content (Not primitive).
  *
  * \param l : List to destroy.
@@ -228,6 +237,7 @@ void listDump(const List l);
 typedef struct {
     List list;
     ListNode node;
+    int index; // position in the node for unrolled lists
     bool onNext;
 } ListIt;
 
@@ -348,4 +358,13 @@ void listItRemove(ListIt *it);
  */
 void listForEach(List l, ElActFct actFct, Ptr infos);
 
+/** \brief Copies all the elements of the list bit by bit to a contiguous buffer, from the first to the last, with a single memcpy per node of an unrolled list.
+ *
+ * \param l : List to copy.
+ * \param dest : buffer of at least listLength(l) elements.
+ * \return nothing.
+ *
+ */
+void listCopyToRaw(const List l, Ptr dest);
+
 #endif
@@ -14,24 +14,25 @@
 #ifndef EXTLIB_QUEUE_H
 #define EXTLIB_QUEUE_H
 
-#include "List.h"
+#include "Deque.h"
 
-/** Queue : type for a queue. */
-typedef List Queue;
+/** Queue : type for a queue, backed by a circular buffer. */
+typedef Deque Queue;
 
 
-#define queueNew(elemSize)                  listNew(elemSize)
-#define queueDel(q)                         listDel(q)
-#define queueClone(q)                       listClone(q)
+#define queueNew(elemSize)                  dequeNew(elemSize)
+#define queueDel(q)                         dequeDel(q)
+#define queueClone(q)                       dequeClone(q)
 
-#define queueClear(q)                       listClear(q)
-#define queueIsEmpty(q)                     listIsEmpty(q)
+#define queueClear(q)                       dequeClear(q)
+#define queueIsEmpty(q)                     dequeIsEmpty(q)
+#define queueLength(q)                      dequeLength(q)
 
-#define queueGet(q, type)                   listGetFirst(q, type)
-#define queueAdd(q, data)                   listAddLast(q, data)
-#define queueAddI(q, data, type)            listAddLastI(q, data, type)
-#define queueRemove(q)                      listRemoveFirst(q)
+#define queueGet(q, type)                   dequeGetFirst(q, type)
+#define queueAdd(q, data)                   dequeAddLast(q, data)
+#define queueAddI(q, data, type)            dequeAddLastI(q, data, type)
+#define queueRemove(q)                      dequeRemoveFirst(q)
 
-#define queueDump(q)                        listDump(q)
+#define queueDump(q)                        dequeDump(q)
 
 #endif
@@ -280,4 +280,13 @@ void simpleListItRemove(SimpleListIt *it);
  */
 void simpleListForEach(SimpleList l, ElActFct actFct, Ptr infos);
 
+/** \brief Copies all the elements of the list bit by bit to a contiguous buffer, from the first to the last.
+ *
+ * \param l : SimpleList to copy.
+ * \param dest : buffer of at least simpleListLength(l) elements.
+ * \return nothing.
+ *
+ */
+void simpleListCopyToRaw(const SimpleList l, Ptr dest);
+
 #endif
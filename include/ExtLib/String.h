@@ -87,6 +87,25 @@ void stringClear(String str);
 
 
 
+/** \brief Makes sure a string can hold at least capacity characters without any reallocation.
+ *
+ * \param str : a string.
+ * \param capacity : number of characters to preallocate (add 1 if stringCStr will be called).
+ * \return nothing.
+ *
+ */
+void stringReserve(String str, int capacity);
+
+/** \brief Makes the capacity of the string fit its content while freeing all the preallocated memory.
+ *
+ * \param str : string to trim.
+ * \return nothing.
+ *
+ */
+void stringTrimCapacity(String str);
+
+
+
 /** \brief Determinates whether a string is empty or not.
  *
  * \param str : a string.
@@ -142,9 +161,17 @@ int stringIndexOf(String str, const char *pattern, int from);
  */
 int stringCompare(String str1, String str2);
 
+/** \brief Hashes the content of a string, with the same function as hashBytes().
+ *
+ * \param str : a string.
+ * \return hash of the string.
+ *
+ */
+unsigned long stringHash(String str);
+
 
 
-/** \brief Appends a C string to a string.
+/** \brief Appends a C string to a string, cStr may be a part of str.
  *
  * \param str : a string.
  * \param cStr : a C string.
@@ -153,7 +180,17 @@ int stringCompare(String str1, String str2);
  */
 void stringAppend(String str, const char *cStr);
 
-/** \brief Appends a string to another string.
+/** \brief Appends the length first characters of a buffer to a string. The buffer doesn't need to be null-terminated and may be a part of str.
+ *
+ * \param str : a string.
+ * \param data : a buffer of characters.
+ * \param length : number of characters to append.
+ * \return nothing.
+ *
+ */
+void stringAppendN(String str, const char *data, int length);
+
+/** \brief Appends a string to another string, str2 may be str itself.
  *
  * \param str : a string.
  * \param str2 : a string.
@@ -180,10 +217,73 @@ void stringAppendChar(String str, const char c);
  */
 void stringAppendInt(String str, const int i);
 
-/** \brief Appends a formatted string to a string.
+/** \brief Appends an unsigned int to a string.
+ *
+ * \param str : a string.
+ * \param i : an unsigned int.
+ * \return nothing.
+ *
+ */
+void stringAppendUint(String str, const unsigned int i);
+
+/** \brief Appends a long to a string.
+ *
+ * \param str : a string.
+ * \param i : a long.
+ * \return nothing.
+ *
+ */
+void stringAppendLong(String str, const long i);
+
+/** \brief Appends an unsigned long to a string.
+ *
+ * \param str : a string.
+ * \param i : an unsigned long.
+ * \return nothing.
+ *
+ */
+void stringAppendUlong(String str, const unsigned long i);
+
+/** \brief Appends a long long to a string.
+ *
+ * \param str : a string.
+ * \param i : a long long.
+ * \return nothing.
+ *
+ */
+void stringAppendLonglong(String str, const long long i);
+
+/** \brief Appends an unsigned long long to a string.
  *
  * \param str : a string.
- * \param format : an int.
+ * \param i : an unsigned long long.
+ * \return nothing.
+ *
+ */
+void stringAppendUlonglong(String str, const unsigned long long i);
+
+/** \brief Appends a float to a string, using the shortest representation that reads back to the same value.
+ *
+ * \param str : a string.
+ * \param f : a float.
+ * \return nothing.
+ *
+ */
+void stringAppendFloat(String str, const float f);
+
+/** \brief Appends a double to a string, using the shortest representation that reads back to the same value (e.g. 0.1, 1e+100, 5e-324).
+ *
+ * \param str : a string.
+ * \param d : a double.
+ * \return nothing.
+ *
+ */
+void stringAppendDouble(String str, const double d);
+
+/** \brief Appends a formatted string (printf syntax) to a string, whatever the length of the result.
+ *
+ * \param str : a string.
+ * \param format : a format string.
  * \param ... : format args
  * \return nothing.
  *
@@ -192,6 +292,52 @@ void stringAppendF(String str, const char *format, ...);
 
 
 
+/** \brief Parses an int written in decimal at the beginning of a range of a string. The range doesn't need to be null-terminated. Values out of range are clamped to INT_MIN or INT_MAX.
+ *
+ * \param str : a string.
+ * \param start : start position (included).
+ * \param end : end position (excluded).
+ * \param value : pointer receiving the parsed value (unchanged if nothing was parsed).
+ * \return number of characters read, 0 if the range doesn't start with a number.
+ *
+ */
+int stringParseInt(String str, int start, int end, int *value);
+
+/** \brief Parses a long written in decimal at the beginning of a range of a string. The range doesn't need to be null-terminated. Values out of range are clamped to LONG_MIN or LONG_MAX.
+ *
+ * \param str : a string.
+ * \param start : start position (included).
+ * \param end : end position (excluded).
+ * \param value : pointer receiving the parsed value (unchanged if nothing was parsed).
+ * \return number of characters read, 0 if the range doesn't start with a number.
+ *
+ */
+int stringParseLong(String str, int start, int end, long *value);
+
+/** \brief Parses a long long written in decimal at the beginning of a range of a string. The range doesn't need to be null-terminated. Values out of range are clamped to LLONG_MIN or LLONG_MAX.
+ *
+ * \param str : a string.
+ * \param start : start position (included).
+ * \param end : end position (excluded).
+ * \param value : pointer receiving the parsed value (unchanged if nothing was parsed).
+ * \return number of characters read, 0 if the range doesn't start with a number.
+ *
+ */
+int stringParseLonglong(String str, int start, int end, long long *value);
+
+/** \brief Parses a double at the beginning of a range of a string (same syntax as strtod() for decimal numbers, inf and nan). The range doesn't need to be null-terminated. The result is correctly rounded.
+ *
+ * \param str : a string.
+ * \param start : start position (included).
+ * \param end : end position (excluded).
+ * \param value : pointer receiving the parsed value (unchanged if nothing was parsed).
+ * \return number of characters read, 0 if the range doesn't start with a number.
+ *
+ */
+int stringParseDouble(String str, int start, int end, double *value);
+
+
+
 /** \brief Details the heap usage of a given string
  *
  * \param str : String to dump
@@ -0,0 +1,150 @@
+/**
+ * \file StringBuilder.h
+ * \brief Primitives functions for string builders
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A string builder accumulates text in a list of chunks instead of one contiguous buffer,
+ * so building huge strings never reallocates nor copies what has already been appended.
+ * The final String is materialized once, with its exact size.
+ * StringBuilder is neither a Collection nor Iterable.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_STRINGBUILDER_H
+#define EXTLIB_STRINGBUILDER_H
+
+#include "Common.h"
+#include "String.h"
+
+#include <stdio.h>
+
+/** StringBuilder : type for a string builder. */
+typedef struct _StringBuilder *StringBuilder;
+
+
+
+/** \brief Creates a new string builder.
+ *
+ * \return New empty string builder.
+ *
+ */
+StringBuilder stringBuilderNew();
+
+/** \brief Destroys a string builder and all its content.
+ *
+ * \param sb : string builder to destroy.
+ * \return nothing.
+ *
+ */
+void stringBuilderDel(StringBuilder sb);
+
+/** \brief Destroys a string builder and returns its content as a string. The string is allocated with its exact size before the chunks are copied, so the content is held twice until they are freed.
+ *
+ * \param sb : string builder to destroy.
+ * \return New string.
+ *
+ */
+String stringBuilderDelKeepString(StringBuilder sb);
+
+
+
+/** \brief Empties a string builder.
+ *
+ * \param sb : string builder to clear.
+ * \return nothing.
+ *
+ */
+void stringBuilderClear(StringBuilder sb);
+
+
+
+/** \brief Returns the number of characters in a string builder.
+ *
+ * \param sb : a string builder.
+ * \return number of characters.
+ *
+ */
+int stringBuilderLength(StringBuilder sb);
+
+
+
+/** \brief Appends a C string to a string builder.
+ *
+ * \param sb : a string builder.
+ * \param cStr : a C string.
+ * \return nothing.
+ *
+ */
+void stringBuilderAppend(StringBuilder sb, const char *cStr);
+
+/** \brief Appends the length first characters of a buffer to a string builder.
+ *
+ * \param sb : a string builder.
+ * \param data : a buffer of characters.
+ * \param length : number of characters to append.
+ * \return nothing.
+ *
+ */
+void stringBuilderAppendN(StringBuilder sb, const char *data, int length);
+
+/** \brief Appends a string to a string builder.
+ *
+ * \param sb : a string builder.
+ * \param str : a string.
+ * \return nothing.
+ *
+ */
+void stringBuilderAppendString(StringBuilder sb, const String str);
+
+/** \brief Appends a character to a string builder.
+ *
+ * \param sb : a string builder.
+ * \param c : a character.
+ * \return nothing.
+ *
+ */
+void stringBuilderAppendChar(StringBuilder sb, const char c);
+
+/** \brief Appends a formatted string (printf syntax) to a string builder.
+ *
+ * \param sb : a string builder.
+ * \param format : a format string.
+ * \param ... : format args
+ * \return nothing.
+ *
+ */
+void stringBuilderAppendF(StringBuilder sb, const char *format, ...);
+
+
+
+/** \brief Returns a new string with the content of a string builder, allocated once with its exact size.
+ *
+ * \param sb : a string builder.
+ * \return New string.
+ *
+ */
+String stringBuilderToString(StringBuilder sb);
+
+/** \brief Writes the content of a string builder to a file, chunk by chunk, without materializing it.
+ *
+ * \param sb : a string builder.
+ * \param file : an opened file.
+ * \return true if everything was written, false otherwise.
+ *
+ */
+bool stringBuilderWrite(StringBuilder sb, FILE *file);
+
+
+
+/** \brief Details the heap usage of a given string builder
+ *
+ * \param sb : string builder to dump
+ * \return void
+ *
+ */
+void stringBuilderDump(StringBuilder sb);
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * \file StringPool.h
+ * \brief Primitives functions for string pools
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A string pool interns strings : every distinct content is stored once, as an immutable C string
+ * whose hash is computed once. Two strings interned in the same pool are equal if and only if
+ * their pointers are equal. Interned strings live as long as their pool.
+ * StringPool is neither a Collection nor Iterable.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_STRINGPOOL_H
+#define EXTLIB_STRINGPOOL_H
+
+#include "Common.h"
+#include "String.h"
+
+/** StringPool : type for a string pool. */
+typedef struct _StringPool *StringPool;
+
+
+
+/** \brief Creates a new string pool.
+ *
+ * \return New empty string pool.
+ *
+ */
+StringPool stringPoolNew();
+
+/** \brief Destroys a string pool and all the strings interned in it.
+ *
+ * \param pool : string pool to destroy.
+ * \return nothing.
+ *
+ */
+void stringPoolDel(StringPool pool);
+
+
+
+/** \brief Returns the number of distinct strings in a string pool.
+ *
+ * \param pool : a string pool.
+ * \return number of strings.
+ *
+ */
+int stringPoolLength(const StringPool pool);
+
+
+
+/** \brief Returns the canonical copy of a C string, adding it to the pool if needed.
+ *
+ * \param pool : a string pool.
+ * \param cStr : a C string.
+ * \return interned string, must not be modified nor freed.
+ *
+ */
+const char *stringPoolIntern(StringPool pool, const char *cStr);
+
+/** \brief Returns the canonical copy of the length first characters of a buffer, adding it to the pool if needed.
+ *
+ * \param pool : a string pool.
+ * \param data : a buffer of characters (not necessarily null-terminated).
+ * \param length : number of characters.
+ * \return interned string, must not be modified nor freed.
+ *
+ */
+const char *stringPoolInternN(StringPool pool, const char *data, int length);
+
+/** \brief Returns the canonical copy of the content of a string, adding it to the pool if needed.
+ *
+ * \param pool : a string pool.
+ * \param str : a string.
+ * \return interned string, must not be modified nor freed.
+ *
+ */
+const char *stringPoolInternString(StringPool pool, const String str);
+
+/** \brief Returns the canonical copy of a C string if it has already been interned, without adding it.
+ *
+ * \param pool : a string pool.
+ * \param cStr : a C string.
+ * \return interned string or NULL.
+ *
+ */
+const char *stringPoolGet(const StringPool pool, const char *cStr);
+
+
+
+/** \brief Returns the hash of an interned string, without reading its characters.
+ *
+ * \param interned : a string returned by a stringPoolIntern* function.
+ * \return hash of the string.
+ *
+ */
+unsigned long stringPoolHash(const char *interned);
+
+/** \brief Returns the length of an interned string, without reading its characters.
+ *
+ * \param interned : a string returned by a stringPoolIntern* function.
+ * \return length of the string.
+ *
+ */
+int stringPoolStrLength(const char *interned);
+
+
+
+/** \brief Details the heap usage of a given string pool
+ *
+ * \param pool : string pool to dump
+ * \return void
+ *
+ */
+void stringPoolDump(const StringPool pool);
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * \file ThreadPool.h
+ * \brief Thread pool with work stealing
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A fixed set of worker threads running tasks. Each worker owns a WorkDeque : the tasks it submits go to its own deque,
+ * and idle workers steal from the others. Tasks submitted by other threads go through a shared injection queue.
+ * Threads waiting for a future run pending tasks instead of blocking, so tasks may submit and join subtasks.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_THREADPOOL_H
+#define EXTLIB_THREADPOOL_H
+
+#include "Common.h"
+
+/** ThreadPool : type for a thread pool. */
+typedef struct _ThreadPool *ThreadPool;
+
+/** Future : handle on a submitted task. */
+typedef struct _Future *Future;
+
+/** ElTaskFct : A task function. must take 1 generic pointer (Ptr) to additional informations sent by the caller and return nothing */
+typedef void(*ElTaskFct)(Ptr infos);
+
+/** ElRangeFct : A range function. must take the bounds of a range of indices (from included, to excluded) and 1 generic pointer (Ptr) to additional informations sent by the caller and return nothing */
+typedef void(*ElRangeFct)(int from, int to, Ptr infos);
+
+
+
+/** \brief Creates a new thread pool.
+ *
+ * \param nbThreads : the number of worker threads, 0 for the number of cores.
+ * \return New thread pool.
+ *
+ */
+ThreadPool threadPoolNew(int nbThreads);
+
+/** \brief Destroys a thread pool after all its pending tasks are done.
+ *
+ * \param pool : ThreadPool to destroy.
+ * \return void
+ *
+ */
+void threadPoolDel(ThreadPool pool);
+
+/** \brief Returns the default thread pool, with a thread per core. It is created at the first call and never destroyed.
+ *
+ * \return The default thread pool.
+ *
+ */
+ThreadPool threadPoolGetDefault();
+
+/** \brief Returns the number of worker threads of a pool.
+ *
+ * \param pool : ThreadPool.
+ * \return Number of worker threads.
+ *
+ */
+int threadPoolSize(const ThreadPool pool);
+
+
+
+/** \brief Submits a task to a pool.
+ *
+ * \param pool : ThreadPool running the task.
+ * \param fct : the task function.
+ * \param infos : pointer broadcasted to fct.
+ * \return A future, that must be given to futureJoin.
+ *
+ */
+Future threadPoolSubmit(ThreadPool pool, ElTaskFct fct, Ptr infos);
+
+/** \brief Tells whether the task of a future is done.
+ *
+ * \param f : Future.
+ * \return true if done, false otherwise.
+ *
+ */
+bool futureIsDone(const Future f);
+
+/** \brief Waits for the task of a future to be done, running other tasks of the pool meanwhile, then destroys the future.
+ *
+ * \param f : Future to join.
+ * \return nothing.
+ *
+ */
+void futureJoin(Future f);
+
+
+
+/** \brief Calls fct on chunks of the range [from, to) in parallel, and returns when all chunks are done.
+ *
+ * \param pool : ThreadPool running the chunks, NULL for the default pool.
+ * \param from : first index (included).
+ * \param to : last index (excluded).
+ * \param grain : number of indices per chunk, 0 to choose automatically.
+ * \param fct : function called for each chunk with its bounds.
+ * \param infos : pointer broadcasted to fct.
+ * \return nothing.
+ *
+ */
+void threadPoolParallelFor(ThreadPool pool, int from, int to, int grain, ElRangeFct fct, Ptr infos);
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * \file View.h
+ * \brief Read-only views over files saved by arraySave and hashSave
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * A view maps a saved file in memory and reads the elements in place : opening it costs a mmap and the validation of
+ * the header, whatever the number of elements, and the pages are loaded by the system when they are read.
+ * Pointers returned by a view stay valid until it is closed.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_VIEW_H
+#define EXTLIB_VIEW_H
+
+#include "Common.h"
+
+/** ArrayView : type for a read-only view over an array file. */
+typedef struct _ArrayView *ArrayView;
+
+/** HashView : type for a read-only view over a hash table file. */
+typedef struct _HashView *HashView;
+
+
+
+/** \brief Maps a file saved by arraySave.
+ *
+ * \param path : path of the file.
+ * \return New view, or NULL if the file can't be mapped or isn't a valid array file.
+ *
+ */
+ArrayView arrayViewOpen(const char *path);
+
+/** \brief Unmaps the file of a view and destroys it.
+ *
+ * \param v : ArrayView to close.
+ * \return nothing.
+ *
+ */
+void arrayViewClose(ArrayView v);
+
+/** \brief Returns the number of elements of an array view.
+ *
+ * \param v : ArrayView.
+ * \return Number of elements.
+ *
+ */
+int arrayViewLength(const ArrayView v);
+
+/** \brief Returns the size in bytes of the elements of an array view.
+ *
+ * \param v : ArrayView.
+ * \return Size of an element.
+ *
+ */
+int arrayViewGetElemSize(const ArrayView v);
+
+/** \brief Returns the address of an element of an array view. Elements are packed : their alignment is the one of their size, up to 8 bytes.
+ *
+ * \param v : ArrayView.
+ * \param pos : position of the element.
+ * \return Pointer to the element, in the mapping.
+ *
+ */
+const Ptr arrayViewGet_base(const ArrayView v, int pos);
+/** Automatic macro to cast the result of arrayViewGet_base */
+#define arrayViewGet(v, pos, type) (*(const type*)arrayViewGet_base(v, pos))
+
+
+
+/** \brief Maps a file saved by hashSave.
+ *
+ * \param path : path of the file.
+ * \return New view, or NULL if the file can't be mapped or isn't a valid hash table file.
+ *
+ */
+HashView hashViewOpen(const char *path);
+
+/** \brief Unmaps the file of a view and destroys it.
+ *
+ * \param v : HashView to close.
+ * \return nothing.
+ *
+ */
+void hashViewClose(HashView v);
+
+/** \brief Returns the number of elements of a hash table view.
+ *
+ * \param v : HashView.
+ * \return Number of elements.
+ *
+ */
+int hashViewLength(const HashView v);
+
+/** \brief Tells whether the keys of a hash table view are strings.
+ *
+ * \param v : HashView.
+ * \return true for string keys, false for keys compared bit by bit.
+ *
+ */
+bool hashViewHasStringKeys(const HashView v);
+
+/** \brief Returns the value at a key in a hash table view. Keys are compared bit by bit.
+ *
+ * \param v : HashView whose keys aren't strings.
+ * \param key : pointer to the key.
+ * \return Pointer to the value, in the mapping and aligned on 8 bytes, or NULL if there is no such key.
+ *
+ */
+const Ptr hashViewGet_base(const HashView v, const Ptr key);
+/** Automatic macro to send the address of key to hashViewGet_base */
+#define hashViewGet(v, key) hashViewGet_base(v, &(key))
+
+/** \brief Returns the value at a string key in a hash table view.
+ *
+ * \param v : HashView whose keys are strings.
+ * \param key : the key.
+ * \return Pointer to the value, in the mapping and aligned on 8 bytes, or NULL if there is no such key.
+ *
+ */
+const Ptr hashViewGetStr(const HashView v, const char *key);
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * \file WorkDeque.h
+ * \brief Primitives functions for work-stealing deques
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Chase-Lev work-stealing deque : a growable circular array in which the owner thread pushes and pops elements at the bottom (LIFO, like a Stack) while any other thread may steal elements from the top (FIFO).
+ * Elements are stored inline. Popping or stealing an element moves it bit by bit to the caller, who becomes responsible for it : the deletion function is only called on the elements left in the deque when it is destroyed.
+ * WorkDeque is not a Collection.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_WORKDEQUE_H
+#define EXTLIB_WORKDEQUE_H
+
+#include "Common.h"
+
+/** WorkDeque : type for a work-stealing deque. */
+typedef struct _WorkDeque *WorkDeque;
+
+
+
+/** \brief Creates a new work-stealing deque. The calling thread is not bound to it : the owner is whichever thread calls push and pop.
+ *
+ * \param elemSize : the size in bytes of each element of the deque. You can use the EL_* constants for the basic types.
+ * \return New empty deque.
+ *
+ */
+WorkDeque workDequeNew(int elemSize);
+
+/** \brief Destroys a deque and all its content. No thread may use the deque anymore.
+ *
+ * \param wd : WorkDeque to destroy.
+ * \return void
+ *
+ */
+void workDequeDel(WorkDeque wd);
+
+/** \brief Sets the functions to copy an element and to delete an element of this deque. If not called, the elements will be copied bit by bit. /!\ Must be set before any WorkDeque update
+ *
+ * \param wd : WorkDeque in which you set the fonction.
+ * \param copyFct : pointer to the copy function, the function must take 2 pointers, the first is the new allocated element to initialize and the second is the source element and return nothing.
+ * \param delFct : pointer to the deletion function, the function must take a pointer to the element to destroy.
+ * \return nothing.
+ *
+ */
+void workDequeElementInstanciable(WorkDeque wd, ElCopyFct copyFct, ElDelFct delFct);
+
+
+
+/** \brief Tells whether a deque is empty or not. The result is only a snapshot if other threads use the deque.
+ *
+ * \param wd : WorkDeque to look in.
+ * \return true if empty, false if not.
+ *
+ */
+bool workDequeIsEmpty(const WorkDeque wd);
+
+/** \brief Returns the number of elements in the deque. The result is only a snapshot if other threads use the deque.
+ *
+ * \param wd : WorkDeque to count elements.
+ * \return Number of elements.
+ *
+ */
+int workDequeLength(const WorkDeque wd);
+
+
+
+/** \brief Adds an element at the bottom of the deque, growing it if needed. Must only be called by the owner thread.
+ *
+ * \param wd : WorkDeque to add in.
+ * \param data : Pointer to the data to add.
+ * \return nothing.
+ *
+ */
+void workDequePush_base(WorkDeque wd, const Ptr data);
+/** Automatic macro to send the address of data to workDequePush_base */
+#define workDequePush(wd, data) workDequePush_base(wd, &(data))
+#define workDequePushI(wd, data, type) {type tmp = (data); workDequePush_base(wd, &(tmp));}
+
+/** \brief Removes the element at the bottom of the deque (the last pushed) and moves it to dest. Must only be called by the owner thread.
+ *
+ * \param wd : WorkDeque to remove in.
+ * \param dest : Pointer to the memory receiving the element.
+ * \return true if an element was removed, false if the deque is empty.
+ *
+ */
+bool workDequePop_base(WorkDeque wd, Ptr dest);
+/** Automatic macro to send the address of dest to workDequePop_base */
+#define workDequePop(wd, dest) workDequePop_base(wd, &(dest))
+
+/** \brief Removes the element at the top of the deque (the first pushed) and moves it to dest. May be called by any thread.
+ *
+ * \param wd : WorkDeque to steal from.
+ * \param dest : Pointer to the memory receiving the element, its content is undefined if nothing was stolen.
+ * \return true if an element was stolen, false if the deque is empty.
+ *
+ */
+bool workDequeSteal_base(WorkDeque wd, Ptr dest);
+/** Automatic macro to send the address of dest to workDequeSteal_base */
+#define workDequeSteal(wd, dest) workDequeSteal_base(wd, &(dest))
+
+
+
+/** \brief Details the heap usage of a given deque
+ *
+ * \param wd : WorkDeque to dump
+ * \return void
+ *
+ */
+void workDequeDump(const WorkDeque wd);
+
+#endif
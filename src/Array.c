@@ -11,12 +11,19 @@
 #include "ExtLib/Collection.h"
 #include "ExtLib/Array.h"
 
+#include "ArrayKernels.h"
+#include "CollectionMove.h"
+#include "Serial.h"
+
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
 #define DEFSIZE 8
+#define NOTYPE 1 // elType of arrays not created with an EL_* constant
+#define CACHELINE 64
 
 struct _Array {
     RealType type;
@@ -28,22 +35,78 @@ struct _Array {
     bool needsAllocation;
     Ptr (*ptrTransform)(Ptr);
 
+    int elType;
+
     int length;
 
     int size;
+    float growth;
+    int shrinkDivisor;
     Ptr *ct;
 };
 
+struct _ArrayIndex {
+    Array array;
+    bool kernel;
+    KernelType t;
+
+    int length;
+    uint64_t *keys;  // BFS order from 1 : integer keys, floating elements, or pointers to the elements of the array
+    int *positions;  // position in the array of each key
+    void *buffer;    // keys aligned on a cache line
+};
+
+
 
+// Moves the slots from base count places to the right, the capacity must be enough
+static inline void arrayShift(Array a, int base, int count) {
+    memmove(&a->ct[base+count], &a->ct[base], (a->length-base)*sizeof(Ptr));
+}
+
+// Moves the slots after the count ones from base over them
+static inline void arrayUnshift(Array a, int base, int count) {
+    memmove(&a->ct[base], &a->ct[base+count], (a->length-base-count)*sizeof(Ptr));
+}
+
+// Ensures room for minSize slots, growing the capacity by the growth factor to keep pushes amortized
+static inline void arrayGrow(Array a, int minSize) {
+    if(minSize <= a->size)
+        return;
+
+    a->size = _elGrowSize(a->size, minSize, a->growth);
+    a->ct = realloc(a->ct, a->size*sizeof(Ptr));
+}
 
-static inline void arrayShift(Array a, int base) {
-    for(int i=a->length-1; i>=base; i--)
-        a->ct[i+1] = a->ct[i];
+// Reduces the capacity once the array uses too little of it, in a single reallocation
+static inline void arrayShrink(Array a) {
+    int size = _elShrinkSize(a->size, a->length, DEFSIZE, a->growth, a->shrinkDivisor);
+
+    if(size != a->size) {
+        a->size = size;
+        a->ct = realloc(a->ct, a->size*sizeof(Ptr));
+    }
+}
+
+static inline void arrayCopyIn(Array a, int pos, const Ptr data) {
+    if(a->needsAllocation) {
+        a->ct[pos] = malloc(a->elemSize);
+
+        if(a->copyFct)
+            a->copyFct(a->ct[pos], data);
+        else
+            memcpy(a->ct[pos], data, a->elemSize);
+    }
+    else
+        memcpy(&a->ct[pos], data, a->elemSize);
 }
 
-static inline void arrayUnshift(Array a, int base) {
-    for(int i=base; i<a->length-1; i++)
-        a->ct[i] = a->ct[i+1];
+static inline void arrayDelElt(Array a, int pos) {
+    if(a->needsAllocation) {
+        if(a->delFct)
+            a->delFct(a->ct[pos]);
+
+        free(a->ct[pos]);
+    }
 }
 
 static inline void arraySwap(Array a, int pos1, int pos2) {
@@ -52,6 +115,11 @@ static inline void arraySwap(Array a, int pos1, int pos2) {
     a->ct[pos2] = temp;
 }
 
+// Arrays of EL_* types keeping their inline elements and default comparison function are handled by the kernels
+static inline bool arrayKernelType(const Array a, KernelType *t) {
+    return a->elType != NOTYPE && !a->needsAllocation && a->cmpFct == _elCompareFct(a->elType) && kernelType(a->elType, t);
+}
+
 
 
 Array arrayNew(int elemSize) {
@@ -62,10 +130,12 @@ Array arrayNew(int elemSize) {
     if(elemSize<=0) {
         a->elemSize=_elSizeFct(elemSize);
         a->cmpFct=_elCompareFct(elemSize);
+        a->elType=elemSize;
     }
     else {
         a->elemSize=elemSize;
         a->cmpFct=NULL;
+        a->elType=NOTYPE;
     }
 
     collectionElementInstanciable((Collection)a, NULL, NULL);
@@ -73,11 +143,42 @@ Array arrayNew(int elemSize) {
     a->length = 0;
 
     a->size = DEFSIZE;
+    a->growth = EL_DEFGROWTH;
+    a->shrinkDivisor = EL_DEFSHRINK;
     a->ct = malloc(DEFSIZE * sizeof(Ptr));
 
     return a;
 }
 
+Array arrayNewFromRaw(int elemSize, Ptr rawData, int nbElements) {
+    Array a = arrayNew(elemSize);
+
+    if(a->needsAllocation) {
+        arrayPushMany(a, rawData, nbElements);
+        free(rawData);
+
+        return a;
+    }
+
+    free(a->ct);
+
+    a->length = nbElements;
+    a->size = nbElements > DEFSIZE ? nbElements : DEFSIZE;
+
+    if(a->size*sizeof(Ptr) > nbElements*a->elemSize)
+        rawData = realloc(rawData, a->size*sizeof(Ptr));
+
+    // From the last element, so that none is overwritten before being moved to its slot
+    if(a->elemSize < sizeof(Ptr)) {
+        for(int i=nbElements-1; i>0; i--)
+            memmove((Ptr *)rawData + i, rawData + i*a->elemSize, a->elemSize);
+    }
+
+    a->ct = rawData;
+
+    return a;
+}
+
 void arrayDel(Array a) {
     arrayClear(a);
 
@@ -87,6 +188,50 @@ void arrayDel(Array a) {
 
 
 
+Ptr *_arrayRelease(Array a, int *length, int *size) {
+    Ptr *ct = a->ct;
+
+    *length = a->length;
+    *size = a->size;
+
+    free(a);
+
+    return ct;
+}
+
+void _arrayAdopt(Array a, Ptr *ct, int length, int size) {
+    free(a->ct);
+
+    a->length = length;
+    a->size = size;
+    a->ct = ct;
+}
+
+void _arrayPushMove(Array a, const Ptr data) {
+    arrayGrow(a, a->length+1);
+
+    if(a->needsAllocation) {
+        a->ct[a->length] = malloc(a->elemSize);
+        memcpy(a->ct[a->length], data, a->elemSize);
+    }
+    else
+        memcpy(&a->ct[a->length], data, a->elemSize);
+
+    a->length++;
+}
+
+void _arrayForget(Array a) {
+    if(a->needsAllocation) {
+        for(int i=0; i<a->length; i++)
+            free(a->ct[i]);
+    }
+
+    free(a->ct);
+    free(a);
+}
+
+
+
 void arrayComparable(Array a, ElCmpFct fct) {
     a->cmpFct = fct;
 }
@@ -95,13 +240,24 @@ void arrayElementInstanciable(Array a, ElCopyFct copyFct, ElDelFct delFct) {
     collectionElementInstanciable((Collection)a, copyFct, delFct);
 }
 
+void arrayCapacityPolicy(Array a, float growthFactor, int shrinkDivisor) {
+    a->growth = growthFactor > 1 ? growthFactor : EL_DEFGROWTH;
+
+    // A shrunk array must be able to grow back without reaching the shrink threshold again
+    if(shrinkDivisor != EL_NEVER_SHRINK && shrinkDivisor <= a->growth)
+        shrinkDivisor = (int)a->growth + 1;
+
+    a->shrinkDivisor = shrinkDivisor;
+}
+
 
 
 Array arrayClone(const Array a) {
     return arraySubArray(a, 0, a->length);
 }
 
-Array arraySubArray(const Array a, int from, int to) {
+// Empty array with the element settings of a, and room for size elements
+static Array arrayNewLike(const Array a, int size) {
     Array a2 = malloc(sizeof(struct _Array));
 
     a2->type = ARRAY;
@@ -113,13 +269,23 @@ Array arraySubArray(const Array a, int from, int to) {
     a2->needsAllocation = a->needsAllocation;
     a2->ptrTransform = a->ptrTransform;
 
+    a2->elType = a->elType;
+
     a2->length = 0;
 
-    a2->size = a->length * 2;
+    a2->size = size;
     if(a2->size < DEFSIZE)
         a2->size = DEFSIZE;
+    a2->growth = a->growth;
+    a2->shrinkDivisor = a->shrinkDivisor;
     a2->ct = malloc(a2->size * sizeof(Ptr));
 
+    return a2;
+}
+
+Array arraySubArray(const Array a, int from, int to) {
+    Array a2 = arrayNewLike(a, a->length * 2);
+
     for(int i=from; i<to; i++)
         arrayPush_base(a2, a->ptrTransform(&a->ct[i]));
 
@@ -139,8 +305,11 @@ void arrayClear(Array a) {
     }
 
     a->length = 0;
-    a->size = DEFSIZE;
-    a->ct = realloc(a->ct, DEFSIZE * sizeof(Ptr));
+
+    if(a->shrinkDivisor != EL_NEVER_SHRINK) {
+        a->size = DEFSIZE;
+        a->ct = realloc(a->ct, DEFSIZE * sizeof(Ptr));
+    }
 }
 
 
@@ -169,6 +338,14 @@ bool arrayContains(const Array a, const Ptr data) {
 }
 
 int arrayIndexOf(const Array a, const Ptr data) {
+    KernelType t;
+
+    if(arrayKernelType(a, &t)) {
+        KernelNeedle n;
+        kernelNeedle(&t, data, true, &n);
+        return kernelIndexOf(&n, a->ct, a->length);
+    }
+
     for(int i=0; i<a->length; i++)
         if(a->cmpFct(a->ptrTransform(&a->ct[i]), data) == 0)
             return i;
@@ -177,6 +354,14 @@ int arrayIndexOf(const Array a, const Ptr data) {
 }
 
 int arrayLastIndexOf(const Array a, const Ptr data) {
+    KernelType t;
+
+    if(arrayKernelType(a, &t)) {
+        KernelNeedle n;
+        kernelNeedle(&t, data, true, &n);
+        return kernelLastIndexOf(&n, a->ct, a->length);
+    }
+
     for(int i=a->length-1; i>=0; i--)
         if(a->cmpFct(a->ptrTransform(&a->ct[i]), data) == 0)
             return i;
@@ -184,26 +369,132 @@ int arrayLastIndexOf(const Array a, const Ptr data) {
     return -1;
 }
 
-int arrayBSearch(const Array a, const Ptr data) {
-    int first = 0;
-    int last = a->length - 1;
-    int middle = (first + last) / 2;
-    int cmpVal;
-
-    while(first <= last) {
-        cmpVal = a->cmpFct(a->ptrTransform(&a->ct[middle]), data);
-
-        if(cmpVal < 0)
-            first = middle + 1;
-        else if(cmpVal == 0)
-            return middle;
-        else
-            last = middle - 1;
+int arrayCount(const Array a, const Ptr data) {
+    KernelType t;
+    int count = 0;
+
+    if(arrayKernelType(a, &t)) {
+        KernelNeedle n;
+        kernelNeedle(&t, data, true, &n);
+        return kernelCount(&n, a->ct, a->length);
+    }
+
+    for(int i=0; i<a->length; i++)
+        if(a->cmpFct(a->ptrTransform(&a->ct[i]), data) == 0)
+            count++;
+
+    return count;
+}
+
+static int arrayExtremum(const Array a, bool max) {
+    KernelType t;
+    int pos = 0;
+
+    if(a->length == 0)
+        return -1;
+
+    if(arrayKernelType(a, &t))
+        return kernelExtremum(&t, a->ct, a->length, max);
+
+    for(int i=1; i<a->length; i++) {
+        int cmp = a->cmpFct(a->ptrTransform(&a->ct[i]), a->ptrTransform(&a->ct[pos]));
+        if(max ? cmp > 0 : cmp < 0)
+            pos = i;
+    }
+
+    return pos;
+}
+
+int arrayMinIndex(const Array a) {
+    return arrayExtremum(a, false);
+}
+
+int arrayMaxIndex(const Array a) {
+    return arrayExtremum(a, true);
+}
+
+void arraySum_base(const Array a, Ptr dest) {
+    KernelType t;
+
+    if(a->elType == NOTYPE || a->elType == EL_POINTER || a->elType == EL_BOOL)
+        return;
+
+    if(!a->needsAllocation && kernelType(a->elType, &t)) {
+        kernelSum(&t, a->ct, a->length, dest);
+        return;
+    }
+
+    // Without kernels, and for long double which is too big to be inline
+    switch(a->elType) {
+        #define SUM(elType, type) case elType : { \
+            type sum = 0; \
+            for(int i=0; i<a->length; i++) \
+                sum += *(type *)a->ptrTransform(&a->ct[i]); \
+            *(type *)dest = sum; \
+            break; \
+        }
+        SUM(EL_CHAR, char)
+        SUM(EL_UCHAR, unsigned char)
+        SUM(EL_SHORT, short)
+        SUM(EL_USHORT, unsigned short)
+        SUM(EL_INT, unsigned int)
+        SUM(EL_UINT, unsigned int)
+        SUM(EL_LONG, unsigned long)
+        SUM(EL_ULONG, unsigned long)
+        SUM(EL_LONGLONG, unsigned long long)
+        SUM(EL_ULONGLONG, unsigned long long)
+        SUM(EL_FLOAT, float)
+        SUM(EL_DOUBLE, double)
+        SUM(EL_LONGDOUBLE, long double)
+        #undef SUM
+    }
+}
+
+// Bound of data in the sorted positions [from, to)
+static int arrayBound(const Array a, int from, int to, const Ptr data, bool upper) {
+    KernelType t;
+
+    if(arrayKernelType(a, &t))
+        return from + kernelLowerBound(&t, a->ct + from, to - from, data, upper);
+
+    // Same halving as the kernels, the comparison function being called once per step
+    Ptr *base = a->ct + from;
+    int n = to - from;
+
+    if(n == 0)
+        return from;
 
-        middle = (first + last) / 2;
+    while(n > 1) {
+        int half = n/2;
+        int cmp = a->cmpFct(a->ptrTransform(&base[half]), data);
+        base = (upper ? cmp <= 0 : cmp < 0) ? base + half : base;
+        n -= half;
     }
 
-    return -1; //if(first > last)
+    int cmp = a->cmpFct(a->ptrTransform(base), data);
+    return base - a->ct + (upper ? cmp <= 0 : cmp < 0);
+}
+
+int arrayBSearch(const Array a, const Ptr data) {
+    int pos = arrayBound(a, 0, a->length, data, false);
+
+    if(pos < a->length && a->cmpFct(a->ptrTransform(&a->ct[pos]), data) == 0)
+        return pos;
+
+    return -1;
+}
+
+int arrayLowerBound(const Array a, const Ptr data) {
+    return arrayBound(a, 0, a->length, data, false);
+}
+
+int arrayUpperBound(const Array a, const Ptr data) {
+    return arrayBound(a, 0, a->length, data, true);
+}
+
+void arrayEqualRange(const Array a, const Ptr data, int *from, int *to) {
+    *from = arrayBound(a, 0, a->length, data, false);
+    *to = arrayBound(a, *from, a->length, data, true);
 }
 
 
@@ -235,25 +526,36 @@ void arrayPush_base(Array a, const Ptr data) {
 }
 
 void arrayAdd_base(Array a, int pos, const Ptr data) {
-    if(a->length >= a->size) {
-        a->size *= 2;
-        a->ct = realloc(a->ct, a->size*sizeof(Ptr));
-    }
+    arrayGrow(a, a->length+1);
 
-    arrayShift(a, pos);
+    arrayShift(a, pos, 1);
 
-    if(a->needsAllocation) {
-        a->ct[pos] = malloc(a->elemSize);
+    arrayCopyIn(a, pos, data);
 
-        if(a->copyFct)
-            a->copyFct(a->ct[pos], data);
-        else
-            memcpy(a->ct[pos], data, a->elemSize);
+    a->length++;
+}
+
+void arrayPushMany(Array a, const Ptr data, int nbElements) {
+    arrayInsertRange(a, a->length, data, nbElements);
+}
+
+void arrayInsertRange(Array a, int pos, const Ptr data, int nbElements) {
+    if(nbElements <= 0)
+        return;
+
+    arrayGrow(a, a->length+nbElements);
+
+    arrayShift(a, pos, nbElements);
+
+    // Elements filling their whole slot are copied at once
+    if(!a->needsAllocation && a->elemSize == sizeof(Ptr))
+        memcpy(&a->ct[pos], data, nbElements*sizeof(Ptr));
+    else {
+        for(int i=0; i<nbElements; i++)
+            arrayCopyIn(a, pos+i, data + i*a->elemSize);
     }
-    else
-        memcpy(&a->ct[pos], data, a->elemSize);
 
-    a->length++;
+    a->length += nbElements;
 }
 
 
@@ -263,21 +565,48 @@ void arrayPop(Array a) {
 }
 
 void arrayRemove(Array a, int pos) {
-    if(a->needsAllocation) {
-        if(a->delFct)
-            a->delFct(a->ct[pos]);
+    arrayRemoveRange(a, pos, pos+1);
+}
 
-        free(a->ct[pos]);
+void arrayRemoveRange(Array a, int from, int to) {
+    if(from >= to)
+        return;
+
+    for(int i=from; i<to; i++)
+        arrayDelElt(a, i);
+
+    arrayUnshift(a, from, to-from);
+
+    a->length -= to-from;
+
+    arrayShrink(a);
+}
+
+
+
+void arrayReserve(Array a, int capacity) {
+    if(capacity > a->size) {
+        a->size = capacity;
+        a->ct = realloc(a->ct, a->size*sizeof(Ptr));
+    }
+}
+
+void arrayResize(Array a, int length) {
+    if(length < a->length) {
+        arrayRemoveRange(a, length, a->length);
+        return;
     }
 
-    arrayUnshift(a, pos);
+    arrayReserve(a, length);
 
-    a->length--;
+    for(int i=a->length; i<length; i++) {
+        if(a->needsAllocation)
+            a->ct[i] = calloc(1, a->elemSize);
+        else
+            a->ct[i] = NULL;
+    }
 
-    if ((a->length <= (a->size / 4)) && (a->size / 2 >= DEFSIZE)) {
-		a->size /= 2;
-		a->ct = realloc(a->ct, a->size * sizeof(Ptr));
-	}
+    a->length = length;
 }
 
 
@@ -285,7 +614,10 @@ void arrayRemove(Array a, int pos) {
 static void arraySortQS(Array a, int method, int p, int r) {
     if (p < r) {
 
-        Ptr pPtr = a->ptrTransform(&a->ct[p]);
+        // The pivot is copied out of the array : its slot moves during the partition.
+        // Taking the middle element keeps sorted inputs out of the quadratic case.
+        Ptr pivot = a->ct[p + (r-p)/2];
+        Ptr pPtr = a->ptrTransform(&pivot);
 
         int i = p-1, j = r+1;
 
@@ -343,6 +675,124 @@ void arrayDump(const Array a) {
 
 
 
+// Search index
+
+// Fills the subtree rooted at k with the sorted elements from pos, returns the position after them
+static int arrayIndexFill(ArrayIndex idx, int pos, int k) {
+    if(k > idx->length)
+        return pos;
+
+    Array a = idx->array;
+
+    pos = arrayIndexFill(idx, pos, 2*k);
+
+    if(!idx->kernel)
+        idx->keys[k] = (uintptr_t)a->ptrTransform(&a->ct[pos]);
+    else if(idx->t.kind == KERNEL_INT)
+        idx->keys[k] = kernelIntKey(&idx->t, kernelLoad(&a->ct[pos]));
+    else
+        idx->keys[k] = kernelLoad(&a->ct[pos]);
+
+    idx->positions[k] = pos;
+
+    return arrayIndexFill(idx, pos+1, 2*k+1);
+}
+
+ArrayIndex arrayIndexNew(const Array a) {
+    ArrayIndex idx = malloc(sizeof(struct _ArrayIndex));
+
+    idx->array = a;
+    idx->kernel = arrayKernelType(a, &idx->t);
+    idx->length = a->length;
+
+    // keys[0] is unused, so that the 8 grandchildren of the grandchildren of k share the line of keys[8k]
+    idx->buffer = malloc((a->length+1) * sizeof(uint64_t) + CACHELINE);
+    idx->keys = (uint64_t *)((char *)idx->buffer + (CACHELINE - (uintptr_t)idx->buffer % CACHELINE) % CACHELINE);
+    idx->positions = malloc((a->length+1) * sizeof(int));
+
+    arrayIndexFill(idx, 0, 1);
+
+    return idx;
+}
+
+void arrayIndexDel(ArrayIndex idx) {
+    free(idx->buffer);
+    free(idx->positions);
+    free(idx);
+}
+
+int arrayIndexLowerBound(const ArrayIndex idx, const Ptr data) {
+    const uint64_t *keys = idx->keys;
+    int n = idx->length;
+    int k = 1;
+
+    // Goes down the implicit tree, left when the key isn't lower than data. Lines 3 levels below are fetched ahead.
+    if(!idx->kernel) {
+        Array a = idx->array;
+        while(k <= n) {
+            __builtin_prefetch(keys + 8*k);
+            k = 2*k + (a->cmpFct((Ptr)(uintptr_t)keys[k], data) < 0);
+        }
+    }
+    else if(idx->t.kind == KERNEL_FLOAT) {
+        float x, e;
+        memcpy(&x, data, sizeof(float));
+        while(k <= n) {
+            __builtin_prefetch(keys + 8*k);
+            memcpy(&e, &keys[k], sizeof(float));
+            k = 2*k + (e < x);
+        }
+    }
+    else if(idx->t.kind == KERNEL_DOUBLE) {
+        double x, e;
+        memcpy(&x, data, sizeof(double));
+        while(k <= n) {
+            __builtin_prefetch(keys + 8*k);
+            memcpy(&e, &keys[k], sizeof(double));
+            k = 2*k + (e < x);
+        }
+    }
+    else {
+        uint64_t x = 0;
+        memcpy(&x, data, idx->t.bits/8);
+        x = kernelIntKey(&idx->t, x);
+        while(k <= n) {
+            __builtin_prefetch(keys + 8*k);
+            k = 2*k + (keys[k] < x);
+        }
+    }
+
+    // The last left turn led to the bound : drops the right turns taken after it
+    k >>= __builtin_ffs(~k);
+
+    return k ? idx->positions[k] : n;
+}
+
+int arrayIndexFind(const ArrayIndex idx, const Ptr data) {
+    Array a = idx->array;
+    int pos = arrayIndexLowerBound(idx, data);
+
+    if(pos < idx->length && a->cmpFct(a->ptrTransform(&a->ct[pos]), data) == 0)
+        return pos;
+
+    return -1;
+}
+
+void arrayIndexDump(const ArrayIndex idx) {
+    int elts = idx->length;
+    int effcost = elts*(sizeof(uint64_t) + sizeof(int));
+    int opcost = sizeof(struct _ArrayIndex) + sizeof(uint64_t) + sizeof(int) + CACHELINE;
+
+    printf("Array index at %p\n", idx);
+    printf("\t%d elements, each using %d bytes\n", elts, (int)(sizeof(uint64_t) + sizeof(int)));
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", 0);
+    printf("\t%d bytes total used\n", effcost+opcost);
+}
+
+
+
 // Iteration
 
 ArrayIt arrayItNew(const Array a) {
@@ -417,6 +867,462 @@ void arrayItRemove(ArrayIt *it) {
 
 
 void arrayForEach(Array a, ElActFct actFct, Ptr infos) {
+    if(a->needsAllocation) {
+        for(int i=0; i<a->length; i++)
+            actFct(a->ct[i], infos);
+    }
+    else {
+        for(int i=0; i<a->length; i++)
+            actFct(&a->ct[i], infos);
+    }
+}
+
+void arrayCopyToRaw(const Array a, Ptr dest) {
+    if(!a->needsAllocation && a->elemSize == sizeof(Ptr)) {
+        memcpy(dest, a->ct, a->length*sizeof(Ptr));
+        return;
+    }
+
     for(int i=0; i<a->length; i++)
-        actFct(a->ptrTransform(&a->ct[i]), infos);
+        memcpy(dest + i*a->elemSize, a->ptrTransform(&a->ct[i]), a->elemSize);
+}
+
+
+
+// Binary files
+
+bool arraySave(const Array a, const char *path) {
+    // Pointers mean nothing once loaded back by another process
+    if(a->copyFct || a->delFct || a->elType == EL_POINTER)
+        return false;
+
+    ArrayFileHeader header = {ARRAY_MAGIC, SERIAL_VERSION, a->elemSize, a->elType != NOTYPE ? a->elType : a->elemSize, a->length};
+    Ptr raw = malloc((size_t)a->length*a->elemSize + 1);
+
+    arrayCopyToRaw(a, raw);
+
+    FILE *file = fopen(path, "wb");
+    bool ok = file != NULL;
+
+    if(ok) {
+        ok = fwrite(&header, sizeof(ArrayFileHeader), 1, file) == 1
+            && fwrite(raw, a->elemSize, a->length, file) == a->length;
+
+        ok = fclose(file) == 0 && ok;
+    }
+
+    free(raw);
+
+    return ok;
+}
+
+Array arrayLoad(const char *path) {
+    ArrayFileHeader header;
+    FILE *file = fopen(path, "rb");
+
+    if(!file)
+        return NULL;
+
+    if(fread(&header, sizeof(ArrayFileHeader), 1, file) != 1 || header.magic != ARRAY_MAGIC || header.version != SERIAL_VERSION
+       || header.elemSize <= 0 || header.length > INT_MAX || header.elType == EL_POINTER
+       || (header.elType > 0 && header.elType != header.elemSize)
+       || (header.elType <= 0 && _elSizeFct(header.elType) != header.elemSize)) {
+        fclose(file);
+        return NULL;
+    }
+
+    // The elements must fit in the file, this also bounds the size to allocate
+    long fileSize = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+
+    if(fileSize < (long)sizeof(ArrayFileHeader) || header.length > (uint64_t)(fileSize - sizeof(ArrayFileHeader)) / header.elemSize
+       || fseek(file, sizeof(ArrayFileHeader), SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    Ptr raw = malloc((size_t)header.length*header.elemSize + 1);
+
+    if(!raw || fread(raw, header.elemSize, header.length, file) != header.length) {
+        free(raw);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+
+    return arrayNewFromRaw(header.elType, raw, header.length);
+}
+
+
+
+// Parallel algorithms
+
+#define PARALLELMIN 16384 // below this length, arrays are processed on the calling thread
+
+// Number of elements per chunk : a multiple of a cache line of slots, so that two chunks share at most the line at their boundary
+static int parallelGrain(const Array a, ThreadPool pool) {
+    if(a->length < PARALLELMIN || threadPoolSize(pool) == 1)
+        return a->length;
+
+    int slotsPerLine = CACHELINE / sizeof(Ptr);
+    int grain = a->length / (8*threadPoolSize(pool));
+
+    return (grain + slotsPerLine - 1) / slotsPerLine * slotsPerLine;
+}
+
+typedef struct {
+    Array a;
+    int method;
+    int chunkLength;
+    Ptr *src;
+    Ptr *dest;
+} ParallelSortData;
+
+static void parallelSortChunks(int from, int to, ParallelSortData *data) {
+    for(int c=from; c<to; c++) {
+        int start = c*data->chunkLength;
+        int end = start + data->chunkLength < data->a->length ? start + data->chunkLength : data->a->length;
+
+        if(start < end)
+            arraySortQS(data->a, data->method, start, end-1);
+    }
+}
+
+// Merges the sorted runs [2i*w, (2i+1)*w) and [(2i+1)*w, (2i+2)*w) of src into dest
+static void parallelSortMerge(int from, int to, ParallelSortData *data) {
+    Array a = data->a;
+    int w = data->chunkLength;
+
+    for(int pair=from; pair<to; pair++) {
+        int lo = 2*pair*w < a->length ? 2*pair*w : a->length;
+        int mid = lo+w < a->length ? lo+w : a->length;
+        int hi = mid+w < a->length ? mid+w : a->length;
+        int i=lo, j=mid, k=lo;
+
+        while(i<mid && j<hi) {
+            if(data->method*a->cmpFct(a->ptrTransform(&data->src[j]), a->ptrTransform(&data->src[i])) < 0)
+                data->dest[k++] = data->src[j++];
+            else
+                data->dest[k++] = data->src[i++];
+        }
+
+        memcpy(&data->dest[k], &data->src[i], (mid-i)*sizeof(Ptr));
+        k += mid-i;
+        memcpy(&data->dest[k], &data->src[j], (hi-j)*sizeof(Ptr));
+    }
+}
+
+void arrayParallelSort(Array a, int method, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    if(a->length < PARALLELMIN || threadPoolSize(pool) == 1) {
+        arraySort(a, method);
+        return;
+    }
+
+    // A power of 2 of chunks, so that the merge rounds pair them exactly
+    int nbChunks = 1;
+    while(nbChunks < 2*threadPoolSize(pool))
+        nbChunks *= 2;
+
+    ParallelSortData data = {a, method, (a->length + nbChunks - 1) / nbChunks, a->ct, NULL};
+
+    threadPoolParallelFor(pool, 0, nbChunks, 1, (ElRangeFct)parallelSortChunks, &data);
+
+    // Slots are merged, the elements themselves never move
+    Ptr *buf = malloc(a->size * sizeof(Ptr));
+    data.dest = buf;
+
+    for(; nbChunks > 1; nbChunks /= 2) {
+        threadPoolParallelFor(pool, 0, nbChunks/2, 1, (ElRangeFct)parallelSortMerge, &data);
+
+        Ptr *swap = data.src;
+        data.src = data.dest;
+        data.dest = swap;
+        data.chunkLength *= 2;
+    }
+
+    if(data.src != a->ct) {
+        free(a->ct);
+        a->ct = data.src;
+    }
+    else
+        free(buf);
+}
+
+
+
+typedef struct {
+    Array a;
+    Ptr data;
+    int found; // lowest position found so far
+} ParallelIndexOfData;
+
+static void parallelIndexOf(int from, int to, ParallelIndexOfData *data) {
+    Array a = data->a;
+
+    // Chunks after an already found position are useless
+    if(from > __atomic_load_n(&data->found, __ATOMIC_RELAXED))
+        return;
+
+    KernelType t;
+    int pos = -1;
+
+    if(arrayKernelType(a, &t)) {
+        KernelNeedle n;
+        kernelNeedle(&t, data->data, true, &n);
+        pos = kernelIndexOf(&n, a->ct + from, to - from);
+        if(pos != -1)
+            pos += from;
+    }
+    else {
+        for(int i=from; i<to && pos == -1; i++)
+            if(a->cmpFct(a->ptrTransform(&a->ct[i]), data->data) == 0)
+                pos = i;
+    }
+
+    if(pos != -1) {
+        int found = __atomic_load_n(&data->found, __ATOMIC_RELAXED);
+
+        while(pos < found && !__atomic_compare_exchange_n(&data->found, &found, pos, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+}
+
+int arrayParallelIndexOf(const Array a, const Ptr data, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    if(a->length < PARALLELMIN || threadPoolSize(pool) == 1)
+        return arrayIndexOf(a, data);
+
+    ParallelIndexOfData indexOfData = {a, data, a->length};
+
+    threadPoolParallelFor(pool, 0, a->length, 0, (ElRangeFct)parallelIndexOf, &indexOfData);
+
+    return indexOfData.found == a->length ? -1 : indexOfData.found;
+}
+
+
+
+typedef struct {
+    Array src;
+    Array dest;
+    ElPredFct predFct;
+    Ptr infos;
+    int chunkLength;
+    bool *keep;
+    int *offsets; // number of kept elements per chunk, then position of the first one in dest
+} ParallelFilterData;
+
+static void parallelFilterTest(int from, int to, ParallelFilterData *data) {
+    Array a = data->src;
+
+    for(int c=from; c<to; c++) {
+        int start = c*data->chunkLength;
+        int end = start + data->chunkLength < a->length ? start + data->chunkLength : a->length;
+        int count = 0;
+
+        for(int i=start; i<end; i++) {
+            data->keep[i] = data->predFct(a->ptrTransform(&a->ct[i]), data->infos);
+            count += data->keep[i];
+        }
+
+        data->offsets[c] = count;
+    }
+}
+
+static void parallelFilterCopy(int from, int to, ParallelFilterData *data) {
+    Array a = data->src;
+    Array dest = data->dest;
+
+    for(int c=from; c<to; c++) {
+        int start = c*data->chunkLength;
+        int end = start + data->chunkLength < a->length ? start + data->chunkLength : a->length;
+        int pos = data->offsets[c];
+
+        for(int i=start; i<end; i++) {
+            if(!data->keep[i])
+                continue;
+
+            if(dest->needsAllocation) {
+                dest->ct[pos] = malloc(dest->elemSize);
+
+                if(dest->copyFct)
+                    dest->copyFct(dest->ct[pos], a->ct[i]);
+                else
+                    memcpy(dest->ct[pos], a->ct[i], dest->elemSize);
+            }
+            else
+                dest->ct[pos] = a->ct[i];
+
+            pos++;
+        }
+    }
+}
+
+Array arrayParallelFilter(const Array a, ElPredFct predFct, Ptr infos, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    int nbChunks = a->length < PARALLELMIN ? 1 : 8*threadPoolSize(pool);
+
+    ParallelFilterData data;
+    data.src = a;
+    data.predFct = predFct;
+    data.infos = infos;
+    data.chunkLength = (a->length + nbChunks - 1) / nbChunks;
+    data.keep = malloc(a->length * sizeof(bool));
+    data.offsets = malloc(nbChunks * sizeof(int));
+
+    threadPoolParallelFor(pool, 0, nbChunks, 1, (ElRangeFct)parallelFilterTest, &data);
+
+    // Exclusive prefix sum : the elements kept by each chunk have a fixed place in dest
+    int total = 0;
+    for(int c=0; c<nbChunks; c++) {
+        int count = data.offsets[c];
+        data.offsets[c] = total;
+        total += count;
+    }
+
+    Array dest = arrayNewLike(a, total);
+    data.dest = dest;
+
+    threadPoolParallelFor(pool, 0, nbChunks, 1, (ElRangeFct)parallelFilterCopy, &data);
+
+    dest->length = total;
+
+    free(data.keep);
+    free(data.offsets);
+
+    return dest;
+}
+
+
+
+typedef struct {
+    Array a;
+    ElActFct actFct;
+    Ptr infos;
+} ParallelForEachData;
+
+static void parallelForEach(int from, int to, ParallelForEachData *data) {
+    Array a = data->a;
+
+    if(a->needsAllocation) {
+        for(int i=from; i<to; i++)
+            data->actFct(a->ct[i], data->infos);
+    }
+    else {
+        for(int i=from; i<to; i++)
+            data->actFct(&a->ct[i], data->infos);
+    }
+}
+
+void arrayParallelForEach(Array a, ElActFct actFct, Ptr infos, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    ParallelForEachData data = {a, actFct, infos};
+
+    threadPoolParallelFor(pool, 0, a->length, parallelGrain(a, pool), (ElRangeFct)parallelForEach, &data);
+}
+
+
+
+typedef struct {
+    Array src;
+    Array dest;
+    ElMapFct mapFct;
+    Ptr infos;
+} ParallelMapData;
+
+static void parallelMap(int from, int to, ParallelMapData *data) {
+    Array a = data->src;
+    Array dest = data->dest;
+
+    for(int i=from; i<to; i++) {
+        if(dest->needsAllocation)
+            dest->ct[i] = malloc(dest->elemSize);
+
+        data->mapFct(dest->ptrTransform(&dest->ct[i]), a->ptrTransform(&a->ct[i]), data->infos);
+    }
+}
+
+Array arrayMap(const Array a, int elemSize, ElMapFct mapFct, Ptr infos, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    Array dest = arrayNew(elemSize);
+    arrayReserve(dest, a->length);
+
+    ParallelMapData data = {a, dest, mapFct, infos};
+
+    threadPoolParallelFor(pool, 0, a->length, parallelGrain(a, pool), (ElRangeFct)parallelMap, &data);
+
+    dest->length = a->length;
+
+    return dest;
+}
+
+
+
+typedef struct {
+    Array a;
+    ElReduceFct reduceFct;
+    Ptr infos;
+    int grain;
+    int stride;
+    char *partials; // one accumulator per chunk, each on its own cache lines
+} ParallelReduceData;
+
+static void parallelReduce(int from, int to, ParallelReduceData *data) {
+    Array a = data->a;
+    Ptr acc = data->partials + (from / data->grain) * data->stride;
+
+    if(a->needsAllocation) {
+        for(int i=from; i<to; i++)
+            data->reduceFct(acc, a->ct[i], data->infos);
+    }
+    else {
+        for(int i=from; i<to; i++)
+            data->reduceFct(acc, &a->ct[i], data->infos);
+    }
+}
+
+void arrayReduce(const Array a, Ptr acc, int accSize, ElReduceFct reduceFct, ElCombineFct combineFct, Ptr infos, ThreadPool pool) {
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    if(accSize <= 0)
+        accSize = _elSizeFct(accSize);
+
+    ParallelReduceData data = {a, reduceFct, infos, parallelGrain(a, pool), 0, NULL};
+
+    // A single chunk is accumulated directly in acc
+    if(data.grain >= a->length) {
+        data.grain = 1;
+        data.stride = 0;
+        data.partials = acc;
+        parallelReduce(0, a->length, &data);
+        return;
+    }
+
+    int nbChunks = (a->length + data.grain - 1) / data.grain;
+    data.stride = (accSize + CACHELINE - 1) / CACHELINE * CACHELINE;
+
+    char *buf = malloc(nbChunks * data.stride + CACHELINE);
+    data.partials = buf + (CACHELINE - (size_t)buf % CACHELINE) % CACHELINE;
+
+    // Every partial starts from the initial value, which is why it must be neutral
+    for(int c=0; c<nbChunks; c++)
+        memcpy(data.partials + c*data.stride, acc, accSize);
+
+    threadPoolParallelFor(pool, 0, a->length, data.grain, (ElRangeFct)parallelReduce, &data);
+
+    // Combined in the order of the chunks : combineFct only needs to be associative
+    for(int c=0; c<nbChunks; c++)
+        combineFct(acc, data.partials + c*data.stride);
+
+    free(buf);
 }
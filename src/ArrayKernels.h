@@ -0,0 +1,581 @@
+/**
+ * \file ArrayKernels.h
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Vectorized search and reduction kernels over the slots of arrays of EL_* types.
+ * Such elements are stored inline, in the low bytes of 64-bit slots : the kernels load several slots at once and ignore the high bytes.
+ * AVX2 or SSE2 is used when the compiler targets it, plain C otherwise (or when EXTLIB_NO_SIMD is defined).
+ * Private header, only included by Array.c.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_ARRAYKERNELS_H
+#define EXTLIB_ARRAYKERNELS_H
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#if UINTPTR_MAX == UINT64_MAX && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define KERNELS 1
+#else
+#define KERNELS 0
+#endif
+
+#if defined(__AVX2__) && !defined(EXTLIB_NO_SIMD)
+#include <immintrin.h>
+#define KERNEL_WIDTH 4
+#elif defined(__SSE2__) && !defined(EXTLIB_NO_SIMD)
+#include <emmintrin.h>
+#define KERNEL_WIDTH 2
+#else
+#define KERNEL_WIDTH 1
+#endif
+
+#define KERNEL_INT    0
+#define KERNEL_FLOAT  1
+#define KERNEL_DOUBLE 2
+
+// How the elements are read from their slot
+typedef struct {
+    int kind;       // KERNEL_INT, KERNEL_FLOAT or KERNEL_DOUBLE
+    int bits;       // width of the integer elements
+    bool isSigned;
+    uint64_t mask;  // bits of the slot holding an integer element
+} KernelType;
+
+// Element searched for by the kernels
+typedef struct {
+    int kind;
+    uint64_t mask;
+    uint64_t bits;  // integer element, masked
+    float f;
+    double d;
+    bool unordered; // floating elements unordered with the needle (NaN) match too, like with the default comparison functions
+} KernelNeedle;
+
+
+
+// Returns false if the type can't be handled by the kernels
+static inline bool kernelType(int elType, KernelType *t) {
+    t->kind = KERNEL_INT;
+    t->isSigned = false;
+
+    switch(elType) {
+        case EL_POINTER   : t->bits = 64; break;
+        case EL_CHAR      : t->bits = 8; t->isSigned = CHAR_MIN < 0; break;
+        case EL_UCHAR     : t->bits = 8; break;
+        case EL_SHORT     : t->bits = 16; t->isSigned = true; break;
+        case EL_USHORT    : t->bits = 16; break;
+        case EL_INT       : t->bits = 32; t->isSigned = true; break;
+        case EL_UINT      : t->bits = 32; break;
+        case EL_LONG      : t->bits = 8*sizeof(long); t->isSigned = true; break;
+        case EL_ULONG     : t->bits = 8*sizeof(long); break;
+        case EL_LONGLONG  : t->bits = 64; t->isSigned = true; break;
+        case EL_ULONGLONG : t->bits = 64; break;
+        case EL_BOOL      : t->bits = 8*sizeof(bool); break;
+        case EL_FLOAT     : t->kind = KERNEL_FLOAT; t->bits = 32; break;
+        case EL_DOUBLE    : t->kind = KERNEL_DOUBLE; t->bits = 64; break;
+        default           : return false;
+    }
+
+    t->mask = t->bits == 64 ? UINT64_MAX : ((uint64_t)1 << t->bits) - 1;
+
+    return KERNELS;
+}
+
+static inline void kernelNeedle(const KernelType *t, const void *data, bool unordered, KernelNeedle *n) {
+    n->kind = t->kind;
+    n->mask = t->mask;
+    n->bits = 0;
+    n->unordered = unordered;
+
+    if(t->kind == KERNEL_FLOAT)
+        memcpy(&n->f, data, sizeof(float));
+    else if(t->kind == KERNEL_DOUBLE)
+        memcpy(&n->d, data, sizeof(double));
+    else
+        memcpy(&n->bits, data, t->bits/8);
+}
+
+static inline uint64_t kernelLoad(const Ptr *slot) {
+    uint64_t v;
+    memcpy(&v, slot, sizeof(v));
+    return v;
+}
+
+
+
+// Tells whether the element of a slot matches
+static inline bool kernelMatchOne(const KernelNeedle *n, const Ptr *slot) {
+    if(n->kind == KERNEL_FLOAT) {
+        float x;
+        memcpy(&x, slot, sizeof(float));
+        return x == n->f || (n->unordered && (x != x || n->f != n->f));
+    }
+
+    if(n->kind == KERNEL_DOUBLE) {
+        double x;
+        memcpy(&x, slot, sizeof(double));
+        return x == n->d || (n->unordered && (x != x || n->d != n->d));
+    }
+
+    return (kernelLoad(slot) & n->mask) == n->bits;
+}
+
+// Returns a bit per slot of the KERNEL_WIDTH slots starting at ct, set if its element matches
+static inline unsigned kernelMatch(const KernelNeedle *n, const Ptr *ct) {
+#if KERNEL_WIDTH == 4
+    if(n->kind == KERNEL_FLOAT) {
+        __m256 v = _mm256_loadu_ps((const float *)ct);
+        __m256 m = n->unordered ? _mm256_cmp_ps(v, _mm256_set1_ps(n->f), _CMP_EQ_UQ) : _mm256_cmp_ps(v, _mm256_set1_ps(n->f), _CMP_EQ_OQ);
+        // The element is the low half of the slot, its result is moved to the sign bit of the slot
+        return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castps_si256(m), 32)));
+    }
+
+    if(n->kind == KERNEL_DOUBLE) {
+        __m256d v = _mm256_loadu_pd((const double *)ct);
+        __m256d m = n->unordered ? _mm256_cmp_pd(v, _mm256_set1_pd(n->d), _CMP_EQ_UQ) : _mm256_cmp_pd(v, _mm256_set1_pd(n->d), _CMP_EQ_OQ);
+        return _mm256_movemask_pd(m);
+    }
+
+    __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)ct), _mm256_set1_epi64x(n->mask));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, _mm256_set1_epi64x(n->bits))));
+#elif KERNEL_WIDTH == 2
+    if(n->kind == KERNEL_FLOAT) {
+        __m128 v = _mm_loadu_ps((const float *)ct);
+        __m128 m = _mm_cmpeq_ps(v, _mm_set1_ps(n->f));
+        if(n->unordered)
+            m = _mm_or_ps(m, _mm_cmpunord_ps(v, _mm_set1_ps(n->f)));
+        return _mm_movemask_pd(_mm_castsi128_pd(_mm_slli_epi64(_mm_castps_si128(m), 32)));
+    }
+
+    if(n->kind == KERNEL_DOUBLE) {
+        __m128d v = _mm_loadu_pd((const double *)ct);
+        __m128d m = _mm_cmpeq_pd(v, _mm_set1_pd(n->d));
+        if(n->unordered)
+            m = _mm_or_pd(m, _mm_cmpunord_pd(v, _mm_set1_pd(n->d)));
+        return _mm_movemask_pd(m);
+    }
+
+    // No 64-bit comparison in SSE2 : both 32-bit halves must be equal
+    __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *)ct), _mm_set1_epi64x(n->mask));
+    __m128i eq = _mm_cmpeq_epi32(v, _mm_set1_epi64x(n->bits));
+    eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(eq));
+#else
+    return kernelMatchOne(n, ct);
+#endif
+}
+
+
+
+static inline int kernelIndexOf(const KernelNeedle *n, const Ptr *ct, int length) {
+    int i = 0;
+
+    for(; i + KERNEL_WIDTH <= length; i += KERNEL_WIDTH) {
+        unsigned m = kernelMatch(n, ct + i);
+        if(m)
+            return i + __builtin_ctz(m);
+    }
+
+    for(; i<length; i++)
+        if(kernelMatchOne(n, ct + i))
+            return i;
+
+    return -1;
+}
+
+static inline int kernelLastIndexOf(const KernelNeedle *n, const Ptr *ct, int length) {
+    int i = length;
+
+    while(i % KERNEL_WIDTH) {
+        i--;
+        if(kernelMatchOne(n, ct + i))
+            return i;
+    }
+
+    while(i > 0) {
+        i -= KERNEL_WIDTH;
+        unsigned m = kernelMatch(n, ct + i);
+        if(m)
+            return i + 31 - __builtin_clz(m);
+    }
+
+    return -1;
+}
+
+static inline int kernelCount(const KernelNeedle *n, const Ptr *ct, int length) {
+    int count = 0;
+    int i = 0;
+
+    for(; i + KERNEL_WIDTH <= length; i += KERNEL_WIDTH)
+        count += __builtin_popcount(kernelMatch(n, ct + i));
+
+    for(; i<length; i++)
+        count += kernelMatchOne(n, ct + i);
+
+    return count;
+}
+
+
+
+// Sum of the slots, in the type of the elements : integers are added modulo 2^64 (the high bytes of the slots only reach the high bytes of the sum), floating elements in the order of the lanes
+static inline void kernelSum(const KernelType *t, const Ptr *ct, int length, void *dest) {
+    int i = 0;
+
+    if(t->kind == KERNEL_FLOAT) {
+        float lanes[2*KERNEL_WIDTH] = {0};
+#if KERNEL_WIDTH == 4
+        __m256 acc = _mm256_setzero_ps();
+        for(; i + 4 <= length; i += 4)
+            acc = _mm256_add_ps(acc, _mm256_loadu_ps((const float *)(ct + i)));
+        _mm256_storeu_ps(lanes, acc);
+#elif KERNEL_WIDTH == 2
+        __m128 acc = _mm_setzero_ps();
+        for(; i + 2 <= length; i += 2)
+            acc = _mm_add_ps(acc, _mm_loadu_ps((const float *)(ct + i)));
+        _mm_storeu_ps(lanes, acc);
+#endif
+        float sum = 0;
+        for(int l=0; l<2*KERNEL_WIDTH; l+=2)
+            sum += lanes[l];
+        for(; i<length; i++) {
+            float x;
+            memcpy(&x, ct + i, sizeof(float));
+            sum += x;
+        }
+        memcpy(dest, &sum, sizeof(float));
+    }
+    else if(t->kind == KERNEL_DOUBLE) {
+        double lanes[KERNEL_WIDTH] = {0};
+#if KERNEL_WIDTH == 4
+        __m256d acc = _mm256_setzero_pd();
+        for(; i + 4 <= length; i += 4)
+            acc = _mm256_add_pd(acc, _mm256_loadu_pd((const double *)(ct + i)));
+        _mm256_storeu_pd(lanes, acc);
+#elif KERNEL_WIDTH == 2
+        __m128d acc = _mm_setzero_pd();
+        for(; i + 2 <= length; i += 2)
+            acc = _mm_add_pd(acc, _mm_loadu_pd((const double *)(ct + i)));
+        _mm_storeu_pd(lanes, acc);
+#endif
+        double sum = 0;
+        for(int l=0; l<KERNEL_WIDTH; l++)
+            sum += lanes[l];
+        for(; i<length; i++) {
+            double x;
+            memcpy(&x, ct + i, sizeof(double));
+            sum += x;
+        }
+        memcpy(dest, &sum, sizeof(double));
+    }
+    else {
+        uint64_t lanes[KERNEL_WIDTH] = {0};
+#if KERNEL_WIDTH == 4
+        __m256i acc = _mm256_setzero_si256();
+        for(; i + 4 <= length; i += 4)
+            acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i *)(ct + i)));
+        _mm256_storeu_si256((__m256i *)lanes, acc);
+#elif KERNEL_WIDTH == 2
+        __m128i acc = _mm_setzero_si128();
+        for(; i + 2 <= length; i += 2)
+            acc = _mm_add_epi64(acc, _mm_loadu_si128((const __m128i *)(ct + i)));
+        _mm_storeu_si128((__m128i *)lanes, acc);
+#endif
+        uint64_t sum = 0;
+        for(int l=0; l<KERNEL_WIDTH; l++)
+            sum += lanes[l];
+        for(; i<length; i++)
+            sum += kernelLoad(ct + i);
+        memcpy(dest, &sum, t->bits/8);
+    }
+}
+
+
+
+// Integer element of a slot, extended to 64 bits so that it compares like the element as a signed or unsigned number
+static inline uint64_t kernelIntValue(const KernelType *t, uint64_t slot) {
+    if(t->isSigned)
+        return (uint64_t)((int64_t)(slot << (64 - t->bits)) >> (64 - t->bits));
+    return slot & t->mask;
+}
+
+static inline bool kernelIntBetter(const KernelType *t, uint64_t x, uint64_t best, bool max) {
+    if(t->isSigned)
+        return max ? (int64_t)x > (int64_t)best : (int64_t)x < (int64_t)best;
+    return max ? x > best : x < best;
+}
+
+static inline int kernelIntExtremumScalar(const KernelType *t, const Ptr *ct, int length, bool max) {
+    int pos = 0;
+    uint64_t best = kernelIntValue(t, kernelLoad(ct));
+
+    for(int i=1; i<length; i++) {
+        uint64_t x = kernelIntValue(t, kernelLoad(ct + i));
+        if(kernelIntBetter(t, x, best, max)) {
+            best = x;
+            pos = i;
+        }
+    }
+
+    return pos;
+}
+
+#if KERNEL_WIDTH > 1
+// Elements of 32 bits or less are shifted to the top of the low half of their slot and compared as signed 32-bit integers
+static inline int kernelInt32Extremum(const KernelType *t, const Ptr *ct, int length, bool max) {
+    int shift = 32 - t->bits;
+    int32_t flip = t->isSigned ? 0 : INT32_MIN;
+    int32_t lanes[2*KERNEL_WIDTH];
+    int i = 0;
+
+    uint32_t first = (uint32_t)kernelLoad(ct);
+    int32_t best = (int32_t)((first << shift) ^ flip);
+
+#if KERNEL_WIDTH == 4
+    __m128i count = _mm_cvtsi32_si128(shift);
+    __m256i vflip = _mm256_set1_epi32(flip);
+    __m256i acc = _mm256_set1_epi32(best);
+
+    for(; i + 4 <= length; i += 4) {
+        __m256i k = _mm256_xor_si256(_mm256_sll_epi32(_mm256_loadu_si256((const __m256i *)(ct + i)), count), vflip);
+        acc = max ? _mm256_max_epi32(acc, k) : _mm256_min_epi32(acc, k);
+    }
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+#else
+    __m128i count = _mm_cvtsi32_si128(shift);
+    __m128i vflip = _mm_set1_epi32(flip);
+    __m128i acc = _mm_set1_epi32(best);
+
+    for(; i + 2 <= length; i += 2) {
+        __m128i k = _mm_xor_si128(_mm_sll_epi32(_mm_loadu_si128((const __m128i *)(ct + i)), count), vflip);
+        __m128i better = max ? _mm_cmpgt_epi32(k, acc) : _mm_cmpgt_epi32(acc, k);
+        acc = _mm_or_si128(_mm_and_si128(better, k), _mm_andnot_si128(better, acc));
+    }
+    _mm_storeu_si128((__m128i *)lanes, acc);
+#endif
+
+    // Odd lanes hold the high bytes of the slots
+    for(int l=0; l<2*KERNEL_WIDTH; l+=2)
+        if(max ? lanes[l] > best : lanes[l] < best)
+            best = lanes[l];
+
+    for(; i<length; i++) {
+        int32_t k = (int32_t)(((uint32_t)kernelLoad(ct + i) << shift) ^ flip);
+        if(max ? k > best : k < best)
+            best = k;
+    }
+
+    // Back to the element, then to its first position
+    uint32_t key = (uint32_t)best ^ flip;
+    uint64_t value = t->isSigned ? (uint64_t)(uint32_t)((int32_t)key >> shift) : key >> shift;
+
+    KernelNeedle n = {KERNEL_INT, t->mask, value & t->mask, 0, 0, false};
+    return kernelIndexOf(&n, ct, length);
+}
+#endif
+
+#if KERNEL_WIDTH == 4
+static inline int kernelInt64Extremum(const KernelType *t, const Ptr *ct, int length, bool max) {
+    __m256i vflip = _mm256_set1_epi64x(t->isSigned ? 0 : INT64_MIN);
+    int64_t lanes[4];
+    int i = 0;
+
+    int64_t best = (int64_t)(kernelLoad(ct) ^ (t->isSigned ? 0 : INT64_MIN));
+    __m256i acc = _mm256_set1_epi64x(best);
+
+    for(; i + 4 <= length; i += 4) {
+        __m256i k = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(ct + i)), vflip);
+        __m256i better = max ? _mm256_cmpgt_epi64(k, acc) : _mm256_cmpgt_epi64(acc, k);
+        acc = _mm256_blendv_epi8(acc, k, better);
+    }
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+
+    for(int l=0; l<4; l++)
+        if(max ? lanes[l] > best : lanes[l] < best)
+            best = lanes[l];
+
+    uint64_t value = (uint64_t)best ^ (t->isSigned ? 0 : INT64_MIN);
+    int pos = -1;
+
+    for(; i<length; i++) {
+        uint64_t x = kernelLoad(ct + i);
+        if(kernelIntBetter(t, x, value, max)) {
+            value = x;
+            pos = i;
+        }
+    }
+
+    if(pos != -1)
+        return pos;
+
+    KernelNeedle n = {KERNEL_INT, t->mask, value, 0, 0, false};
+    return kernelIndexOf(&n, ct, length);
+}
+#endif
+
+// Floating elements follow the default comparison functions : NaN is never better than another element, but stays the best if it is the first element
+static inline int kernelFloatExtremum(const KernelType *t, const Ptr *ct, int length, bool max) {
+    KernelNeedle n = {t->kind, 0, 0, 0, 0, false};
+    int i = 0;
+
+    if(t->kind == KERNEL_FLOAT) {
+        float best;
+        memcpy(&best, ct, sizeof(float));
+        if(best != best)
+            return 0;
+
+        float lanes[2*KERNEL_WIDTH];
+#if KERNEL_WIDTH == 4
+        __m256 acc = _mm256_set1_ps(best);
+        // With a NaN operand, the second one is returned : acc never becomes NaN
+        for(; i + 4 <= length; i += 4) {
+            __m256 x = _mm256_loadu_ps((const float *)(ct + i));
+            acc = max ? _mm256_max_ps(x, acc) : _mm256_min_ps(x, acc);
+        }
+        _mm256_storeu_ps(lanes, acc);
+#elif KERNEL_WIDTH == 2
+        __m128 acc = _mm_set1_ps(best);
+        for(; i + 2 <= length; i += 2) {
+            __m128 x = _mm_loadu_ps((const float *)(ct + i));
+            acc = max ? _mm_max_ps(x, acc) : _mm_min_ps(x, acc);
+        }
+        _mm_storeu_ps(lanes, acc);
+#endif
+        for(int l=0; l<2*KERNEL_WIDTH && KERNEL_WIDTH > 1; l+=2)
+            if(max ? lanes[l] > best : lanes[l] < best)
+                best = lanes[l];
+
+        for(; i<length; i++) {
+            float x;
+            memcpy(&x, ct + i, sizeof(float));
+            if(max ? x > best : x < best)
+                best = x;
+        }
+
+        n.f = best;
+    }
+    else {
+        double best;
+        memcpy(&best, ct, sizeof(double));
+        if(best != best)
+            return 0;
+
+        double lanes[KERNEL_WIDTH];
+#if KERNEL_WIDTH == 4
+        __m256d acc = _mm256_set1_pd(best);
+        for(; i + 4 <= length; i += 4) {
+            __m256d x = _mm256_loadu_pd((const double *)(ct + i));
+            acc = max ? _mm256_max_pd(x, acc) : _mm256_min_pd(x, acc);
+        }
+        _mm256_storeu_pd(lanes, acc);
+#elif KERNEL_WIDTH == 2
+        __m128d acc = _mm_set1_pd(best);
+        for(; i + 2 <= length; i += 2) {
+            __m128d x = _mm_loadu_pd((const double *)(ct + i));
+            acc = max ? _mm_max_pd(x, acc) : _mm_min_pd(x, acc);
+        }
+        _mm_storeu_pd(lanes, acc);
+#endif
+        for(int l=0; l<KERNEL_WIDTH && KERNEL_WIDTH > 1; l++)
+            if(max ? lanes[l] > best : lanes[l] < best)
+                best = lanes[l];
+
+        for(; i<length; i++) {
+            double x;
+            memcpy(&x, ct + i, sizeof(double));
+            if(max ? x > best : x < best)
+                best = x;
+        }
+
+        n.d = best;
+    }
+
+    // 0.0 and -0.0 are equal : the first of them is found, like a sequential search would
+    return kernelIndexOf(&n, ct, length);
+}
+
+// Position of the first smallest or greatest element, length must be > 0
+static inline int kernelExtremum(const KernelType *t, const Ptr *ct, int length, bool max) {
+    if(t->kind != KERNEL_INT)
+        return kernelFloatExtremum(t, ct, length, max);
+
+#if KERNEL_WIDTH > 1
+    if(t->bits <= 32)
+        return kernelInt32Extremum(t, ct, length, max);
+#endif
+#if KERNEL_WIDTH == 4
+    return kernelInt64Extremum(t, ct, length, max);
+#else
+    return kernelIntExtremumScalar(t, ct, length, max);
+#endif
+}
+
+
+
+
+// Integer element of a slot, mapped to an unsigned key with the same order
+static inline uint64_t kernelIntKey(const KernelType *t, uint64_t slot) {
+    uint64_t v = kernelIntValue(t, slot);
+    return t->isSigned ? v ^ ((uint64_t)1 << 63) : v;
+}
+
+// Position of the first element not lower (or, if upper, greater) than data in ascending slots.
+// The range is halved with conditional moves instead of branches, and both possible next middles are prefetched.
+static inline int kernelLowerBound(const KernelType *t, const Ptr *ct, int length, const void *data, bool upper) {
+    const Ptr *base = ct;
+    int n = length;
+
+    if(n == 0)
+        return 0;
+
+    if(t->kind == KERNEL_FLOAT) {
+        float x, e;
+        memcpy(&x, data, sizeof(float));
+        while(n > 1) {
+            int half = n/2;
+            __builtin_prefetch(base + half/2);
+            __builtin_prefetch(base + half + half/2);
+            memcpy(&e, base + half, sizeof(float));
+            base = (upper ? e <= x : e < x) ? base + half : base;
+            n -= half;
+        }
+        memcpy(&e, base, sizeof(float));
+        return base - ct + (upper ? e <= x : e < x);
+    }
+
+    if(t->kind == KERNEL_DOUBLE) {
+        double x, e;
+        memcpy(&x, data, sizeof(double));
+        while(n > 1) {
+            int half = n/2;
+            __builtin_prefetch(base + half/2);
+            __builtin_prefetch(base + half + half/2);
+            memcpy(&e, base + half, sizeof(double));
+            base = (upper ? e <= x : e < x) ? base + half : base;
+            n -= half;
+        }
+        memcpy(&e, base, sizeof(double));
+        return base - ct + (upper ? e <= x : e < x);
+    }
+
+    uint64_t x = 0, e;
+    memcpy(&x, data, t->bits/8);
+    x = kernelIntKey(t, x);
+    while(n > 1) {
+        int half = n/2;
+        __builtin_prefetch(base + half/2);
+        __builtin_prefetch(base + half + half/2);
+        e = kernelIntKey(t, kernelLoad(base + half));
+        base = (upper ? e <= x : e < x) ? base + half : base;
+        n -= half;
+    }
+    e = kernelIntKey(t, kernelLoad(base));
+    return base - ct + (upper ? e <= x : e < x);
+}
+
+#endif
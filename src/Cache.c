@@ -0,0 +1,790 @@
+/**
+ * \file Cache.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ * W-TinyLFU follows the design of Einziger, Friedman and Manes, as used by Caffeine : a 1% LRU window in front of a
+ * segmented LRU, with admission decided by a count-min sketch of 4 bits counters which are halved periodically.
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Cache.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NONE      UINT32_MAX
+#define CACHELINE 64
+
+// Lists of entries. LRU only uses WINDOW, CLOCK uses none
+#define WINDOW    0
+#define PROBATION 1
+#define PROTECTED 2
+#define FREE      3
+
+typedef struct {
+    uint64_t hash;       // mixed hash of the key
+    uint32_t next;       // next entry of the bucket, or of the free list
+    uint32_t prev;       // neighbour in the list, towards the most recently used
+    uint32_t after;      // neighbour in the list, towards the least recently used
+    uint8_t list;        // WINDOW, PROBATION, PROTECTED or FREE
+    uint8_t ref;         // CLOCK : used since the hand last passed
+} CacheEntry;
+
+typedef struct {
+    uint32_t head;       // most recently used
+    uint32_t tail;       // least recently used
+    int length;
+} CacheList;
+
+struct _Cache {
+    int keySize;
+    ElCmpFct cmpFct;
+    ElHashFct hashFct;
+    ElCopyFct keyCopyFct;
+    ElDelFct keyDelFct;
+    bool bitwise;        // keys are integers or pointers, compared with memcmp
+
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    int policy;
+    int capacity;
+    int length;
+
+    int nbEntries;       // capacity+1 : W-TinyLFU holds one more entry while it chooses which one to evict
+    int entrySize;       // CacheEntry, key and value, each aligned on 8 bytes
+    int valueOffset;
+    char *entries;
+    uint32_t *buckets;   // first entry of each chain, power of 2 at least nbEntries
+    uint32_t mask;
+    uint32_t free;
+
+    CacheList lists[3];
+    uint32_t hand;       // CLOCK : next entry to look at
+
+    int windowMax;       // W-TinyLFU
+    int protectedMax;
+    uint64_t *sketch;    // 16 counters of 4 bits per word
+    uint32_t counterMask;
+    long additions;
+    long sampleSize;     // counters are halved after this many additions
+
+    CacheStats stats;
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    Cache cache;
+} Shard;
+
+struct _ShardedCache {
+    int nbShards;        // power of 2
+    int stride;          // size of a shard, rounded up to a cache line so that 2 locks never share one
+    ElHashFct hashFct;
+    void *buffer;
+    char *shards;        // aligned on a cache line inside buffer
+};
+
+
+
+static inline uint32_t ceilPow2(uint32_t x) {
+    uint32_t p = 1;
+
+    while(p < x)
+        p <<= 1;
+
+    return p;
+}
+
+static inline int align8(int size) {
+    return (size + 7) & ~7;
+}
+
+static inline CacheEntry *entryAt(const Cache c, uint32_t i) {
+    return (CacheEntry *)(c->entries + (size_t)i*c->entrySize);
+}
+
+static inline void *entryKey(const Cache c, uint32_t i) {
+    return c->entries + (size_t)i*c->entrySize + sizeof(CacheEntry);
+}
+
+static inline void *entryValue(const Cache c, uint32_t i) {
+    return c->entries + (size_t)i*c->entrySize + c->valueOffset;
+}
+
+static inline uint64_t cacheHash(ElHashFct hashFct, const Ptr key) {
+    return _elHashMix64(hashFct(key));
+}
+
+static inline bool keysEqual(const Cache c, const Ptr key1, const Ptr key2) {
+    if(c->bitwise)
+        return memcmp(key1, key2, c->keySize) == 0;
+
+    return c->cmpFct(key1, key2) == 0;
+}
+
+
+
+// Lists
+
+static void listPush(Cache c, int list, uint32_t i) {
+    CacheList *l = &c->lists[list];
+    CacheEntry *e = entryAt(c, i);
+
+    e->list = list;
+    e->prev = NONE;
+    e->after = l->head;
+
+    if(l->head != NONE)
+        entryAt(c, l->head)->prev = i;
+    else
+        l->tail = i;
+
+    l->head = i;
+    l->length++;
+}
+
+static void listUnlink(Cache c, uint32_t i) {
+    CacheEntry *e = entryAt(c, i);
+    CacheList *l = &c->lists[e->list];
+
+    if(e->prev != NONE)
+        entryAt(c, e->prev)->after = e->after;
+    else
+        l->head = e->after;
+
+    if(e->after != NONE)
+        entryAt(c, e->after)->prev = e->prev;
+    else
+        l->tail = e->prev;
+
+    l->length--;
+}
+
+// Moves an entry to the front of a list
+static inline void listMove(Cache c, int list, uint32_t i) {
+    if(c->lists[list].head == i)
+        return;
+
+    listUnlink(c, i);
+    listPush(c, list, i);
+}
+
+
+
+// Frequency sketch
+
+static const uint64_t sketchSeeds[4] = {0x9e3779b97f4a7c15ULL, 0xbf58476d1ce4e5b9ULL, 0x94d049bb133111ebULL, 0xc2b2ae3d27d4eb4fULL};
+
+static inline uint32_t sketchIndex(const Cache c, uint64_t hash, int row) {
+    return ((hash * sketchSeeds[row]) >> 32) & c->counterMask;
+}
+
+static int sketchFrequency(const Cache c, uint64_t hash) {
+    int freq = 15;
+
+    for(int row=0; row<4; row++) {
+        uint32_t index = sketchIndex(c, hash, row);
+        int count = (c->sketch[index >> 4] >> ((index & 15) * 4)) & 15;
+
+        if(count < freq)
+            freq = count;
+    }
+
+    return freq;
+}
+
+// Halves every counter, so that the sketch follows the recent popularity of the keys
+static void sketchAge(Cache c) {
+    for(uint32_t i=0; i<=c->counterMask>>4; i++)
+        c->sketch[i] = (c->sketch[i] >> 1) & 0x7777777777777777ULL;
+
+    c->additions /= 2;
+}
+
+static void sketchIncrement(Cache c, uint64_t hash) {
+    bool added = false;
+
+    for(int row=0; row<4; row++) {
+        uint32_t index = sketchIndex(c, hash, row);
+        int shift = (index & 15) * 4;
+
+        if(((c->sketch[index >> 4] >> shift) & 15) < 15) {
+            c->sketch[index >> 4] += 1ULL << shift;
+            added = true;
+        }
+    }
+
+    if(added && ++c->additions >= c->sampleSize)
+        sketchAge(c);
+}
+
+
+
+// Entries
+
+static uint32_t cacheFind(const Cache c, const Ptr key, uint64_t hash) {
+    for(uint32_t i = c->buckets[hash & c->mask]; i != NONE; i = entryAt(c, i)->next) {
+        if(entryAt(c, i)->hash == hash && keysEqual(c, entryKey(c, i), key))
+            return i;
+    }
+
+    return NONE;
+}
+
+// Empties the cache, without deleting the keys and values
+static void cacheReset(Cache c) {
+    memset(c->buckets, 0xff, (size_t)(c->mask+1) * sizeof(uint32_t));
+
+    for(int i=0; i<c->nbEntries; i++) {
+        CacheEntry *e = entryAt(c, i);
+
+        e->list = FREE;
+        e->next = i+1 < c->nbEntries ? (uint32_t)i+1 : NONE;
+    }
+
+    c->free = 0;
+    c->length = 0;
+    c->hand = 0;
+
+    for(int list=WINDOW; list<=PROTECTED; list++) {
+        c->lists[list].head = NONE;
+        c->lists[list].tail = NONE;
+        c->lists[list].length = 0;
+    }
+
+    if(c->sketch)
+        memset(c->sketch, 0, ((size_t)(c->counterMask >> 4) + 1) * sizeof(uint64_t));
+
+    c->additions = 0;
+}
+
+static void cacheDrop(Cache c, uint32_t i) {
+    CacheEntry *e = entryAt(c, i);
+    uint32_t *link = &c->buckets[e->hash & c->mask];
+
+    while(*link != i)
+        link = &entryAt(c, *link)->next;
+
+    *link = e->next;
+
+    if(c->policy != EL_CACHE_CLOCK)
+        listUnlink(c, i);
+
+    if(c->keyDelFct)
+        c->keyDelFct(entryKey(c, i));
+
+    if(c->delFct)
+        c->delFct(entryValue(c, i));
+
+    e->list = FREE;
+    e->next = c->free;
+    c->free = i;
+    c->length--;
+}
+
+// Second chance : entries used since the hand last passed are spared once
+static uint32_t clockVictim(Cache c) {
+    for(;;) {
+        uint32_t i = c->hand;
+        CacheEntry *e = entryAt(c, i);
+
+        c->hand = i+1 < (uint32_t)c->nbEntries ? i+1 : 0;
+
+        if(e->list == FREE)
+            continue;
+
+        if(!e->ref)
+            return i;
+
+        e->ref = 0;
+    }
+}
+
+// The least recently used entry of the window leaves it, and enters the main area if it is used more often than the entry it would evict
+static void tinyLfuAdmit(Cache c) {
+    uint32_t candidate = c->lists[WINDOW].tail;
+
+    if(c->length > c->capacity) {
+        uint32_t victim = c->lists[PROBATION].length ? c->lists[PROBATION].tail : c->lists[PROTECTED].tail;
+
+        c->stats.evictions++;
+
+        if(victim == NONE || sketchFrequency(c, entryAt(c, candidate)->hash) <= sketchFrequency(c, entryAt(c, victim)->hash)) {
+            cacheDrop(c, candidate);
+            return;
+        }
+
+        cacheDrop(c, victim);
+    }
+
+    listUnlink(c, candidate);
+    listPush(c, PROBATION, candidate);
+}
+
+static void cacheTouch(Cache c, uint32_t i) {
+    CacheEntry *e = entryAt(c, i);
+
+    switch(c->policy) {
+    case EL_CACHE_LRU:
+        listMove(c, WINDOW, i);
+        break;
+
+    case EL_CACHE_CLOCK:
+        // Only written when it changes, so that hits on hot entries leave their cache line clean
+        if(!e->ref)
+            e->ref = 1;
+        break;
+
+    case EL_CACHE_TINYLFU:
+        if(e->list == PROBATION) {
+            listUnlink(c, i);
+            listPush(c, PROTECTED, i);
+
+            if(c->lists[PROTECTED].length > c->protectedMax) {
+                uint32_t demoted = c->lists[PROTECTED].tail;
+
+                listUnlink(c, demoted);
+                listPush(c, PROBATION, demoted);
+            }
+        }
+        else
+            listMove(c, e->list, i);
+        break;
+    }
+}
+
+static void cacheInsert(Cache c, const Ptr key, const Ptr data, uint64_t hash) {
+    if(c->policy != EL_CACHE_TINYLFU && c->length == c->capacity) {
+        cacheDrop(c, c->policy == EL_CACHE_LRU ? c->lists[WINDOW].tail : clockVictim(c));
+        c->stats.evictions++;
+    }
+
+    uint32_t i = c->free;
+    CacheEntry *e = entryAt(c, i);
+
+    c->free = e->next;
+    c->length++;
+
+    e->hash = hash;
+    e->ref = 0;
+    e->next = c->buckets[hash & c->mask];
+    c->buckets[hash & c->mask] = i;
+
+    if(c->keyCopyFct)
+        c->keyCopyFct(entryKey(c, i), key);
+    else
+        memcpy(entryKey(c, i), key, c->keySize);
+
+    if(c->copyFct)
+        c->copyFct(entryValue(c, i), data);
+    else
+        memcpy(entryValue(c, i), data, c->elemSize);
+
+    if(c->policy == EL_CACHE_CLOCK)
+        e->list = WINDOW;
+    else
+        listPush(c, WINDOW, i);
+
+    if(c->policy == EL_CACHE_TINYLFU && c->lists[WINDOW].length > c->windowMax)
+        tinyLfuAdmit(c);
+}
+
+static Ptr cacheGetHashed(Cache c, const Ptr key, uint64_t hash) {
+    if(c->policy == EL_CACHE_TINYLFU)
+        sketchIncrement(c, hash);
+
+    uint32_t i = cacheFind(c, key, hash);
+
+    if(i == NONE) {
+        c->stats.misses++;
+        return NULL;
+    }
+
+    c->stats.hits++;
+    cacheTouch(c, i);
+
+    return entryValue(c, i);
+}
+
+static void cachePutHashed(Cache c, const Ptr key, const Ptr data, uint64_t hash) {
+    uint32_t i = cacheFind(c, key, hash);
+
+    if(i == NONE) {
+        if(c->policy == EL_CACHE_TINYLFU)
+            sketchIncrement(c, hash);
+
+        cacheInsert(c, key, data, hash);
+        return;
+    }
+
+    void *value = entryValue(c, i);
+
+    if(c->delFct)
+        c->delFct(value);
+
+    if(c->copyFct)
+        c->copyFct(value, data);
+    else
+        memcpy(value, data, c->elemSize);
+
+    cacheTouch(c, i);
+}
+
+static bool cacheRemoveHashed(Cache c, const Ptr key, uint64_t hash) {
+    uint32_t i = cacheFind(c, key, hash);
+
+    if(i == NONE)
+        return false;
+
+    cacheDrop(c, i);
+
+    return true;
+}
+
+
+
+Cache cacheNew(int keySize, int elemSize, ElHashFct hashFct, int capacity, int policy) {
+    Cache c = malloc(sizeof(struct _Cache));
+
+    if(keySize<=0) {
+        c->keySize = _elSizeFct(keySize);
+        c->cmpFct = _elCompareFct(keySize);
+    }
+    else {
+        c->keySize = keySize;
+        c->cmpFct = NULL;
+    }
+
+    c->bitwise = keySize > 0 || (keySize <= EL_POINTER && keySize >= EL_ULONGLONG) || keySize == EL_BOOL;
+
+    if(!hashFct && keySize<=0)
+        hashFct = _elHashFct(keySize);
+
+    c->hashFct = hashFct;
+    c->keyCopyFct = NULL;
+    c->keyDelFct = NULL;
+
+    if(elemSize<=0)
+        c->elemSize = _elSizeFct(elemSize);
+    else
+        c->elemSize = elemSize;
+
+    c->copyFct = NULL;
+    c->delFct = NULL;
+
+    if(capacity < 1)
+        capacity = 1;
+
+    c->policy = policy;
+    c->capacity = capacity;
+    c->nbEntries = capacity+1;
+    c->valueOffset = sizeof(CacheEntry) + align8(c->keySize);
+    c->entrySize = c->valueOffset + align8(c->elemSize);
+    c->entries = malloc((size_t)c->nbEntries * c->entrySize);
+
+    c->mask = ceilPow2(c->nbEntries) - 1;
+    c->buckets = malloc((size_t)(c->mask+1) * sizeof(uint32_t));
+
+    c->sketch = NULL;
+
+    if(policy == EL_CACHE_TINYLFU) {
+        c->windowMax = capacity/100 > 1 ? capacity/100 : 1;
+        c->protectedMax = (capacity - c->windowMax) * 4/5;
+
+        // About 8 counters per entry, each key using 4 of them
+        uint32_t nbWords = ceilPow2(capacity) / 2;
+
+        if(nbWords < 1)
+            nbWords = 1;
+
+        c->sketch = malloc(nbWords * sizeof(uint64_t));
+        c->counterMask = nbWords*16 - 1;
+        c->sampleSize = 10L * capacity;
+    }
+
+    c->stats.hits = 0;
+    c->stats.misses = 0;
+    c->stats.evictions = 0;
+
+    cacheReset(c);
+
+    return c;
+}
+
+Cache cacheNewStr(int elemSize, int capacity, int policy) {
+    Cache c = cacheNew(sizeof(char *), elemSize, _elHashString, capacity, policy);
+
+    c->cmpFct = _elCompareString;
+    c->bitwise = false;
+    c->keyCopyFct = _elCopyString;
+    c->keyDelFct = _elDelString;
+
+    return c;
+}
+
+void cacheDel(Cache c) {
+    cacheClear(c);
+
+    free(c->sketch);
+    free(c->buckets);
+    free(c->entries);
+    free(c);
+}
+
+
+
+void cacheComparable(Cache c, ElCmpFct fct) {
+    c->cmpFct = fct;
+    c->bitwise = false;
+}
+
+void cacheKeyInstanciable(Cache c, ElCopyFct copyFct, ElDelFct delFct) {
+    c->keyCopyFct = copyFct;
+    c->keyDelFct = delFct;
+}
+
+void cacheElementInstanciable(Cache c, ElCopyFct copyFct, ElDelFct delFct) {
+    c->copyFct = copyFct;
+    c->delFct = delFct;
+}
+
+
+
+void cacheClear(Cache c) {
+    if(c->keyDelFct || c->delFct) {
+        for(int i=0; i<c->nbEntries; i++) {
+            if(entryAt(c, i)->list == FREE)
+                continue;
+
+            if(c->keyDelFct)
+                c->keyDelFct(entryKey(c, i));
+
+            if(c->delFct)
+                c->delFct(entryValue(c, i));
+        }
+    }
+
+    cacheReset(c);
+}
+
+
+
+int cacheLength(const Cache c) {
+    return c->length;
+}
+
+int cacheCapacity(const Cache c) {
+    return c->capacity;
+}
+
+
+
+Ptr cacheGet_base(Cache c, const Ptr key) {
+    return cacheGetHashed(c, key, cacheHash(c->hashFct, key));
+}
+
+bool cacheContains_base(const Cache c, const Ptr key) {
+    return cacheFind(c, key, cacheHash(c->hashFct, key)) != NONE;
+}
+
+void cachePut_base(Cache c, const Ptr key, const Ptr data) {
+    cachePutHashed(c, key, data, cacheHash(c->hashFct, key));
+}
+
+bool cacheRemove_base(Cache c, const Ptr key) {
+    return cacheRemoveHashed(c, key, cacheHash(c->hashFct, key));
+}
+
+
+
+CacheStats cacheGetStats(const Cache c) {
+    return c->stats;
+}
+
+void cacheResetStats(Cache c) {
+    c->stats.hits = 0;
+    c->stats.misses = 0;
+    c->stats.evictions = 0;
+}
+
+
+
+void cacheDump(const Cache c) {
+    int dataSize = c->keySize + c->elemSize;
+    long elts = c->length;
+    long effcost = elts*dataSize;
+    long opcost = sizeof(struct _Cache) + (long)c->nbEntries*(c->entrySize-dataSize) + (long)(c->mask+1)*sizeof(uint32_t);
+    long preallcost = (long)(c->nbEntries-elts)*dataSize;
+
+    if(c->sketch)
+        opcost += ((long)(c->counterMask >> 4) + 1) * sizeof(uint64_t);
+
+    printf("Cache at %p\n", c);
+    printf("\t%ld elements, each using %d bytes\n", elts, dataSize);
+    printf("\t%ld bytes used for elements\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes used as preallocated\n", preallcost);
+    printf("\t%ld bytes total used\n", effcost+opcost+preallcost);
+    printf("\t%ld hits, %ld misses, %ld evictions\n", c->stats.hits, c->stats.misses, c->stats.evictions);
+}
+
+
+
+// Sharded cache
+
+static inline Shard *shardAt(const ShardedCache c, int i) {
+    return (Shard *)(c->shards + (size_t)i*c->stride);
+}
+
+// Shards are chosen by the high bits of the hash, the buckets of each shard by the low bits
+static inline Shard *shardOf(const ShardedCache c, uint64_t hash) {
+    return shardAt(c, (hash >> 32) & (c->nbShards-1));
+}
+
+ShardedCache shardedCacheNew(int keySize, int elemSize, ElHashFct hashFct, int capacity, int policy, int nbShards) {
+    ShardedCache c = malloc(sizeof(struct _ShardedCache));
+
+    if(capacity < 1)
+        capacity = 1;
+
+    nbShards = ceilPow2(nbShards < 1 ? 1 : nbShards);
+
+    // Every shard holds at least 1 entry
+    while(nbShards > 1 && nbShards > capacity)
+        nbShards /= 2;
+
+    c->nbShards = nbShards;
+    c->stride = (sizeof(Shard) + CACHELINE-1) / CACHELINE * CACHELINE;
+    c->buffer = malloc((size_t)nbShards*c->stride + CACHELINE);
+    c->shards = (char *)c->buffer + (CACHELINE - (uintptr_t)c->buffer%CACHELINE)%CACHELINE;
+
+    for(int i=0; i<nbShards; i++) {
+        Shard *shard = shardAt(c, i);
+
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->cache = cacheNew(keySize, elemSize, hashFct, capacity/nbShards + (i < capacity%nbShards), policy);
+    }
+
+    c->hashFct = shardAt(c, 0)->cache->hashFct;
+
+    return c;
+}
+
+void shardedCacheDel(ShardedCache c) {
+    for(int i=0; i<c->nbShards; i++) {
+        Shard *shard = shardAt(c, i);
+
+        cacheDel(shard->cache);
+        pthread_mutex_destroy(&shard->lock);
+    }
+
+    free(c->buffer);
+    free(c);
+}
+
+void shardedCacheComparable(ShardedCache c, ElCmpFct fct) {
+    for(int i=0; i<c->nbShards; i++)
+        cacheComparable(shardAt(c, i)->cache, fct);
+}
+
+void shardedCacheKeyInstanciable(ShardedCache c, ElCopyFct copyFct, ElDelFct delFct) {
+    for(int i=0; i<c->nbShards; i++)
+        cacheKeyInstanciable(shardAt(c, i)->cache, copyFct, delFct);
+}
+
+void shardedCacheElementInstanciable(ShardedCache c, ElCopyFct copyFct, ElDelFct delFct) {
+    for(int i=0; i<c->nbShards; i++)
+        cacheElementInstanciable(shardAt(c, i)->cache, copyFct, delFct);
+}
+
+void shardedCacheClear(ShardedCache c) {
+    for(int i=0; i<c->nbShards; i++) {
+        Shard *shard = shardAt(c, i);
+
+        pthread_mutex_lock(&shard->lock);
+        cacheClear(shard->cache);
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+int shardedCacheLength(ShardedCache c) {
+    int length = 0;
+
+    for(int i=0; i<c->nbShards; i++) {
+        Shard *shard = shardAt(c, i);
+
+        pthread_mutex_lock(&shard->lock);
+        length += shard->cache->length;
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return length;
+}
+
+bool shardedCacheGet_base(ShardedCache c, const Ptr key, Ptr dest) {
+    uint64_t hash = cacheHash(c->hashFct, key);
+    Shard *shard = shardOf(c, hash);
+
+    pthread_mutex_lock(&shard->lock);
+
+    Cache cache = shard->cache;
+    Ptr value = cacheGetHashed(cache, key, hash);
+
+    if(value) {
+        if(cache->copyFct)
+            cache->copyFct(dest, value);
+        else
+            memcpy(dest, value, cache->elemSize);
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return value != NULL;
+}
+
+void shardedCachePut_base(ShardedCache c, const Ptr key, const Ptr data) {
+    uint64_t hash = cacheHash(c->hashFct, key);
+    Shard *shard = shardOf(c, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    cachePutHashed(shard->cache, key, data, hash);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+bool shardedCacheRemove_base(ShardedCache c, const Ptr key) {
+    uint64_t hash = cacheHash(c->hashFct, key);
+    Shard *shard = shardOf(c, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    bool removed = cacheRemoveHashed(shard->cache, key, hash);
+    pthread_mutex_unlock(&shard->lock);
+
+    return removed;
+}
+
+CacheStats shardedCacheGetStats(ShardedCache c) {
+    CacheStats stats = {0, 0, 0};
+
+    for(int i=0; i<c->nbShards; i++) {
+        Shard *shard = shardAt(c, i);
+
+        pthread_mutex_lock(&shard->lock);
+        stats.hits += shard->cache->stats.hits;
+        stats.misses += shard->cache->stats.misses;
+        stats.evictions += shard->cache->stats.evictions;
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return stats;
+}
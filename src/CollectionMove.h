@@ -0,0 +1,41 @@
+/**
+ * \file CollectionMove.h
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Hand-over of storage between collections, used by the move conversions of Iterable.c.
+ * Arrays and heaps store their elements the same way : inline in pointer-sized slots, or allocated and pointed by them when
+ * the collection needsAllocation. Both decide it from the element size and functions, so a slot buffer can change owner as is.
+ * Private header.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_COLLECTIONMOVE_H
+#define EXTLIB_COLLECTIONMOVE_H
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/Array.h"
+#include "ExtLib/Heap.h"
+
+// Frees an array but neither its slots nor its elements, and returns the slots
+Ptr *_arrayRelease(Array a, int *length, int *size);
+
+// Gives to an empty array a buffer of size slots, length of them used, holding elements of the same settings
+void _arrayAdopt(Array a, Ptr *ct, int length, int size);
+
+// Appends a bitwise copy of data, without calling the copy function : data is moved into the array
+void _arrayPushMove(Array a, const Ptr data);
+
+// Frees an array and the storage of its elements, without calling the delete function : the elements were moved out
+void _arrayForget(Array a);
+
+// Same as _arrayRelease for a heap
+Ptr *_heapRelease(Heap h, int *length, int *size);
+
+// Same as _arrayAdopt for a heap, the slots are then reordered into a heap
+void _heapAdopt(Heap h, Ptr *ct, int length, int size);
+
+#endif
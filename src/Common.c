@@ -9,7 +9,9 @@
 
 #include "ExtLib/Common.h"
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 /*void throwExc(char *module, char *msg) {
     fprintf(stderr, "/!\\ [%s] %s", module, msg);
@@ -19,7 +21,7 @@
 
 
 int _elComparePointer(Ptr v1, Ptr v2) {
-    return (int)(*(Ptr*)v1-*(Ptr*)v2);
+    return (*(Ptr*)v1>*(Ptr*)v2) - (*(Ptr*)v1<*(Ptr*)v2);
 }
 int _elCompareChar(Ptr v1, Ptr v2) {
     return (int)(*(char*)v1-*(char*)v2);
@@ -34,22 +36,22 @@ int _elCompareUshort(Ptr v1, Ptr v2) {
     return (int)(*(unsigned short*)v1-*(unsigned short*)v2);
 }
 int _elCompareInt(Ptr v1, Ptr v2) {
-    return (int)(*(int*)v1-*(int*)v2);
+    return (*(int*)v1>*(int*)v2) - (*(int*)v1<*(int*)v2);
 }
 int _elCompareUint(Ptr v1, Ptr v2) {
-    return (int)(*(unsigned int*)v1-*(unsigned int*)v2);
+    return (*(unsigned int*)v1>*(unsigned int*)v2) - (*(unsigned int*)v1<*(unsigned int*)v2);
 }
 int _elCompareLong(Ptr v1, Ptr v2) {
-    return (int)(*(long*)v1-*(long*)v2);
+    return (*(long*)v1>*(long*)v2) - (*(long*)v1<*(long*)v2);
 }
 int _elCompareUlong(Ptr v1, Ptr v2) {
-    return (int)(*(unsigned long*)v1-*(unsigned long*)v2);
+    return (*(unsigned long*)v1>*(unsigned long*)v2) - (*(unsigned long*)v1<*(unsigned long*)v2);
 }
 int _elCompareLonglong(Ptr v1, Ptr v2) {
-    return (int)(*(long long*)v1-*(long long*)v2);
+    return (*(long long*)v1>*(long long*)v2) - (*(long long*)v1<*(long long*)v2);
 }
 int _elCompareUlonglong(Ptr v1, Ptr v2) {
-    return (int)(*(unsigned long long*)v1-*(unsigned long long*)v2);
+    return (*(unsigned long long*)v1>*(unsigned long long*)v2) - (*(unsigned long long*)v1<*(unsigned long long*)v2);
 }
 int _elCompareFloat(Ptr v1, Ptr v2) {
     if(*(float*)v1<*(float*)v2) return -1;
@@ -113,3 +115,251 @@ int _elSizeFct(int type) {
         default           : return type;
     }
 }
+
+// New capacity for at least minSize elements
+int _elGrowSize(int size, int minSize, float growth) {
+    int grown = size * growth;
+
+    if(grown <= size)
+        grown = size + 1;
+
+    return grown > minSize ? grown : minSize;
+}
+
+// New capacity once length elements remain : reduced only under size/shrinkDivisor, leaving room for a growth
+int _elShrinkSize(int size, int length, int minSize, float growth, int shrinkDivisor) {
+    if(shrinkDivisor == EL_NEVER_SHRINK || length > size / shrinkDivisor)
+        return size;
+
+    int shrunk = length * growth;
+
+    if(shrunk < minSize)
+        shrunk = minSize;
+
+    return shrunk < size ? shrunk : size;
+}
+
+
+
+/* Byte and integer hashing
+ *
+ * hashBytes follows the structure of wyhash : the input is read 8 bytes at a
+ * time and every pair of words is folded by a 64x64->128 multiplication whose
+ * halves are xored together. Long inputs use three independent lanes so that
+ * the multiplications can overlap.
+ */
+
+static const uint64_t hashSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+static inline void hashMum(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t aLo = (uint32_t)*a, aHi = *a >> 32;
+    uint64_t bLo = (uint32_t)*b, bHi = *b >> 32;
+
+    uint64_t b00 = aLo * bLo;
+    uint64_t b01 = aLo * bHi;
+    uint64_t b10 = aHi * bLo;
+    uint64_t b11 = aHi * bHi;
+
+    uint64_t mid1 = b10 + (b00 >> 32);
+    uint64_t mid2 = b01 + (uint32_t)mid1;
+
+    *a = (mid2 << 32) | (uint32_t)b00;
+    *b = b11 + (mid1 >> 32) + (mid2 >> 32);
+#endif
+}
+
+static inline uint64_t hashMix(uint64_t a, uint64_t b) {
+    hashMum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t read8(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t read4(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+unsigned long long _elHashBytes64(const void *data, int length) {
+    const unsigned char *p = data;
+    size_t len = length > 0 ? length : 0;
+    uint64_t seed = hashMix(hashSecret[0], hashSecret[1]);
+    uint64_t a, b;
+
+    if(len <= 16) {
+        if(len >= 4) {
+            // Two overlapping 4-byte reads from each end cover 4 to 16 bytes
+            a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if(len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else {
+        size_t i = len;
+
+        if(i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+
+            do {
+                seed = hashMix(read8(p) ^ hashSecret[1], read8(p + 8) ^ seed);
+                seed1 = hashMix(read8(p + 16) ^ hashSecret[2], read8(p + 24) ^ seed1);
+                seed2 = hashMix(read8(p + 32) ^ hashSecret[3], read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while(i > 16) {
+            seed = hashMix(read8(p) ^ hashSecret[1], read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        // The last 16 bytes, possibly overlapping bytes already consumed
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= hashSecret[1];
+    b ^= seed;
+    hashMum(&a, &b);
+
+    return hashMix(a ^ hashSecret[0] ^ len, b ^ hashSecret[1]);
+}
+
+// unsigned long may only have 32 bits : structures taking several indices from one hash use the 64 bits variants
+unsigned long hashBytes(const void *data, int length) {
+    return (unsigned long)_elHashBytes64(data, length);
+}
+
+unsigned long long _elHashMix64(unsigned long long x) {
+    // Multiply-xorshift : every input bit reaches every output bit
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+
+    return x;
+}
+
+unsigned long _elHashMix(unsigned long long x) {
+    return (unsigned long)_elHashMix64(x);
+}
+
+
+
+static unsigned long _elHashPointer(Ptr key) {
+    return _elHashMix((uintptr_t)*(Ptr*)key);
+}
+static unsigned long _elHashChar(Ptr key) {
+    return _elHashMix((unsigned char)*(char*)key);
+}
+static unsigned long _elHashShort(Ptr key) {
+    return _elHashMix((unsigned short)*(short*)key);
+}
+static unsigned long _elHashInt(Ptr key) {
+    return _elHashMix((unsigned int)*(int*)key);
+}
+static unsigned long _elHashLong(Ptr key) {
+    return _elHashMix((unsigned long)*(long*)key);
+}
+static unsigned long _elHashLonglong(Ptr key) {
+    return _elHashMix((unsigned long long)*(long long*)key);
+}
+// Floating keys are hashed by value : 0.0 and -0.0 compare equal so they must hash equal
+static unsigned long _elHashFloat(Ptr key) {
+    float f = *(float*)key;
+    uint32_t bits;
+    if(f == 0.0f)
+        f = 0.0f;
+    memcpy(&bits, &f, sizeof(bits));
+    return _elHashMix(bits);
+}
+static unsigned long _elHashDouble(Ptr key) {
+    double d = *(double*)key;
+    uint64_t bits;
+    if(d == 0.0)
+        d = 0.0;
+    memcpy(&bits, &d, sizeof(bits));
+    return _elHashMix(bits);
+}
+// long double may carry padding bytes, so it is hashed through its double rounding
+static unsigned long _elHashLongdouble(Ptr key) {
+    double d = (double)*(long double*)key;
+    uint64_t bits;
+    if(d == 0.0)
+        d = 0.0;
+    memcpy(&bits, &d, sizeof(bits));
+    return _elHashMix(bits);
+}
+static unsigned long _elHashBool(Ptr key) {
+    return _elHashMix(*(bool*)key ? 1 : 0);
+}
+
+
+
+ElHashFct _elHashFct(int type) {
+    switch (type) {
+        case EL_POINTER   : return _elHashPointer;
+        case EL_CHAR      :
+        case EL_UCHAR     : return _elHashChar;
+        case EL_SHORT     :
+        case EL_USHORT    : return _elHashShort;
+        case EL_INT       :
+        case EL_UINT      : return _elHashInt;
+        case EL_LONG      :
+        case EL_ULONG     : return _elHashLong;
+        case EL_LONGLONG  :
+        case EL_ULONGLONG : return _elHashLonglong;
+        case EL_FLOAT     : return _elHashFloat;
+        case EL_DOUBLE    : return _elHashDouble;
+        case EL_LONGDOUBLE: return _elHashLongdouble;
+        case EL_BOOL      : return _elHashBool;
+        default           : return NULL;
+    }
+}
+
+
+
+// Keys which are C strings : the containers keep their own copy of each string
+
+unsigned long _elHashString(Ptr key) {
+    return hashBytes(*(char**)key, strlen(*(char**)key));
+}
+
+int _elCompareString(Ptr key1, Ptr key2) {
+    return strcmp(*(char**)key1, *(char**)key2);
+}
+
+void _elCopyString(Ptr dest, Ptr src) {
+    int length = strlen(*(char**)src);
+
+    *(char**)dest = malloc((length+1) * sizeof(char));
+
+    strcpy(*(char**)dest, *(char**)src);
+}
+
+void _elDelString(Ptr key) {
+    free(*(char**)key);
+}
@@ -0,0 +1,392 @@
+/**
+ * \file ConcurrentQueue.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ExtLib/Common.h"
+#include "ExtLib/ConcurrentQueue.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHELINE 64
+
+// Starts a group of members on its own cache line. The queues are allocated on a cache line boundary for it
+#define LINEALIGNED __attribute__((aligned(CACHELINE)))
+
+// Indices are only ever increased, positions in the buffer are index & mask
+struct _SpscQueue {
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    size_t mask;
+    void *ct;
+
+    // Written by the producer only
+    LINEALIGNED size_t tail;
+    size_t cachedHead; // last value of head read by the producer
+
+    // Written by the consumer only
+    LINEALIGNED size_t head;
+    size_t cachedTail; // last value of tail read by the consumer
+};
+
+// Each cell holds a sequence number followed by the element.
+// A cell at position pos is free for the producer of index pos when its sequence is pos,
+// and full for the consumer of index pos when its sequence is pos+1.
+struct _MpmcQueue {
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    size_t mask;
+    int cellSize;
+    void *cells;
+
+    LINEALIGNED size_t enqueuePos;
+
+    LINEALIGNED size_t dequeuePos;
+};
+
+
+
+static size_t roundCapacity(int capacity) {
+    size_t size = 2;
+
+    while(size < (size_t)capacity)
+        size *= 2;
+
+    return size;
+}
+
+// malloc only aligns on 16 bytes, the padding of the hot members needs a cache line boundary
+static void *allocLineAligned(size_t size) {
+    void *ptr;
+
+    if(posix_memalign(&ptr, CACHELINE, size))
+        return NULL;
+
+    return ptr;
+}
+
+static inline void copyIn(ElCopyFct copyFct, void *slot, const void *data, int elemSize) {
+    if(copyFct)
+        copyFct(slot, (Ptr)data);
+    else
+        memcpy(slot, data, elemSize);
+}
+
+
+
+SpscQueue spscQueueNew(int elemSize, int capacity) {
+    SpscQueue q = allocLineAligned(sizeof(struct _SpscQueue));
+
+    q->elemSize = elemSize<=0 ? _elSizeFct(elemSize) : elemSize;
+    q->copyFct = NULL;
+    q->delFct = NULL;
+
+    q->mask = roundCapacity(capacity) - 1;
+    q->ct = malloc((q->mask+1) * q->elemSize);
+
+    q->tail = 0;
+    q->cachedHead = 0;
+    q->head = 0;
+    q->cachedTail = 0;
+
+    return q;
+}
+
+void spscQueueDel(SpscQueue q) {
+    if(q->delFct) {
+        for(size_t i=q->head; i!=q->tail; i++)
+            q->delFct(q->ct + (i & q->mask)*q->elemSize);
+    }
+
+    free(q->ct);
+    free(q);
+}
+
+void spscQueueElementInstanciable(SpscQueue q, ElCopyFct copyFct, ElDelFct delFct) {
+    q->copyFct = copyFct;
+    q->delFct = delFct;
+}
+
+
+
+int spscQueueCapacity(const SpscQueue q) {
+    return q->mask+1;
+}
+
+int spscQueueLength(const SpscQueue q) {
+    size_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+    size_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+
+    return tail - head;
+}
+
+
+
+bool spscQueuePush_base(SpscQueue q, const Ptr data) {
+    size_t tail = q->tail;
+
+    // The shared head is only read when the cached one says the queue is full
+    if(tail - q->cachedHead > q->mask) {
+        q->cachedHead = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+
+        if(tail - q->cachedHead > q->mask)
+            return false;
+    }
+
+    copyIn(q->copyFct, q->ct + (tail & q->mask)*q->elemSize, data, q->elemSize);
+
+    __atomic_store_n(&q->tail, tail+1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+int spscQueuePushMany(SpscQueue q, const Ptr data, int nb) {
+    if(nb <= 0)
+        return 0;
+
+    size_t tail = q->tail;
+    size_t capacity = q->mask+1;
+
+    if(tail - q->cachedHead + nb > capacity)
+        q->cachedHead = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+
+    size_t room = capacity - (tail - q->cachedHead);
+    if((size_t)nb > room)
+        nb = room;
+
+    for(int i=0; i<nb; i++)
+        copyIn(q->copyFct, q->ct + ((tail+i) & q->mask)*q->elemSize, data + i*q->elemSize, q->elemSize);
+
+    __atomic_store_n(&q->tail, tail+nb, __ATOMIC_RELEASE);
+
+    return nb;
+}
+
+
+
+bool spscQueuePop_base(SpscQueue q, Ptr dest) {
+    size_t head = q->head;
+
+    if(head == q->cachedTail) {
+        q->cachedTail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+
+        if(head == q->cachedTail)
+            return false;
+    }
+
+    memcpy(dest, q->ct + (head & q->mask)*q->elemSize, q->elemSize);
+
+    __atomic_store_n(&q->head, head+1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+int spscQueuePopMany(SpscQueue q, Ptr dest, int nb) {
+    if(nb <= 0)
+        return 0;
+
+    size_t head = q->head;
+
+    if(q->cachedTail - head < (size_t)nb)
+        q->cachedTail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+
+    size_t available = q->cachedTail - head;
+    if((size_t)nb > available)
+        nb = available;
+
+    // At most 2 contiguous runs in the buffer
+    size_t start = head & q->mask;
+    size_t firstPart = q->mask+1 - start;
+    if(firstPart > (size_t)nb)
+        firstPart = nb;
+
+    memcpy(dest, q->ct + start*q->elemSize, firstPart*q->elemSize);
+    memcpy(dest + firstPart*q->elemSize, q->ct, (nb-firstPart)*q->elemSize);
+
+    __atomic_store_n(&q->head, head+nb, __ATOMIC_RELEASE);
+
+    return nb;
+}
+
+
+
+void spscQueueDump(const SpscQueue q) {
+    int elts = spscQueueLength(q);
+    int effcost = elts*q->elemSize;
+    int opcost = sizeof(struct _SpscQueue);
+    int preallcost = (q->mask+1-elts)*q->elemSize;
+
+    printf("SPSC queue at %p\n", q);
+    printf("\t%d elements, each using %d bytes\n", elts, q->elemSize);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
+
+
+
+static inline size_t *cellSeq(const MpmcQueue q, size_t pos) {
+    return q->cells + (pos & q->mask)*q->cellSize;
+}
+
+static inline void *cellData(const MpmcQueue q, size_t pos) {
+    return q->cells + (pos & q->mask)*q->cellSize + sizeof(size_t);
+}
+
+MpmcQueue mpmcQueueNew(int elemSize, int capacity) {
+    MpmcQueue q = allocLineAligned(sizeof(struct _MpmcQueue));
+
+    q->elemSize = elemSize<=0 ? _elSizeFct(elemSize) : elemSize;
+    q->copyFct = NULL;
+    q->delFct = NULL;
+
+    q->mask = roundCapacity(capacity) - 1;
+    // Cells are aligned on the size of a sequence number
+    q->cellSize = (sizeof(size_t) + q->elemSize + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    q->cells = malloc((q->mask+1) * q->cellSize);
+
+    for(size_t i=0; i<=q->mask; i++)
+        *cellSeq(q, i) = i;
+
+    q->enqueuePos = 0;
+    q->dequeuePos = 0;
+
+    return q;
+}
+
+void mpmcQueueDel(MpmcQueue q) {
+    if(q->delFct) {
+        for(size_t i=q->dequeuePos; i!=q->enqueuePos; i++)
+            q->delFct(cellData(q, i));
+    }
+
+    free(q->cells);
+    free(q);
+}
+
+void mpmcQueueElementInstanciable(MpmcQueue q, ElCopyFct copyFct, ElDelFct delFct) {
+    q->copyFct = copyFct;
+    q->delFct = delFct;
+}
+
+
+
+int mpmcQueueCapacity(const MpmcQueue q) {
+    return q->mask+1;
+}
+
+int mpmcQueueLength(const MpmcQueue q) {
+    size_t dequeuePos = __atomic_load_n(&q->dequeuePos, __ATOMIC_RELAXED);
+    size_t enqueuePos = __atomic_load_n(&q->enqueuePos, __ATOMIC_RELAXED);
+
+    intptr_t length = enqueuePos - dequeuePos;
+
+    return length < 0 ? 0 : length;
+}
+
+
+
+// Claims up to nb consecutive cells whose sequence is their position + offset, returns the first position and sets *nb to the number claimed
+static size_t mpmcClaim(MpmcQueue q, size_t *counter, size_t offset, int *nb) {
+    size_t pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+
+    for(;;) {
+        int ready = 0;
+
+        while(ready < *nb) {
+            size_t seq = __atomic_load_n(cellSeq(q, pos+ready), __ATOMIC_ACQUIRE);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos+ready+offset);
+
+            if(diff != 0) {
+                // The counter moved under us, retry from its new value
+                if(diff > 0 && ready == 0)
+                    ready = -1;
+                break;
+            }
+
+            ready++;
+        }
+
+        if(ready == 0) {
+            *nb = 0;
+            return pos;
+        }
+
+        if(ready > 0 && __atomic_compare_exchange_n(counter, &pos, pos+ready, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *nb = ready;
+            return pos;
+        }
+
+        if(ready < 0)
+            pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+    }
+}
+
+bool mpmcQueuePush_base(MpmcQueue q, const Ptr data) {
+    return mpmcQueuePushMany(q, data, 1) == 1;
+}
+
+int mpmcQueuePushMany(MpmcQueue q, const Ptr data, int nb) {
+    if(nb <= 0)
+        return 0;
+
+    size_t pos = mpmcClaim(q, &q->enqueuePos, 0, &nb);
+
+    for(int i=0; i<nb; i++) {
+        copyIn(q->copyFct, cellData(q, pos+i), data + i*q->elemSize, q->elemSize);
+        __atomic_store_n(cellSeq(q, pos+i), pos+i+1, __ATOMIC_RELEASE);
+    }
+
+    return nb;
+}
+
+
+
+bool mpmcQueuePop_base(MpmcQueue q, Ptr dest) {
+    return mpmcQueuePopMany(q, dest, 1) == 1;
+}
+
+int mpmcQueuePopMany(MpmcQueue q, Ptr dest, int nb) {
+    if(nb <= 0)
+        return 0;
+
+    size_t pos = mpmcClaim(q, &q->dequeuePos, 1, &nb);
+
+    for(int i=0; i<nb; i++) {
+        memcpy(dest + i*q->elemSize, cellData(q, pos+i), q->elemSize);
+        // Frees the cell for the producer of the next lap
+        __atomic_store_n(cellSeq(q, pos+i), pos+i+q->mask+1, __ATOMIC_RELEASE);
+    }
+
+    return nb;
+}
+
+
+
+void mpmcQueueDump(const MpmcQueue q) {
+    int elts = mpmcQueueLength(q);
+    int effcost = elts*q->elemSize;
+    int opcost = sizeof(struct _MpmcQueue) + (q->mask+1)*(q->cellSize - q->elemSize);
+    int preallcost = (q->mask+1-elts)*q->elemSize;
+
+    printf("MPMC queue at %p\n", q);
+    printf("\t%d elements, each using %d bytes\n", elts, q->elemSize);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
@@ -0,0 +1,296 @@
+/**
+ * \file Deque.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/Deque.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFSIZE 8 // must be a power of 2
+
+struct _Deque {
+    RealType type;
+    ElCmpFct cmpFct;
+
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    int length;
+
+    int head;   // position of the first element in ct
+    int size;   // capacity, always a power of 2 so that positions wrap with a mask
+    void *ct;
+};
+
+
+
+static inline void *dequeSlot(const Deque d, int pos) {
+    return d->ct + ((d->head + pos) & (d->size - 1)) * d->elemSize;
+}
+
+static inline void dequeCopyIn(Deque d, void *slot, const Ptr data) {
+    if(d->copyFct)
+        d->copyFct(slot, data);
+    else {
+        // Constant sizes let the compiler turn the copy into a single move
+        switch(d->elemSize) {
+            case 1 : memcpy(slot, data, 1); break;
+            case 2 : memcpy(slot, data, 2); break;
+            case 4 : memcpy(slot, data, 4); break;
+            case 8 : memcpy(slot, data, 8); break;
+            case 16: memcpy(slot, data, 16); break;
+            default: memcpy(slot, data, d->elemSize);
+        }
+    }
+}
+
+// Reallocates ct with the given capacity, the elements are unwrapped at the beginning of the new buffer
+static void dequeResize(Deque d, int size) {
+    void *ct = malloc(size * d->elemSize);
+    int firstPart = d->size - d->head;
+
+    if(firstPart > d->length)
+        firstPart = d->length;
+
+    memcpy(ct, d->ct + d->head*d->elemSize, firstPart*d->elemSize);
+    memcpy(ct + firstPart*d->elemSize, d->ct, (d->length - firstPart)*d->elemSize);
+
+    free(d->ct);
+
+    d->ct = ct;
+    d->head = 0;
+    d->size = size;
+}
+
+
+
+Deque dequeNew(int elemSize) {
+    Deque d = malloc(sizeof(struct _Deque));
+
+    d->type = DEQUE;
+
+    if(elemSize<=0) {
+        d->elemSize=_elSizeFct(elemSize);
+        d->cmpFct=_elCompareFct(elemSize);
+    }
+    else {
+        d->elemSize=elemSize;
+        d->cmpFct=NULL;
+    }
+
+    d->copyFct = NULL;
+    d->delFct = NULL;
+
+    d->length = 0;
+
+    d->head = 0;
+    d->size = DEFSIZE;
+    d->ct = malloc(DEFSIZE * d->elemSize);
+
+    return d;
+}
+
+void dequeDel(Deque d) {
+    dequeClear(d);
+
+    free(d->ct);
+    free(d);
+}
+
+
+
+void dequeComparable(Deque d, ElCmpFct fct) {
+    d->cmpFct = fct;
+}
+
+void dequeElementInstanciable(Deque d, ElCopyFct copyFct, ElDelFct delFct) {
+    d->copyFct = copyFct;
+    d->delFct = delFct;
+}
+
+
+
+Deque dequeClone(const Deque d) {
+    Deque d2 = dequeNew(d->elemSize);
+
+    d2->cmpFct = d->cmpFct;
+    d2->copyFct = d->copyFct;
+    d2->delFct = d->delFct;
+
+    dequeReserve(d2, d->length);
+
+    for(int i=0; i<d->length; i++)
+        dequeCopyIn(d2, dequeSlot(d2, i), dequeSlot(d, i));
+
+    d2->length = d->length;
+
+    return d2;
+}
+
+
+
+void dequeClear(Deque d) {
+    if(d->delFct) {
+        for(int i=0; i<d->length; i++)
+            d->delFct(dequeSlot(d, i));
+    }
+
+    d->length = 0;
+    d->head = 0;
+    d->size = DEFSIZE;
+    d->ct = realloc(d->ct, DEFSIZE * d->elemSize);
+}
+
+
+
+bool dequeIsEmpty(const Deque d) {
+    return d->length == 0;
+}
+
+int dequeLength(const Deque d) {
+    return d->length;
+}
+
+
+
+void dequeReserve(Deque d, int capacity) {
+    if(capacity <= d->size)
+        return;
+
+    int size = d->size;
+    while(size < capacity)
+        size *= 2;
+
+    dequeResize(d, size);
+}
+
+
+
+bool dequeContains(const Deque d, const Ptr data) {
+    return dequeIndexOf(d, data) != -1;
+}
+
+int dequeIndexOf(const Deque d, const Ptr data) {
+    for(int i=0; i<d->length; i++)
+        if(d->cmpFct(dequeSlot(d, i), data) == 0)
+            return i;
+
+    return -1;
+}
+
+
+
+const Ptr dequeGet_base(const Deque d, int pos) {
+    return dequeSlot(d, pos);
+}
+
+const Ptr dequeGetFirst_base(const Deque d) {
+    return dequeSlot(d, 0);
+}
+
+const Ptr dequeGetLast_base(const Deque d) {
+    return dequeSlot(d, d->length-1);
+}
+
+
+
+void dequeSet_base(Deque d, int pos, const Ptr data) {
+    void *slot = dequeSlot(d, pos);
+
+    if(d->delFct)
+        d->delFct(slot);
+
+    dequeCopyIn(d, slot, data);
+}
+
+
+
+void dequeAddFirst_base(Deque d, const Ptr data) {
+    if(d->length == d->size)
+        dequeResize(d, 2*d->size);
+
+    d->head = (d->head - 1) & (d->size - 1);
+    dequeCopyIn(d, d->ct + d->head*d->elemSize, data);
+
+    d->length++;
+}
+
+void dequeAddLast_base(Deque d, const Ptr data) {
+    if(d->length == d->size)
+        dequeResize(d, 2*d->size);
+
+    dequeCopyIn(d, dequeSlot(d, d->length), data);
+
+    d->length++;
+}
+
+
+
+void dequeRemoveFirst(Deque d) {
+    if(d->delFct)
+        d->delFct(dequeSlot(d, 0));
+
+    d->head = (d->head + 1) & (d->size - 1);
+    d->length--;
+}
+
+void dequeRemoveLast(Deque d) {
+    if(d->delFct)
+        d->delFct(dequeSlot(d, d->length-1));
+
+    d->length--;
+}
+
+
+
+void dequeDump(const Deque d) {
+    int elts = d->length;
+    int effcost = elts*d->elemSize;
+    int opcost = sizeof(struct _Deque);
+    int preallcost = (d->size-elts)*d->elemSize;
+
+    printf("Deque at %p\n", d);
+    printf("\t%d elements, each using %d bytes\n", elts, d->elemSize);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
+
+
+
+void dequeForEach(Deque d, ElActFct actFct, Ptr infos) {
+    // At most 2 contiguous runs : from head to the end of ct, then from the start of ct
+    int firstPart = d->size - d->head;
+
+    if(firstPart > d->length)
+        firstPart = d->length;
+
+    void *elt = d->ct + d->head*d->elemSize;
+    for(int i=0; i<firstPart; i++, elt+=d->elemSize)
+        actFct(elt, infos);
+
+    elt = d->ct;
+    for(int i=firstPart; i<d->length; i++, elt+=d->elemSize)
+        actFct(elt, infos);
+}
+
+void dequeCopyToRaw(const Deque d, Ptr dest) {
+    int firstPart = d->size - d->head;
+
+    if(firstPart > d->length)
+        firstPart = d->length;
+
+    memcpy(dest, d->ct + d->head*d->elemSize, firstPart*d->elemSize);
+    memcpy(dest + firstPart*d->elemSize, d->ct, (d->length - firstPart)*d->elemSize);
+}
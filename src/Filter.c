@@ -0,0 +1,952 @@
+/**
+ * \file Filter.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ * Split block Bloom filters are described in "Cache-, Hash- and Space-Efficient Bloom Filters" (Putze, Sanders, Singler,
+ * 2007) and used by Impala and Parquet, cuckoo filters in "Cuckoo Filter: Practically Better Than Bloom" (Fan et al.,
+ * 2014), xor filters in "Xor Filters: Faster and Smaller Than Bloom and Cuckoo Filters" (Graf, Lemire, 2020).
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/Array.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/Filter.h"
+
+#include "Serial.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) && !defined(EXTLIB_NO_SIMD)
+#include <immintrin.h>
+#elif defined(__SSE2__) && !defined(EXTLIB_NO_SIMD)
+#include <emmintrin.h>
+#endif
+
+#define BATCH 16         // keys hashed and prefetched before being tested by the batch queries
+
+#define BLOCKWORDS 8     // 32-bit words of a Bloom block, one bit set in each by a key
+#define BLOCKSIZE (BLOCKWORDS * sizeof(uint32_t))
+
+#define BUCKETSLOTS 4    // fingerprints of a cuckoo bucket
+#define MAXKICKS 500     // fingerprints moved by an addition before the cuckoo filter is considered full
+#define MAXLOAD 0.95     // load reached by cuckoo filters with buckets of 4
+
+#define MAXSEEDS 100     // xor filter constructions tried before giving up
+
+struct _BloomFilter {
+    int keySize;         // as given at creation, saved with the filter
+    int elemSize;        // stride of the key buffers
+    ElHashFct hashFct;
+    long length;
+
+    uint64_t nbBlocks;
+    void *buffer;
+    uint32_t *blocks;    // aligned on BLOCKSIZE, so that a block never straddles two cache lines
+};
+
+struct _CuckooFilter {
+    int keySize;
+    int elemSize;
+    ElHashFct hashFct;
+    long length;
+
+    int fpBytes;         // 1 or 2
+    uint64_t nbBuckets;  // power of 2
+    uint64_t victim;     // bucket << 16 | fingerprint of a key which found no slot, 0 if none : the filter is then full
+    uint64_t rng;
+    void *table;         // fingerprints, 0 for empty slots
+};
+
+struct _XorFilter {
+    int keySize;
+    int elemSize;
+    ElHashFct hashFct;
+    long length;
+
+    int fpBytes;         // 1 or 2
+    uint64_t seed;
+    uint32_t blockLength;
+    void *table;         // 3 segments of blockLength fingerprints
+};
+
+
+
+// Keys
+
+// Hashes are mixed, so that all their bits are usable whatever the quality of hashFct
+static inline uint64_t filterHash(ElHashFct hashFct, const Ptr key, uint64_t seed) {
+    return _elHashMix64(hashFct(key) ^ seed);
+}
+
+static inline ElHashFct filterHashFct(int keySize, ElHashFct hashFct) {
+    if(!hashFct && keySize <= 0)
+        return _elHashFct(keySize);
+
+    return hashFct;
+}
+
+static inline int filterElemSize(int keySize) {
+    return keySize <= 0 ? _elSizeFct(keySize) : keySize;
+}
+
+// Reduces a 32-bit value to [0, range) without division
+static inline uint32_t reduce(uint32_t x, uint32_t range) {
+    return ((uint64_t)x * range) >> 32;
+}
+
+
+
+// Files
+
+static bool filterSave(const char *path, const FilterFileHeader *header, const void *data) {
+    FILE *file = fopen(path, "wb");
+
+    if(!file)
+        return false;
+
+    bool ok = fwrite(header, sizeof(FilterFileHeader), 1, file) == 1 && fwrite(data, 1, header->dataSize, file) == header->dataSize;
+
+    return fclose(file) == 0 && ok;
+}
+
+// Opens a filter file and reads its header, the file is left at the start of the table.
+// Returns NULL if the header is invalid or if there is no hash function for the keys.
+static FILE *filterOpen(const char *path, uint32_t magic, FilterFileHeader *header, ElHashFct *hashFct) {
+    FILE *file = fopen(path, "rb");
+
+    if(!file)
+        return NULL;
+
+    if(fread(header, sizeof(FilterFileHeader), 1, file) != 1 || header->magic != magic || header->version != SERIAL_VERSION
+       || header->keySize < EL_BOOL || !(*hashFct = filterHashFct(header->keySize, *hashFct))) {
+        fclose(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+// Reads the table of a filter file, which must end right after it
+static bool filterRead(FILE *file, void *data, uint64_t dataSize) {
+    bool ok = fread(data, 1, dataSize, file) == dataSize && fgetc(file) == EOF;
+
+    fclose(file);
+
+    return ok;
+}
+
+
+
+// Bloom filter
+
+static const uint32_t bloomSalts[BLOCKWORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+static inline uint32_t *bloomBlock(const BloomFilter f, uint64_t hash) {
+    return f->blocks + (size_t)BLOCKWORDS * (((hash >> 32) * f->nbBlocks) >> 32);
+}
+
+// The bit set by the low half of the hash in each word of its block
+static inline void bloomMasks(uint32_t key, uint32_t masks[BLOCKWORDS]) {
+    for(int i=0; i<BLOCKWORDS; i++)
+        masks[i] = 1u << ((key * bloomSalts[i]) >> 27);
+}
+
+#if defined(__AVX2__) && !defined(EXTLIB_NO_SIMD)
+static inline __m256i bloomMasks256(uint32_t key) {
+    __m256i salts = _mm256_loadu_si256((const __m256i *)bloomSalts);
+    __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salts), 27);
+
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+}
+#endif
+
+static inline void bloomBlockAdd(uint32_t *block, uint32_t key) {
+#if defined(__AVX2__) && !defined(EXTLIB_NO_SIMD)
+    _mm256_store_si256((__m256i *)block, _mm256_or_si256(_mm256_load_si256((const __m256i *)block), bloomMasks256(key)));
+#else
+    uint32_t masks[BLOCKWORDS];
+
+    bloomMasks(key, masks);
+
+    for(int i=0; i<BLOCKWORDS; i++)
+        block[i] |= masks[i];
+#endif
+}
+
+static inline bool bloomBlockContains(const uint32_t *block, uint32_t key) {
+#if defined(__AVX2__) && !defined(EXTLIB_NO_SIMD)
+    return _mm256_testc_si256(_mm256_load_si256((const __m256i *)block), bloomMasks256(key));
+#elif defined(__SSE2__) && !defined(EXTLIB_NO_SIMD)
+    uint32_t masks[BLOCKWORDS];
+
+    bloomMasks(key, masks);
+
+    // Both halves of the block must have all the bits of the masks
+    __m128i m0 = _mm_loadu_si128((const __m128i *)masks);
+    __m128i m1 = _mm_loadu_si128((const __m128i *)(masks + 4));
+    __m128i b0 = _mm_and_si128(_mm_load_si128((const __m128i *)block), m0);
+    __m128i b1 = _mm_and_si128(_mm_load_si128((const __m128i *)(block + 4)), m1);
+
+    return _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi32(b0, m0), _mm_cmpeq_epi32(b1, m1))) == 0xffff;
+#else
+    uint32_t masks[BLOCKWORDS];
+
+    bloomMasks(key, masks);
+
+    for(int i=0; i<BLOCKWORDS; i++)
+        if(!(block[i] & masks[i]))
+            return false;
+
+    return true;
+#endif
+}
+
+static double powInt(double x, long e) {
+    double res = 1;
+
+    for(; e; e >>= 1, x *= x)
+        if(e & 1)
+            res *= x;
+
+    return res;
+}
+
+// False positive rate of nbBlocks blocks holding n keys. The keys of a block follow a Poisson law, a block of i keys
+// answers yes to a missing key when its 8 bits are set. Weights are relative to the mode, so no exponential is needed.
+static double bloomFpRate(double n, double nbBlocks) {
+    double lambda = n / nbBlocks;
+    long mode = (long)lambda;
+    double q = powInt(31.0/32, mode); // probability that a bit of a word is still clear
+    double mass = 0, fp = 0;
+
+    double w = 1, qi = q;
+    for(long i=mode; w > 1e-15; i++) {
+        mass += w;
+        fp += w * powInt(1 - qi, BLOCKWORDS);
+        w *= lambda / (i+1);
+        qi *= 31.0/32;
+    }
+
+    w = 1, qi = q;
+    for(long i=mode; i > 0 && w > 1e-15; i--) {
+        w *= i / lambda;
+        qi *= 32.0/31;
+        mass += w;
+        fp += w * powInt(1 - qi, BLOCKWORDS);
+    }
+
+    return fp / mass;
+}
+
+// Smallest number of blocks reaching fpRate, found by dichotomy
+static uint64_t bloomNbBlocks(int capacity, double fpRate) {
+    uint64_t low = 1, high = 1;
+
+    if(capacity <= 0)
+        return 1;
+
+    while(bloomFpRate(capacity, high) > fpRate && high < (uint64_t)capacity)
+        high *= 2;
+
+    while(low < high) {
+        uint64_t mid = (low + high) / 2;
+
+        if(bloomFpRate(capacity, mid) > fpRate)
+            low = mid+1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+static BloomFilter bloomFilterAlloc(int keySize, ElHashFct hashFct, uint64_t nbBlocks) {
+    BloomFilter f = malloc(sizeof(struct _BloomFilter));
+
+    f->keySize = keySize;
+    f->elemSize = filterElemSize(keySize);
+    f->hashFct = hashFct;
+    f->length = 0;
+
+    f->nbBlocks = nbBlocks;
+    f->buffer = calloc(nbBlocks*BLOCKSIZE + BLOCKSIZE, 1);
+    f->blocks = f->buffer + (BLOCKSIZE - (uintptr_t)f->buffer % BLOCKSIZE) % BLOCKSIZE;
+
+    return f;
+}
+
+BloomFilter bloomFilterNew(int keySize, ElHashFct hashFct, int capacity, double fpRate) {
+    return bloomFilterAlloc(keySize, filterHashFct(keySize, hashFct), bloomNbBlocks(capacity, fpRate));
+}
+
+void bloomFilterDel(BloomFilter f) {
+    free(f->buffer);
+    free(f);
+}
+
+void bloomFilterClear(BloomFilter f) {
+    memset(f->blocks, 0, f->nbBlocks*BLOCKSIZE);
+    f->length = 0;
+}
+
+long bloomFilterLength(const BloomFilter f) {
+    return f->length;
+}
+
+void bloomFilterAdd_base(BloomFilter f, const Ptr key) {
+    uint64_t hash = filterHash(f->hashFct, key, 0);
+
+    bloomBlockAdd(bloomBlock(f, hash), hash);
+    f->length++;
+}
+
+void bloomFilterAddMany(BloomFilter f, const Ptr keys, int nbKeys) {
+    for(int i=0; i<nbKeys; i++)
+        bloomFilterAdd_base(f, keys + (size_t)i*f->elemSize);
+}
+
+bool bloomFilterContains_base(const BloomFilter f, const Ptr key) {
+    uint64_t hash = filterHash(f->hashFct, key, 0);
+
+    return bloomBlockContains(bloomBlock(f, hash), hash);
+}
+
+int bloomFilterContainsMany(const BloomFilter f, const Ptr keys, int nbKeys, bool *results) {
+    uint64_t hashes[BATCH];
+    int count = 0;
+
+    for(int from=0; from<nbKeys; from+=BATCH) {
+        int n = nbKeys-from < BATCH ? nbKeys-from : BATCH;
+
+        // The memory accesses of a whole batch are in flight at the same time
+        for(int i=0; i<n; i++) {
+            hashes[i] = filterHash(f->hashFct, keys + (size_t)(from+i)*f->elemSize, 0);
+            __builtin_prefetch(bloomBlock(f, hashes[i]));
+        }
+
+        for(int i=0; i<n; i++) {
+            bool res = bloomBlockContains(bloomBlock(f, hashes[i]), hashes[i]);
+
+            if(results)
+                results[from+i] = res;
+            count += res;
+        }
+    }
+
+    return count;
+}
+
+bool bloomFilterSave(const BloomFilter f, const char *path) {
+    FilterFileHeader header = {BLOOM_MAGIC, SERIAL_VERSION, f->keySize, 0, 0, f->nbBlocks, f->length, 0, f->nbBlocks*BLOCKSIZE};
+
+    return filterSave(path, &header, f->blocks);
+}
+
+BloomFilter bloomFilterLoad(const char *path, ElHashFct hashFct) {
+    FilterFileHeader header;
+    FILE *file = filterOpen(path, BLOOM_MAGIC, &header, &hashFct);
+
+    if(!file)
+        return NULL;
+
+    if(header.nbBuckets == 0 || header.nbBuckets > UINT32_MAX || header.dataSize != header.nbBuckets*BLOCKSIZE) {
+        fclose(file);
+        return NULL;
+    }
+
+    BloomFilter f = bloomFilterAlloc(header.keySize, hashFct, header.nbBuckets);
+
+    if(!filterRead(file, f->blocks, header.dataSize)) {
+        bloomFilterDel(f);
+        return NULL;
+    }
+
+    f->length = header.length;
+
+    return f;
+}
+
+void bloomFilterDump(const BloomFilter f) {
+    long effcost = f->nbBlocks*BLOCKSIZE;
+    long opcost = sizeof(struct _BloomFilter) + BLOCKSIZE;
+
+    printf("Bloom filter at %p\n", f);
+    printf("\t%ld keys added, %lu blocks of %d bytes\n", f->length, (unsigned long)f->nbBlocks, (int)BLOCKSIZE);
+    printf("\t%ld bytes used for blocks\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes total used\n", effcost+opcost);
+}
+
+
+
+// Cuckoo filter
+
+static inline uint32_t cuckooFingerprint(const CuckooFilter f, uint64_t hash) {
+    uint32_t fp = hash & (f->fpBytes == 1 ? 0xff : 0xffff);
+
+    return fp ? fp : 1;
+}
+
+static inline uint64_t cuckooBucket(const CuckooFilter f, uint64_t hash) {
+    return (hash >> 32) & (f->nbBuckets-1);
+}
+
+// The other bucket of a fingerprint only depends on the fingerprint, so it can be found back from either bucket
+static inline uint64_t cuckooAltBucket(const CuckooFilter f, uint64_t bucket, uint32_t fp) {
+    return (bucket ^ ((fp * 0xc4ceb9fe1a85ec53ull) >> 32)) & (f->nbBuckets-1);
+}
+
+static inline uint32_t cuckooGet(const CuckooFilter f, uint64_t slot) {
+    return f->fpBytes == 1 ? ((uint8_t *)f->table)[slot] : ((uint16_t *)f->table)[slot];
+}
+
+static inline void cuckooSet(CuckooFilter f, uint64_t slot, uint32_t fp) {
+    if(f->fpBytes == 1)
+        ((uint8_t *)f->table)[slot] = fp;
+    else
+        ((uint16_t *)f->table)[slot] = fp;
+}
+
+// Tells whether a bucket holds fp, comparing its 4 slots at once : a slot equal to fp becomes 0 after the xor
+static inline bool cuckooBucketHas(const CuckooFilter f, uint64_t bucket, uint32_t fp) {
+    if(f->fpBytes == 1) {
+        uint32_t v;
+        memcpy(&v, (uint8_t *)f->table + bucket*BUCKETSLOTS, sizeof(v));
+        v ^= fp * 0x01010101u;
+        return (v - 0x01010101u) & ~v & 0x80808080u;
+    }
+
+    uint64_t v;
+    memcpy(&v, (uint16_t *)f->table + bucket*BUCKETSLOTS, sizeof(v));
+    v ^= fp * 0x0001000100010001ull;
+    return (v - 0x0001000100010001ull) & ~v & 0x8000800080008000ull;
+}
+
+// Slot of fp in a bucket, -1 if none. fp may be 0 to find an empty slot
+static inline int cuckooBucketFind(const CuckooFilter f, uint64_t bucket, uint32_t fp) {
+    for(int i=0; i<BUCKETSLOTS; i++)
+        if(cuckooGet(f, bucket*BUCKETSLOTS + i) == fp)
+            return i;
+
+    return -1;
+}
+
+static inline bool cuckooBucketInsert(CuckooFilter f, uint64_t bucket, uint32_t fp) {
+    int i = cuckooBucketFind(f, bucket, 0);
+
+    if(i < 0)
+        return false;
+
+    cuckooSet(f, bucket*BUCKETSLOTS + i, fp);
+
+    return true;
+}
+
+static CuckooFilter cuckooFilterAlloc(int keySize, ElHashFct hashFct, int fpBytes, uint64_t nbBuckets) {
+    CuckooFilter f = malloc(sizeof(struct _CuckooFilter));
+
+    f->keySize = keySize;
+    f->elemSize = filterElemSize(keySize);
+    f->hashFct = hashFct;
+    f->length = 0;
+
+    f->fpBytes = fpBytes;
+    f->nbBuckets = nbBuckets;
+    f->victim = 0;
+    f->rng = 0x9e3779b97f4a7c15ull;
+    f->table = calloc(nbBuckets*BUCKETSLOTS, fpBytes);
+
+    return f;
+}
+
+CuckooFilter cuckooFilterNew(int keySize, ElHashFct hashFct, int capacity, double fpRate) {
+    uint64_t nbBuckets = 1;
+
+    while(nbBuckets*BUCKETSLOTS*MAXLOAD < capacity)
+        nbBuckets *= 2;
+
+    // A missing key is compared to the 2*BUCKETSLOTS fingerprints of its buckets
+    int fpBytes = fpRate >= 2.0*BUCKETSLOTS / 256 ? 1 : 2;
+
+    return cuckooFilterAlloc(keySize, filterHashFct(keySize, hashFct), fpBytes, nbBuckets);
+}
+
+void cuckooFilterDel(CuckooFilter f) {
+    free(f->table);
+    free(f);
+}
+
+void cuckooFilterClear(CuckooFilter f) {
+    memset(f->table, 0, f->nbBuckets*BUCKETSLOTS*f->fpBytes);
+    f->length = 0;
+    f->victim = 0;
+}
+
+long cuckooFilterLength(const CuckooFilter f) {
+    return f->length;
+}
+
+bool cuckooFilterAdd_base(CuckooFilter f, const Ptr key) {
+    if(f->victim)
+        return false;
+
+    uint64_t hash = filterHash(f->hashFct, key, 0);
+    uint32_t fp = cuckooFingerprint(f, hash);
+    uint64_t bucket = cuckooBucket(f, hash);
+
+    f->length++;
+
+    if(cuckooBucketInsert(f, bucket, fp) || cuckooBucketInsert(f, cuckooAltBucket(f, bucket, fp), fp))
+        return true;
+
+    // Both buckets are full : fingerprints are kicked to their other bucket until one finds an empty slot
+    if(f->rng & 1)
+        bucket = cuckooAltBucket(f, bucket, fp);
+
+    for(int kick=0; kick<MAXKICKS; kick++) {
+        f->rng ^= f->rng << 13;
+        f->rng ^= f->rng >> 7;
+        f->rng ^= f->rng << 17;
+
+        uint64_t slot = bucket*BUCKETSLOTS + f->rng % BUCKETSLOTS;
+        uint32_t kicked = cuckooGet(f, slot);
+
+        cuckooSet(f, slot, fp);
+        fp = kicked;
+        bucket = cuckooAltBucket(f, bucket, fp);
+
+        if(cuckooBucketInsert(f, bucket, fp))
+            return true;
+    }
+
+    // The last kicked fingerprint is kept aside, so the key stays found, but the filter accepts no more keys
+    f->victim = bucket << 16 | fp;
+
+    return true;
+}
+
+bool cuckooFilterRemove_base(CuckooFilter f, const Ptr key) {
+    uint64_t hash = filterHash(f->hashFct, key, 0);
+    uint32_t fp = cuckooFingerprint(f, hash);
+    uint64_t bucket = cuckooBucket(f, hash);
+    uint64_t alt = cuckooAltBucket(f, bucket, fp);
+    int i;
+
+    if(f->victim && (f->victim & 0xffff) == fp && ((f->victim >> 16) == bucket || (f->victim >> 16) == alt)) {
+        f->victim = 0;
+        f->length--;
+        return true;
+    }
+
+    if((i = cuckooBucketFind(f, bucket, fp)) >= 0)
+        cuckooSet(f, bucket*BUCKETSLOTS + i, 0);
+    else if((i = cuckooBucketFind(f, alt, fp)) >= 0)
+        cuckooSet(f, alt*BUCKETSLOTS + i, 0);
+    else
+        return false;
+
+    f->length--;
+
+    // The freed slot may take the victim back
+    if(f->victim) {
+        uint32_t vfp = f->victim & 0xffff;
+        uint64_t vbucket = f->victim >> 16;
+
+        if(cuckooBucketInsert(f, vbucket, vfp) || cuckooBucketInsert(f, cuckooAltBucket(f, vbucket, vfp), vfp))
+            f->victim = 0;
+    }
+
+    return true;
+}
+
+static inline bool cuckooHas(const CuckooFilter f, uint64_t hash) {
+    uint32_t fp = cuckooFingerprint(f, hash);
+    uint64_t bucket = cuckooBucket(f, hash);
+    uint64_t alt = cuckooAltBucket(f, bucket, fp);
+
+    if(cuckooBucketHas(f, bucket, fp) || cuckooBucketHas(f, alt, fp))
+        return true;
+
+    return f->victim && (f->victim & 0xffff) == fp && ((f->victim >> 16) == bucket || (f->victim >> 16) == alt);
+}
+
+bool cuckooFilterContains_base(const CuckooFilter f, const Ptr key) {
+    return cuckooHas(f, filterHash(f->hashFct, key, 0));
+}
+
+int cuckooFilterContainsMany(const CuckooFilter f, const Ptr keys, int nbKeys, bool *results) {
+    uint64_t hashes[BATCH];
+    int count = 0;
+
+    for(int from=0; from<nbKeys; from+=BATCH) {
+        int n = nbKeys-from < BATCH ? nbKeys-from : BATCH;
+
+        for(int i=0; i<n; i++) {
+            hashes[i] = filterHash(f->hashFct, keys + (size_t)(from+i)*f->elemSize, 0);
+
+            uint64_t bucket = cuckooBucket(f, hashes[i]);
+            __builtin_prefetch(f->table + bucket*BUCKETSLOTS*f->fpBytes);
+            __builtin_prefetch(f->table + cuckooAltBucket(f, bucket, cuckooFingerprint(f, hashes[i]))*BUCKETSLOTS*f->fpBytes);
+        }
+
+        for(int i=0; i<n; i++) {
+            bool res = cuckooHas(f, hashes[i]);
+
+            if(results)
+                results[from+i] = res;
+            count += res;
+        }
+    }
+
+    return count;
+}
+
+bool cuckooFilterSave(const CuckooFilter f, const char *path) {
+    FilterFileHeader header = {CUCKOO_MAGIC, SERIAL_VERSION, f->keySize, 8*f->fpBytes, 0, f->nbBuckets, f->length, f->victim,
+                               f->nbBuckets*BUCKETSLOTS*f->fpBytes};
+
+    return filterSave(path, &header, f->table);
+}
+
+CuckooFilter cuckooFilterLoad(const char *path, ElHashFct hashFct) {
+    FilterFileHeader header;
+    FILE *file = filterOpen(path, CUCKOO_MAGIC, &header, &hashFct);
+
+    if(!file)
+        return NULL;
+
+    int fpBytes = header.fpBits / 8;
+
+    if((header.fpBits != 8 && header.fpBits != 16) || header.nbBuckets == 0 || (header.nbBuckets & (header.nbBuckets-1)) != 0
+       || header.nbBuckets > UINT32_MAX || header.dataSize != header.nbBuckets*BUCKETSLOTS*fpBytes
+       || (header.victim >> 16) >= header.nbBuckets || (header.victim & 0xffff) >= (1u << header.fpBits)) {
+        fclose(file);
+        return NULL;
+    }
+
+    CuckooFilter f = cuckooFilterAlloc(header.keySize, hashFct, fpBytes, header.nbBuckets);
+
+    if(!filterRead(file, f->table, header.dataSize)) {
+        cuckooFilterDel(f);
+        return NULL;
+    }
+
+    f->length = header.length;
+    f->victim = header.victim;
+
+    return f;
+}
+
+void cuckooFilterDump(const CuckooFilter f) {
+    long effcost = f->length*f->fpBytes;
+    long opcost = sizeof(struct _CuckooFilter);
+    long preallcost = f->nbBuckets*BUCKETSLOTS*f->fpBytes - effcost;
+
+    printf("Cuckoo filter at %p\n", f);
+    printf("\t%ld keys, fingerprints of %d bits\n", f->length, 8*f->fpBytes);
+    printf("\t%ld bytes used for fingerprints\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes used as preallocated\n", preallcost);
+    printf("\t%ld bytes total used\n", effcost+opcost+preallcost);
+}
+
+
+
+// Xor filter
+
+static inline uint32_t xorFingerprint(uint64_t hash) {
+    return hash ^ (hash >> 32);
+}
+
+// Slot of a hash in segment i
+static inline uint32_t xorSlot(uint64_t hash, int i, uint32_t blockLength) {
+    uint64_t rotated = i ? (hash << (21*i)) | (hash >> (64 - 21*i)) : hash;
+
+    return i*blockLength + reduce(rotated, blockLength);
+}
+
+static inline uint32_t xorGet(const void *table, int fpBytes, uint32_t slot) {
+    return fpBytes == 1 ? ((const uint8_t *)table)[slot] : ((const uint16_t *)table)[slot];
+}
+
+static inline bool xorHas(const XorFilter f, uint64_t hash) {
+    uint32_t fp = xorGet(f->table, f->fpBytes, xorSlot(hash, 0, f->blockLength))
+                ^ xorGet(f->table, f->fpBytes, xorSlot(hash, 1, f->blockLength))
+                ^ xorGet(f->table, f->fpBytes, xorSlot(hash, 2, f->blockLength));
+
+    return fp == (xorFingerprint(hash) & (f->fpBytes == 1 ? 0xff : 0xffff));
+}
+
+static int compareHashes(const void *h1, const void *h2) {
+    uint64_t a = *(const uint64_t *)h1, b = *(const uint64_t *)h2;
+
+    return (a > b) - (a < b);
+}
+
+// Finds an order in which each key has a slot that no later key uses (peeling), then sets the fingerprints in the
+// reverse order : the slot of a key is chosen so that the xor of its 3 slots is its fingerprint.
+static bool xorPeel(XorFilter f, const uint64_t *baseHashes, uint32_t n) {
+    uint32_t capacity = 3*f->blockLength;
+    uint64_t *xorMask = calloc(capacity, sizeof(uint64_t));
+    uint32_t *count = calloc(capacity, sizeof(uint32_t));
+    uint32_t *queue = malloc(capacity * sizeof(uint32_t));
+    uint64_t *stackHash = malloc((n+1) * sizeof(uint64_t));
+    uint32_t *stackSlot = malloc((n+1) * sizeof(uint32_t));
+    uint32_t queueLength = 0, stackLength = 0;
+
+    // Each slot holds the xor of the hashes mapped to it : once a single one is left, it is that hash
+    for(uint32_t k=0; k<n; k++) {
+        uint64_t hash = _elHashMix64(baseHashes[k] ^ f->seed);
+
+        for(int i=0; i<3; i++) {
+            uint32_t slot = xorSlot(hash, i, f->blockLength);
+            xorMask[slot] ^= hash;
+            count[slot]++;
+        }
+    }
+
+    for(uint32_t slot=0; slot<capacity; slot++)
+        if(count[slot] == 1)
+            queue[queueLength++] = slot;
+
+    while(queueLength > 0) {
+        uint32_t slot = queue[--queueLength];
+
+        if(count[slot] != 1)
+            continue;
+
+        uint64_t hash = xorMask[slot];
+
+        stackHash[stackLength] = hash;
+        stackSlot[stackLength++] = slot;
+
+        for(int i=0; i<3; i++) {
+            uint32_t other = xorSlot(hash, i, f->blockLength);
+
+            xorMask[other] ^= hash;
+
+            if(--count[other] == 1)
+                queue[queueLength++] = other;
+        }
+    }
+
+    bool peeled = stackLength == n;
+
+    if(peeled) {
+        memset(f->table, 0, (size_t)capacity*f->fpBytes);
+
+        while(stackLength > 0) {
+            uint64_t hash = stackHash[--stackLength];
+            uint32_t slot = stackSlot[stackLength];
+            uint32_t fp = xorFingerprint(hash);
+
+            for(int i=0; i<3; i++) {
+                uint32_t other = xorSlot(hash, i, f->blockLength);
+
+                if(other != slot)
+                    fp ^= xorGet(f->table, f->fpBytes, other);
+            }
+
+            if(f->fpBytes == 1)
+                ((uint8_t *)f->table)[slot] = fp;
+            else
+                ((uint16_t *)f->table)[slot] = fp;
+        }
+    }
+
+    free(xorMask);
+    free(count);
+    free(queue);
+    free(stackHash);
+    free(stackSlot);
+
+    return peeled;
+}
+
+static XorFilter xorFilterAlloc(int keySize, ElHashFct hashFct, int fpBytes, uint32_t blockLength) {
+    XorFilter f = malloc(sizeof(struct _XorFilter));
+
+    f->keySize = keySize;
+    f->elemSize = filterElemSize(keySize);
+    f->hashFct = hashFct;
+    f->length = 0;
+
+    f->fpBytes = fpBytes;
+    f->seed = 0;
+    f->blockLength = blockLength;
+    f->table = calloc(3*(size_t)blockLength, fpBytes);
+
+    return f;
+}
+
+// Builds a filter from the hashes given by hashFct, which are sorted and deduplicated in place
+static XorFilter xorFilterBuild(int keySize, ElHashFct hashFct, uint64_t *baseHashes, uint32_t n, double fpRate) {
+    qsort(baseHashes, n, sizeof(uint64_t), compareHashes);
+
+    uint32_t distinct = 0;
+
+    for(uint32_t k=0; k<n; k++)
+        if(distinct == 0 || baseHashes[k] != baseHashes[distinct-1])
+            baseHashes[distinct++] = baseHashes[k];
+
+    // 1.23 slots per key, plus a few for small sets, in 3 segments
+    uint32_t blockLength = (32 + ((uint64_t)distinct*123 + 99) / 100 + 2) / 3;
+    XorFilter f = xorFilterAlloc(keySize, hashFct, fpRate >= 1.0/256 ? 1 : 2, blockLength);
+
+    f->length = distinct;
+
+    // Peeling fails with a small probability, another seed gives other slots
+    for(int attempt=0; attempt<MAXSEEDS; attempt++) {
+        f->seed = _elHashMix64(0x9e3779b97f4a7c15ull * (attempt+1));
+
+        if(xorPeel(f, baseHashes, distinct))
+            return f;
+    }
+
+    xorFilterDel(f);
+
+    return NULL;
+}
+
+XorFilter xorFilterNew(int keySize, ElHashFct hashFct, const Ptr keys, int nbKeys, double fpRate) {
+    int elemSize = filterElemSize(keySize);
+    uint64_t *baseHashes = malloc((nbKeys+1) * sizeof(uint64_t));
+
+    hashFct = filterHashFct(keySize, hashFct);
+
+    for(int k=0; k<nbKeys; k++)
+        baseHashes[k] = hashFct(keys + (size_t)k*elemSize);
+
+    XorFilter f = xorFilterBuild(keySize, hashFct, baseHashes, nbKeys, fpRate);
+
+    free(baseHashes);
+
+    return f;
+}
+
+XorFilter xorFilterNewFromArray(const Array a, int keySize, ElHashFct hashFct, double fpRate) {
+    int nbKeys = arrayLength(a);
+    uint64_t *baseHashes = malloc((nbKeys+1) * sizeof(uint64_t));
+
+    hashFct = filterHashFct(keySize, hashFct);
+
+    for(int k=0; k<nbKeys; k++)
+        baseHashes[k] = hashFct(arrayGet_base(a, k));
+
+    XorFilter f = xorFilterBuild(keySize, hashFct, baseHashes, nbKeys, fpRate);
+
+    free(baseHashes);
+
+    return f;
+}
+
+XorFilter xorFilterNewFromHash(const Hash h, double fpRate) {
+    ElHashFct hashFct = hashGetHashFunction(h);
+    uint64_t *baseHashes = malloc((hashLength(h)+1) * sizeof(uint64_t));
+    uint32_t n = 0;
+
+    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it))
+        baseHashes[n++] = hashFct(hashItGetKey_base(&it));
+
+    XorFilter f = xorFilterBuild(hashGetKeySize(h), hashFct, baseHashes, n, fpRate);
+
+    free(baseHashes);
+
+    return f;
+}
+
+void xorFilterDel(XorFilter f) {
+    free(f->table);
+    free(f);
+}
+
+long xorFilterLength(const XorFilter f) {
+    return f->length;
+}
+
+bool xorFilterContains_base(const XorFilter f, const Ptr key) {
+    return xorHas(f, filterHash(f->hashFct, key, f->seed));
+}
+
+int xorFilterContainsMany(const XorFilter f, const Ptr keys, int nbKeys, bool *results) {
+    uint64_t hashes[BATCH];
+    int count = 0;
+
+    for(int from=0; from<nbKeys; from+=BATCH) {
+        int n = nbKeys-from < BATCH ? nbKeys-from : BATCH;
+
+        for(int i=0; i<n; i++) {
+            hashes[i] = filterHash(f->hashFct, keys + (size_t)(from+i)*f->elemSize, f->seed);
+
+            for(int s=0; s<3; s++)
+                __builtin_prefetch(f->table + (size_t)xorSlot(hashes[i], s, f->blockLength)*f->fpBytes);
+        }
+
+        for(int i=0; i<n; i++) {
+            bool res = xorHas(f, hashes[i]);
+
+            if(results)
+                results[from+i] = res;
+            count += res;
+        }
+    }
+
+    return count;
+}
+
+bool xorFilterSave(const XorFilter f, const char *path) {
+    FilterFileHeader header = {XOR_MAGIC, SERIAL_VERSION, f->keySize, 8*f->fpBytes, f->seed, f->blockLength, f->length, 0,
+                               3*(uint64_t)f->blockLength*f->fpBytes};
+
+    return filterSave(path, &header, f->table);
+}
+
+XorFilter xorFilterLoad(const char *path, ElHashFct hashFct) {
+    FilterFileHeader header;
+    FILE *file = filterOpen(path, XOR_MAGIC, &header, &hashFct);
+
+    if(!file)
+        return NULL;
+
+    int fpBytes = header.fpBits / 8;
+
+    if((header.fpBits != 8 && header.fpBits != 16) || header.nbBuckets == 0 || header.nbBuckets > UINT32_MAX/3
+       || header.dataSize != 3*header.nbBuckets*fpBytes) {
+        fclose(file);
+        return NULL;
+    }
+
+    XorFilter f = xorFilterAlloc(header.keySize, hashFct, fpBytes, header.nbBuckets);
+
+    if(!filterRead(file, f->table, header.dataSize)) {
+        xorFilterDel(f);
+        return NULL;
+    }
+
+    f->length = header.length;
+    f->seed = header.seed;
+
+    return f;
+}
+
+void xorFilterDump(const XorFilter f) {
+    long effcost = 3L*f->blockLength*f->fpBytes;
+    long opcost = sizeof(struct _XorFilter);
+
+    printf("Xor filter at %p\n", f);
+    printf("\t%ld keys, %ld fingerprints of %d bits\n", f->length, 3L*f->blockLength, 8*f->fpBytes);
+    printf("\t%ld bytes used for fingerprints\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes total used\n", effcost+opcost);
+}
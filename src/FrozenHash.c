@@ -0,0 +1,371 @@
+/**
+ * \file FrozenHash.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ * The perfect hash function follows "PTHash: Revisiting FCH Minimal Perfect Hashing" (Pibiri, Trani, 2021) : keys are
+ * split in small buckets, and the buckets are placed from the biggest one, each with the first pilot (displacement)
+ * that sends all its keys to free slots.
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/FrozenHash.h"
+
+#include "Serial.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define LAMBDA 4              // average number of keys per bucket
+#define MAXPILOT (1u << 24)   // a bucket needing more tries makes the build restart with another seed
+#define MAXSEEDS 16
+
+struct _FrozenHash {
+    const FrozenHashFileHeader *header;
+    const uint32_t *pilots;
+    const void *entries;
+    const char *strings;
+    uint64_t stringsSize;
+
+    void *block;       // the whole table, in the layout of its file
+    size_t blockSize;
+    bool mapped;       // block is the mapping of a file, else it is allocated
+};
+
+
+
+static inline uint64_t keyHash(uint64_t seed, const void *key, int length) {
+    return _elHashMix64(_elHashBytes64(key, length) ^ seed);
+}
+
+// Ranges are reduced by a multiplication instead of a division
+static inline uint32_t bucketOf(uint64_t hash, uint32_t nbBuckets) {
+    return ((hash >> 32) * nbBuckets) >> 32;
+}
+
+// The pilot is mixed with the hash : only xoring them would keep the distance between the slots of two keys nearly the same for every pilot
+static inline uint32_t slotOf(uint64_t hash, uint32_t pilot, uint32_t length) {
+    return ((uint64_t)(uint32_t)_elHashMix64(hash ^ pilot) * length) >> 32;
+}
+
+static inline bool isTaken(const uint64_t *taken, uint32_t slot) {
+    return taken[slot/64] & (1ull << (slot%64));
+}
+
+static inline void flipTaken(uint64_t *taken, uint32_t slot) {
+    taken[slot/64] ^= 1ull << (slot%64);
+}
+
+// Finds a pilot for every bucket and the slot of every key, returns false if a bucket needs too many tries
+static bool placeKeys(const uint64_t *hashes, uint32_t length, uint32_t nbBuckets, uint32_t *pilots, uint32_t *slots) {
+    uint32_t *bucketStart = calloc(nbBuckets+2, sizeof(uint32_t));
+    uint32_t *keys = malloc(length * sizeof(uint32_t));
+    uint32_t *order = malloc(nbBuckets * sizeof(uint32_t));
+    uint64_t *taken = calloc(length/64 + 1, sizeof(uint64_t));
+    uint32_t maxSize = 0;
+    bool placed = true;
+
+    // Keys grouped by bucket (counting sort)
+    for(uint32_t k=0; k<length; k++)
+        bucketStart[bucketOf(hashes[k], nbBuckets) + 2]++;
+
+    for(uint32_t b=0; b<nbBuckets; b++) {
+        if(bucketStart[b+2] > maxSize)
+            maxSize = bucketStart[b+2];
+
+        bucketStart[b+2] += bucketStart[b+1];
+    }
+
+    for(uint32_t k=0; k<length; k++)
+        keys[bucketStart[bucketOf(hashes[k], nbBuckets) + 1]++] = k;
+
+    // Buckets from the biggest to the smallest (counting sort on sizes)
+    uint32_t *sizeStart = calloc(maxSize+2, sizeof(uint32_t));
+
+    for(uint32_t b=0; b<nbBuckets; b++)
+        sizeStart[maxSize - (bucketStart[b+1] - bucketStart[b]) + 1]++;
+
+    for(uint32_t s=0; s<=maxSize; s++)
+        sizeStart[s+1] += sizeStart[s];
+
+    for(uint32_t b=0; b<nbBuckets; b++)
+        order[sizeStart[maxSize - (bucketStart[b+1] - bucketStart[b])]++] = b;
+
+    for(uint32_t i=0; i<nbBuckets && placed; i++) {
+        uint32_t b = order[i];
+        uint32_t from = bucketStart[b], to = bucketStart[b+1];
+        uint32_t pilot;
+
+        pilots[b] = 0;
+
+        if(from == to)
+            continue;
+
+        for(pilot=0; pilot<MAXPILOT; pilot++) {
+            uint32_t k;
+
+            // Takes the slots one by one, and gives them back at the first conflict
+            for(k=from; k<to; k++) {
+                uint32_t slot = slotOf(hashes[keys[k]], pilot, length);
+
+                if(isTaken(taken, slot))
+                    break;
+
+                flipTaken(taken, slot);
+                slots[keys[k]] = slot;
+            }
+
+            if(k == to)
+                break;
+
+            while(k-- > from)
+                flipTaken(taken, slots[keys[k]]);
+        }
+
+        pilots[b] = pilot;
+        placed = pilot < MAXPILOT;
+    }
+
+    free(bucketStart);
+    free(keys);
+    free(order);
+    free(taken);
+    free(sizeStart);
+
+    return placed;
+}
+
+static void frozenHashBind(FrozenHash fh, void *block, size_t blockSize, bool mapped) {
+    fh->block = block;
+    fh->blockSize = blockSize;
+    fh->mapped = mapped;
+
+    fh->header = block;
+    fh->pilots = block + fh->header->pilotsOffset;
+    fh->entries = block + fh->header->entriesOffset;
+    fh->strings = block + fh->header->stringsOffset;
+    fh->stringsSize = fh->header->fileSize - fh->header->stringsOffset;
+}
+
+
+
+FrozenHash hashFreeze(const Hash h) {
+    bool strKeys = hashHasStringKeys(h);
+
+    if(collectionGetCopyFunction((Collection)h) || (hashGetKeyCopyFunction(h) && !strKeys))
+        return NULL;
+
+    FrozenHashFileHeader header = {FROZEN_MAGIC, SERIAL_VERSION};
+    uint32_t n = hashLength(h);
+    int keySize = hashGetKeySize(h);
+
+    header.keySize = strKeys ? 0 : keySize;
+    header.elemSize = collectionGetElemSize((Collection)h);
+    header.valueOffset = SERIAL_ALIGN(strKeys ? sizeof(uint64_t) : keySize);
+    header.entrySize = SERIAL_ALIGN(header.valueOffset + header.elemSize);
+    header.nbBuckets = n/LAMBDA + 1;
+    header.length = n;
+
+    // Keys and values in the order of the hash table
+    const void **keys = malloc(n * sizeof(void *));
+    const void **values = malloc(n * sizeof(void *));
+    uint64_t stringsSize = 0;
+    uint32_t k = 0;
+
+    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it), k++) {
+        keys[k] = hashItGetKey_base(&it);
+        values[k] = hashItGet_base(&it);
+
+        if(strKeys)
+            stringsSize += strlen(*(char **)keys[k]) + 1;
+    }
+
+    header.pilotsOffset = SERIAL_ALIGN(sizeof(FrozenHashFileHeader));
+    header.entriesOffset = header.pilotsOffset + SERIAL_ALIGN(header.nbBuckets * sizeof(uint32_t));
+    header.stringsOffset = header.entriesOffset + (uint64_t)n * header.entrySize;
+    header.fileSize = header.stringsOffset + stringsSize;
+
+    void *block = calloc(header.fileSize, 1);
+    uint64_t *hashes = malloc(n * sizeof(uint64_t));
+    uint32_t *slots = malloc(n * sizeof(uint32_t));
+    bool placed = false;
+
+    // Another seed changes every hash, a failure is very unlikely to happen twice
+    for(int attempt=0; attempt<MAXSEEDS && !placed; attempt++) {
+        header.seed = _elHashMix64(0x9e3779b97f4a7c15ull * (attempt+1));
+
+        for(k=0; k<n; k++) {
+            if(strKeys)
+                hashes[k] = keyHash(header.seed, *(char **)keys[k], strlen(*(char **)keys[k]));
+            else
+                hashes[k] = keyHash(header.seed, keys[k], keySize);
+        }
+
+        placed = placeKeys(hashes, n, header.nbBuckets, block + header.pilotsOffset, slots);
+    }
+
+    FrozenHash fh = NULL;
+
+    if(placed) {
+        uint64_t stringOffset = 0;
+
+        memcpy(block, &header, sizeof(FrozenHashFileHeader));
+
+        for(k=0; k<n; k++) {
+            void *entry = block + header.entriesOffset + (uint64_t)slots[k]*header.entrySize;
+
+            if(strKeys) {
+                const char *str = *(char **)keys[k];
+
+                memcpy(entry, &stringOffset, sizeof(uint64_t));
+                memcpy(block + header.stringsOffset + stringOffset, str, strlen(str)+1);
+                stringOffset += strlen(str)+1;
+            }
+            else
+                memcpy(entry, keys[k], keySize);
+
+            memcpy(entry + header.valueOffset, values[k], header.elemSize);
+        }
+
+        fh = malloc(sizeof(struct _FrozenHash));
+        frozenHashBind(fh, block, header.fileSize, false);
+    }
+    else
+        free(block);
+
+    free(keys);
+    free(values);
+    free(hashes);
+    free(slots);
+
+    return fh;
+}
+
+
+
+// The pilots and the entries must lie inside the file, in this order, with the entry layout frozenHashSave writes.
+// Pilots are not checked : a wrong pilot gives a wrong slot, which is still inside the table and fails the key comparison
+static bool frozenHeaderValid(const FrozenHashFileHeader *header, size_t size) {
+    uint64_t keySize = header->keySize ? header->keySize : sizeof(uint64_t);
+
+    if(header->magic != FROZEN_MAGIC || header->version != SERIAL_VERSION || header->nbBuckets == 0)
+        return false;
+
+    if(header->valueOffset != SERIAL_ALIGN(keySize) || header->entrySize != SERIAL_ALIGN(header->valueOffset + header->elemSize))
+        return false;
+
+    if(header->fileSize != size || header->pilotsOffset % 8 != 0 || header->entriesOffset % 8 != 0
+       || header->pilotsOffset < sizeof(FrozenHashFileHeader)
+       || header->entriesOffset < header->pilotsOffset + header->nbBuckets*(uint64_t)sizeof(uint32_t)
+       || header->entriesOffset > size || header->length > (size - header->entriesOffset) / header->entrySize
+       || header->stringsOffset != header->entriesOffset + (uint64_t)header->length*header->entrySize)
+        return false;
+
+    // String lookups are bounded by the final NUL
+    if(header->keySize == 0 && header->length > 0 && (size == header->stringsOffset || ((char *)header)[size-1] != '\0'))
+        return false;
+
+    return true;
+}
+
+FrozenHash frozenHashOpen(const char *path) {
+    size_t size;
+    void *map = _elMapFile(path, sizeof(FrozenHashFileHeader), &size);
+
+    if(!map)
+        return NULL;
+
+    if(!frozenHeaderValid(map, size)) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    FrozenHash fh = malloc(sizeof(struct _FrozenHash));
+    frozenHashBind(fh, map, size, true);
+
+    return fh;
+}
+
+void frozenHashDel(FrozenHash fh) {
+    if(fh->mapped)
+        munmap(fh->block, fh->blockSize);
+    else
+        free(fh->block);
+
+    free(fh);
+}
+
+bool frozenHashSave(const FrozenHash fh, const char *path) {
+    FILE *file = fopen(path, "wb");
+
+    if(!file)
+        return false;
+
+    bool ok = fwrite(fh->block, 1, fh->blockSize, file) == fh->blockSize;
+
+    return fclose(file) == 0 && ok;
+}
+
+
+
+int frozenHashLength(const FrozenHash fh) {
+    return fh->header->length;
+}
+
+bool frozenHashHasStringKeys(const FrozenHash fh) {
+    return fh->header->keySize == 0;
+}
+
+// The only slot where the key can be
+static inline const void *frozenHashSlot(const FrozenHash fh, uint64_t hash) {
+    uint32_t pilot = fh->pilots[bucketOf(hash, fh->header->nbBuckets)];
+
+    return fh->entries + (uint64_t)slotOf(hash, pilot, fh->header->length) * fh->header->entrySize;
+}
+
+const Ptr frozenHashGet_base(const FrozenHash fh, const Ptr key) {
+    if(fh->header->keySize == 0 || fh->header->length == 0)
+        return NULL;
+
+    const void *entry = frozenHashSlot(fh, keyHash(fh->header->seed, key, fh->header->keySize));
+
+    if(memcmp(entry, key, fh->header->keySize) != 0)
+        return NULL;
+
+    return (Ptr)entry + fh->header->valueOffset;
+}
+
+const Ptr frozenHashGetStr(const FrozenHash fh, const char *key) {
+    if(fh->header->keySize != 0 || fh->header->length == 0)
+        return NULL;
+
+    const void *entry = frozenHashSlot(fh, keyHash(fh->header->seed, key, strlen(key)));
+    uint64_t offset = *(const uint64_t *)entry;
+
+    if(offset >= fh->stringsSize || strcmp(fh->strings + offset, key) != 0)
+        return NULL;
+
+    return (Ptr)entry + fh->header->valueOffset;
+}
+
+
+
+void frozenHashDump(const FrozenHash fh) {
+    int elts = fh->header->length;
+    int keySize = fh->header->keySize ? fh->header->keySize : sizeof(uint64_t);
+    long effcost = (long)elts*(keySize + fh->header->elemSize) + fh->stringsSize;
+    long opcost = sizeof(struct _FrozenHash) + fh->header->entriesOffset + (long)elts*(fh->header->entrySize - keySize - fh->header->elemSize);
+
+    printf("Frozen hash table at %p%s\n", fh, fh->mapped ? " (mapped)" : "");
+    printf("\t%d elements, each using %d bytes\n", elts, keySize + fh->header->elemSize);
+    printf("\t%ld bytes used for elements\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes total used\n", effcost+opcost);
+}
@@ -5,18 +5,34 @@
  *
  * Copyright 2014-2016
  *
+ * Entries are stored in insertion order in a dense array, and an open-addressing index of entry numbers finds
+ * them, like the compact dictionaries of CPython. Removed entries stay in the array until it is compacted.
+ *
  */
 
 #include "ExtLib/Common.h"
 #include "ExtLib/Collection.h"
 #include "ExtLib/Hash.h"
+#include "ExtLib/StringPool.h"
+
+#include "Serial.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-#define DEFSIZE 13 // prime number
+#define DEFSIZE 16 // power of 2
+
+// Slots of the index which don't hold an entry number
+#define EMPTY   -1
+#define DUMMY   -2 // the entry was removed, lookups probe past it
+
+typedef struct {
+    uint32_t hash;  // low bits of the mixed hash of the key
+    uint32_t live;  // false once removed
+} HashEntry;        // followed by the key and the value, laid out as a pair of hashCopyToRaw
 
 struct _Hash {
     RealType type;
@@ -33,84 +49,129 @@ struct _Hash {
     ElDelFct keyDelFct;
 
     ElHashFct hashFct;
-    int size;
-    HashNode *ct;
-};
+    int size;         // number of slots of the index, power of 2
+    int32_t *index;   // entry number of each slot, EMPTY or DUMMY
 
-struct _HashNode {
-    HashNode next;
-    void *data;
+    int used;         // entries appended since the last compaction, live or removed
+    int capacity;     // entries allocated, 3/4 of size so that the index always has empty slots
+    int entrySize;
+    void *entries;
 };
 
 
 
-static bool isPrime(int number) { // number must be >= 4
-    if (number%2==0 || number%3==0)
-        return false;     // check if number is divisible by 2 or 3
-    else {
-        for (int i=5; i*i<=number; i+=6)
-            if (number % i == 0 || number%(i + 2) == 0)
-                return false;
+static inline int hashValueOffset(const Hash h) {
+    return (h->keySize + 7) & ~7;
+}
 
-        return true;
-    }
+int hashGetPairSize(const Hash h) {
+    return (hashValueOffset(h) + h->elemSize + 7) & ~7;
 }
 
-static void hashResize(const Hash h, int minSize) {
-    struct _Hash h2 = *h;
+static inline HashEntry *entryAt(const Hash h, int i) {
+    return (HashEntry *)(h->entries + (size_t)i*h->entrySize);
+}
 
-    h2.length = 0;
+static inline void *entryKey(const Hash h, int i) {
+    return h->entries + (size_t)i*h->entrySize + sizeof(HashEntry);
+}
 
-    if(minSize < DEFSIZE)
-        h2.size = DEFSIZE;
-    else {
-        int number = minSize;
-        while(!isPrime(number))
-            number++;
-        h2.size = number;
-    }
+static inline void *entryValue(const Hash h, int i) {
+    return h->entries + (size_t)i*h->entrySize + sizeof(HashEntry) + hashValueOffset(h);
+}
+
+static inline uint32_t hashOf(const Hash h, const Ptr key) {
+    // A user hash function may leave its low bits poorly spread, and they choose where the linear probing starts
+    return _elHashMix(h->hashFct(key));
+}
 
-    h2.ct = calloc(h2.size, sizeof(HashNode));
+// Slot of the index pointing to key, or -1
+static int hashFindSlot(const Hash h, const Ptr key, uint32_t hash) {
+    int mask = h->size - 1;
 
-    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it)) {
-        hashSet_base(&h2, hashItGetKey_base(&it), hashItGet_base(&it));
-        hashItRemove(&it);
+    for(int slot = hash & mask; ; slot = (slot+1) & mask) {
+        int32_t i = h->index[slot];
+
+        if(i == EMPTY)
+            return -1;
+
+        if(i >= 0 && entryAt(h, i)->hash == hash && h->cmpFct(key, entryKey(h, i)) == 0)
+            return slot;
     }
+}
+
+// First empty or dummy slot of the probe sequence of hash
+static int hashFreeSlot(const Hash h, uint32_t hash) {
+    int mask = h->size - 1;
+    int slot = hash & mask;
 
-    free(h->ct);
+    while(h->index[slot] >= 0)
+        slot = (slot+1) & mask;
 
-    h->ct = h2.ct;
+    return slot;
 }
 
+static void hashAlloc(Hash h, int size) {
+    h->size = size;
+    h->capacity = size/4*3;
+    h->index = malloc(size * sizeof(int32_t));
+    h->entries = malloc((size_t)h->capacity * h->entrySize);
+    h->used = 0;
+
+    memset(h->index, 0xff, size * sizeof(int32_t)); // EMPTY
+}
+
+// Moves the live entries to the front of the array, in the same order, and rebuilds an index of newSize slots
+static void hashRebuild(Hash h, int newSize) {
+    int used = 0;
+
+    for(int i=0; i<h->used; i++) {
+        if(!entryAt(h, i)->live)
+            continue;
 
+        if(i != used)
+            memcpy(entryAt(h, used), entryAt(h, i), h->entrySize);
 
-static unsigned long hashString(unsigned char **strp)
-{
-    unsigned long hash = 5381;
-    unsigned char *str = *strp;
+        used++;
+    }
+
+    h->used = used;
 
-    while(*str) {
-        hash = ((hash << 5) + hash) + *str; /* hash * 33 + c */
-        str++;
+    if(newSize != h->size) {
+        h->size = newSize;
+        h->capacity = newSize/4*3;
+        h->index = realloc(h->index, newSize * sizeof(int32_t));
+        h->entries = realloc(h->entries, (size_t)h->capacity * h->entrySize);
     }
 
-    return hash;
+    memset(h->index, 0xff, h->size * sizeof(int32_t));
+
+    for(int i=0; i<used; i++)
+        h->index[hashFreeSlot(h, entryAt(h, i)->hash)] = i;
 }
 
-static int compareString(char **str1, char **str2) {
-    return strcmp(*str1, *str2);
+static void hashEntryDel(Hash h, int i) {
+    if(h->keyDelFct)
+        h->keyDelFct(entryKey(h, i));
+
+    if(h->delFct)
+        h->delFct(entryValue(h, i));
+
+    entryAt(h, i)->live = false;
+    h->length--;
 }
 
-static void copyString(char **dest, char **src) {
-    int length = strlen(*src);
 
-    *dest = malloc((length+1) * sizeof(char));
 
-    strcpy(*dest, *src);
+static unsigned long hashInterned(const char **strp) {
+    return stringPoolHash(*strp);
 }
 
-static void delString(char **obj) {
-    free(*obj);
+// Interned strings are equal if and only if they are the same pointer
+static int compareInterned(const char **str1, const char **str2) {
+    if(*str1 < *str2) return -1;
+    if(*str1 > *str2) return 1;
+    return 0;
 }
 
 
@@ -142,19 +203,31 @@ Hash hashNew(int keySize, int elemSize, ElHashFct hashFct) {
     h->keyCopyFct = NULL;
     h->keyDelFct = NULL;
 
+    if(!hashFct && keySize<=0)
+        hashFct = _elHashFct(keySize);
+
     h->hashFct = hashFct;
-    h->size = DEFSIZE;
-    h->ct = calloc(DEFSIZE, sizeof(HashNode));
+    h->entrySize = sizeof(HashEntry) + hashGetPairSize(h);
+
+    hashAlloc(h, DEFSIZE);
 
     return h;
 }
 
 Hash hashNewStr(int elemSize) {
-    Hash h = hashNew(sizeof(char *), elemSize, (ElHashFct)hashString);
+    Hash h = hashNew(sizeof(char *), elemSize, _elHashString);
+
+    h->cmpFct = _elCompareString;
+    h->keyCopyFct = _elCopyString;
+    h->keyDelFct = _elDelString;
+
+    return h;
+}
 
-    h->cmpFct = (ElCmpFct)compareString;
-    h->keyCopyFct = (ElCopyFct)copyString;
-    h->keyDelFct = (ElDelFct)delString;
+Hash hashNewInterned(int elemSize) {
+    Hash h = hashNew(sizeof(char *), elemSize, (ElHashFct)hashInterned);
+
+    h->cmpFct = (ElCmpFct)compareInterned;
 
     return h;
 }
@@ -162,7 +235,8 @@ Hash hashNewStr(int elemSize) {
 void hashDel(Hash h) {
     hashClear(h);
 
-    free(h->ct);
+    free(h->index);
+    free(h->entries);
     free(h);
 }
 
@@ -182,52 +256,71 @@ void hashElementInstanciable(Hash h, ElCopyFct copyFct, ElDelFct delFct) {
     h->delFct = delFct;
 }
 
+int hashGetKeySize(const Hash h) {
+    return h->keySize;
+}
+
+ElCopyFct hashGetKeyCopyFunction(const Hash h) {
+    return h->keyCopyFct;
+}
+
+ElDelFct hashGetKeyDelFunction(const Hash h) {
+    return h->keyDelFct;
+}
+
+ElHashFct hashGetHashFunction(const Hash h) {
+    return h->hashFct;
+}
+
+bool hashHasStringKeys(const Hash h) {
+    return h->hashFct == _elHashString || h->hashFct == (ElHashFct)hashInterned;
+}
+
 
 
 Hash hashClone(const Hash h) {
     Hash h2 = malloc(sizeof(struct _Hash));
 
-    h2->type = HASH;
-    h2->cmpFct = h->cmpFct;
+    *h2 = *h;
 
-    h2->elemSize = h->elemSize;
-    h2->copyFct = h->copyFct;
-    h2->delFct = h->delFct;
+    // Same index and same entries : copied bit by bit, then the live entries are copied again if they need it
+    h2->index = malloc(h->size * sizeof(int32_t));
+    h2->entries = malloc((size_t)h->capacity * h->entrySize);
 
-    h2->length = 0;
+    memcpy(h2->index, h->index, h->size * sizeof(int32_t));
+    memcpy(h2->entries, h->entries, (size_t)h->used * h->entrySize);
 
-    h2->keySize = h->keySize;
-    h2->keyCopyFct = h->keyCopyFct;
-    h2->keyDelFct = h->keyDelFct;
+    if(h->keyCopyFct || h->copyFct) {
+        for(int i=0; i<h->used; i++) {
+            if(!entryAt(h, i)->live)
+                continue;
 
-    h2->hashFct = h->hashFct;
+            if(h->keyCopyFct)
+                h->keyCopyFct(entryKey(h2, i), entryKey(h, i));
 
-    h2->size = h->length * 2;
-    if(h2->size < DEFSIZE)
-        h2->size = DEFSIZE;
-    else {
-        int number = h2->size;
-        while(!isPrime(number))
-            number++;
-        h2->size = number;
+            if(h->copyFct)
+                h->copyFct(entryValue(h2, i), entryValue(h, i));
+        }
     }
 
-    h2->ct = calloc(h2->size, sizeof(HashNode));
-
-    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it))
-        hashSet_base(h2, hashItGetKey_base(&it), hashItGet_base(&it));
-
     return h2;
 }
 
 
 
 void hashClear(Hash h) {
-    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it))
-        hashItRemove(&it);
+    if(h->keyDelFct || h->delFct) {
+        for(int i=0; i<h->used; i++)
+            if(entryAt(h, i)->live)
+                hashEntryDel(h, i);
+    }
+
+    h->length = 0;
 
-    h->size = DEFSIZE;
-    h->ct = realloc(h->ct, DEFSIZE * sizeof(HashNode));
+    free(h->index);
+    free(h->entries);
+
+    hashAlloc(h, DEFSIZE);
 }
 
 
@@ -243,106 +336,79 @@ int hashLength(const Hash h) {
 
 
 bool hashContains_base(const Hash h, const Ptr key) {
-    return hashGet_base(h, key) != NULL;
+    return hashFindSlot(h, key, hashOf(h, key)) >= 0;
 }
 
 
 
 const Ptr hashGet_base(const Hash h, const Ptr key) {
-    int cmpRes;
-
-    HashNode node = h->ct[h->hashFct(key)%h->size];
+    int slot = hashFindSlot(h, key, hashOf(h, key));
 
-    while((node != NULL) && ((cmpRes=h->cmpFct(key, (void *)node+sizeof(struct _HashNode))) > 0))
-        node = node->next;
+    if(slot < 0)
+        return NULL;
 
-    if(node != NULL && cmpRes == 0)
-        return node->data;
-
-    return NULL;
+    return entryValue(h, h->index[slot]);
 }
 
 
 
 void hashSet_base(Hash h, const Ptr key, const Ptr data) {
-    int index = h->hashFct(key)%h->size;
+    uint32_t hash = hashOf(h, key);
+    int slot = hashFindSlot(h, key, hash);
+    int i;
 
-    HashNode nodeSave = NULL;
-    HashNode node = h->ct[index];
-    int cmpRes;
+    if(slot >= 0) {
+        i = h->index[slot];
 
-    while((node != NULL) && ((cmpRes=h->cmpFct(key, (void *)node+sizeof(struct _HashNode))) > 0)) {
-        nodeSave = node;
-        node = node->next;
+        if(h->delFct)
+            h->delFct(entryValue(h, i));
     }
+    else { // Entry at this key does not exist
+        if(h->used == h->capacity) // Grows if more than half of the entries are live, else only compacts
+            hashRebuild(h, 2*h->length >= h->capacity ? 2*h->size : h->size);
 
-    if(node == NULL || cmpRes != 0) { // Node at this key does not exist
-
-        if(10*h->length >= 8*h->size) {
-            hashResize(h, 2*h->size);
-            hashSet_base(h, key, data);
-            return;
-        }
-
-        HashNode newnode = malloc(sizeof(struct _HashNode) + h->keySize + h->elemSize);
-        newnode->data = (void *)newnode + sizeof(struct _HashNode) + h->keySize;
-        newnode->next = node;
+        i = h->used++;
+        h->index[hashFreeSlot(h, hash)] = i;
 
-        if(nodeSave == NULL)
-            h->ct[index] = newnode;
-        else
-            nodeSave->next = newnode;
+        HashEntry *entry = entryAt(h, i);
 
-        node = newnode;
+        entry->hash = hash;
+        entry->live = true;
 
         if(h->keyCopyFct)
-            h->keyCopyFct((void *)node+sizeof(struct _HashNode), key);
+            h->keyCopyFct(entryKey(h, i), key);
         else
-            memcpy((void *)node+sizeof(struct _HashNode), key, h->keySize);
+            memcpy(entryKey(h, i), key, h->keySize);
 
         h->length++;
     }
-    else if(h->delFct)
-        h->delFct(node->data);
-
 
     if(h->copyFct)
-        h->copyFct(node->data, data);
+        h->copyFct(entryValue(h, i), data);
     else
-        memcpy(node->data, data, h->elemSize);
+        memcpy(entryValue(h, i), data, h->elemSize);
 }
 
 
 
 bool hashUnset_base(Hash h, const Ptr key) {
-    int index = h->hashFct(key)%h->size;
+    int slot = hashFindSlot(h, key, hashOf(h, key));
 
-    HashNode nodeSave = NULL;
-    HashNode node = h->ct[index];
-    int cmpRes;
-
-    while((node != NULL) && ((cmpRes=h->cmpFct(key, (void *)node+sizeof(struct _HashNode))) > 0)) {
-        nodeSave = node;
-        node = node->next;
-    }
-
-    if(node == NULL || cmpRes != 0)
+    if(slot < 0)
         return false;
 
-    if(nodeSave == NULL)
-        h->ct[index] = node->next;
-    else
-        nodeSave->next = node->next;
-
-    if(h->keyDelFct)
-        h->keyDelFct((void *)node+sizeof(struct _HashNode));
+    hashEntryDel(h, h->index[slot]);
+    h->index[slot] = DUMMY;
 
-    if(h->delFct)
-        h->delFct(node->data);
+    // Compacts once most entries are removed, so that iterations stay proportional to the length
+    if(h->used - h->length > h->length) {
+        int size = h->size;
 
-    free(node);
+        while(size > DEFSIZE && (size/2)/4*3 >= 2*h->length)
+            size /= 2;
 
-    h->length--;
+        hashRebuild(h, size);
+    }
 
     return true;
 }
@@ -351,21 +417,18 @@ bool hashUnset_base(Hash h, const Ptr key) {
 
 // Iteration
 
+static inline int nextLive(const Hash h, int i) {
+    while(i < h->used && !entryAt(h, i)->live)
+        i++;
+
+    return i;
+}
+
 HashIt hashItNew(const Hash h) {
     HashIt it;
 
     it.hash = h;
-    it.index = 0;
-
-    while(it.index < h->size && !h->ct[it.index])
-        it.index++;
-
-    if(it.index >= h->size)
-        it.node = NULL;
-    else
-        it.node = h->ct[it.index];
-
-    it.lastNode = NULL;
+    it.index = nextLive(h, 0);
     it.onNext = false;
 
     return it;
@@ -374,7 +437,7 @@ HashIt hashItNew(const Hash h) {
 
 
 bool hashItExists(const HashIt *it) {
-    return it->node != NULL;
+    return it->index < it->hash->used;
 }
 
 
@@ -382,78 +445,160 @@ bool hashItExists(const HashIt *it) {
 void hashItNext(HashIt *it) {
     if(it->onNext)
         it->onNext = false;
-    else {
-        it->lastNode = it->node;
-
-        if(it->node->next)
-            it->node = it->node->next;
-        else {
-            do {
-                it->index++;
-            } while(it->index < it->hash->size && !it->hash->ct[it->index]);
-
-            if(it->index >= it->hash->size)
-                it->node = NULL;
-            else
-                it->node = it->hash->ct[it->index];
-        }
-    }
+    else
+        it->index = nextLive(it->hash, it->index+1);
 }
 
 
 
 const Ptr hashItGetKey_base(const HashIt *it) {
-    return (void *)it->node + sizeof(struct _HashNode);
+    return entryKey(it->hash, it->index);
 }
 
 const Ptr hashItGet_base(const HashIt *it) {
-    return it->node->data;
+    return entryValue(it->hash, it->index);
 }
 
 
 
 void hashItSet_base(HashIt *it, const Ptr data) {
+    Ptr value = entryValue(it->hash, it->index);
+
     if(it->hash->delFct)
-        it->hash->delFct(it->node->data);
+        it->hash->delFct(value);
 
     if(it->hash->copyFct)
-        it->hash->copyFct(it->node->data, data);
+        it->hash->copyFct(value, data);
     else
-        memcpy(it->node->data, data, it->hash->elemSize);
+        memcpy(value, data, it->hash->elemSize);
 }
 
 
 
 void hashItRemove(HashIt *it) {
-    HashNode node = it->node;
+    Hash h = it->hash;
+    int mask = h->size - 1;
+    int slot = entryAt(h, it->index)->hash & mask;
+
+    // The slot pointing to the entry is on the probe sequence of its hash
+    while(h->index[slot] != it->index)
+        slot = (slot+1) & mask;
+
+    h->index[slot] = DUMMY;
+    hashEntryDel(h, it->index);
+
+    // Not compacted here, the entries of the iteration must stay in place
+    it->index = nextLive(h, it->index+1);
+    it->onNext = true;
+}
 
-    if(it->lastNode == NULL || it->lastNode->next != node)
-        it->hash->ct[it->index] = node->next;
-    else
-        it->lastNode->next = node->next;
 
-    if(node->next)
-        it->node = node->next;
-    else {
-        do {
-            it->index++;
-        } while(it->index < it->hash->size && !it->hash->ct[it->index]);
 
-        if(it->index >= it->hash->size)
-            it->node = NULL;
+void hashForEach(Hash h, ElActFct actFct, Ptr infos) {
+    for(int i=0; i<h->used; i++)
+        if(entryAt(h, i)->live)
+            actFct(entryValue(h, i), infos);
+}
+
+void hashCopyToRaw(const Hash h, Ptr dest) {
+    int pairSize = hashGetPairSize(h);
+
+    // Entries hold their key and value as a pair
+    for(int i=0; i<h->used; i++) {
+        if(entryAt(h, i)->live) {
+            memcpy(dest, entryKey(h, i), pairSize);
+            dest += pairSize;
+        }
+    }
+}
+
+
+
+// Binary files
+
+bool hashSave(const Hash h, const char *path) {
+    bool strKeys = hashHasStringKeys(h);
+
+    if(h->copyFct || (h->keyCopyFct && !strKeys))
+        return false;
+
+    HashFileHeader header = {HASH_MAGIC, SERIAL_VERSION};
+
+    header.keySize = strKeys ? 0 : h->keySize;
+    header.elemSize = h->elemSize;
+    header.valueOffset = 8 + SERIAL_ALIGN(strKeys ? sizeof(uint64_t) : h->keySize);
+    header.entrySize = SERIAL_ALIGN(header.valueOffset + h->elemSize);
+    header.length = h->length;
+
+    header.nbBuckets = 1;
+    while(header.nbBuckets < h->length)
+        header.nbBuckets *= 2;
+
+    uint32_t *buckets = calloc(header.nbBuckets+1, sizeof(uint32_t));
+    uint32_t *next = malloc(header.nbBuckets * sizeof(uint32_t));
+    void *entries = calloc(h->length, header.entrySize);
+    uint64_t stringsSize = 0;
+
+    // Counting sort of the entries by bucket, the first pass counts and the second one places
+    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it)) {
+        char **key = hashItGetKey_base(&it);
+        uint64_t hash = strKeys ? hashBytes(*key, strlen(*key)) : hashBytes(key, h->keySize);
+
+        buckets[(hash & (header.nbBuckets-1)) + 1]++;
+    }
+
+    for(int b=0; b<header.nbBuckets; b++) {
+        buckets[b+1] += buckets[b];
+        next[b] = buckets[b];
+    }
+
+    for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it)) {
+        char **key = hashItGetKey_base(&it);
+        uint64_t hash = strKeys ? hashBytes(*key, strlen(*key)) : hashBytes(key, h->keySize);
+        void *entry = entries + (uint64_t)next[hash & (header.nbBuckets-1)]++ * header.entrySize;
+
+        memcpy(entry, &hash, sizeof(uint64_t));
+
+        if(strKeys) {
+            memcpy(entry + 8, &stringsSize, sizeof(uint64_t));
+            stringsSize += strlen(*key) + 1;
+        }
         else
-            it->node = it->hash->ct[it->index];
+            memcpy(entry + 8, key, h->keySize);
+
+        memcpy(entry + header.valueOffset, hashItGet_base(&it), h->elemSize);
     }
 
-    if(it->hash->keyDelFct)
-        it->hash->keyDelFct((void *)node+sizeof(struct _HashNode));
+    header.bucketsOffset = SERIAL_ALIGN(sizeof(HashFileHeader));
+    header.entriesOffset = header.bucketsOffset + SERIAL_ALIGN((header.nbBuckets+1) * sizeof(uint32_t));
+    header.stringsOffset = header.entriesOffset + h->length * header.entrySize;
+    header.fileSize = header.stringsOffset + stringsSize;
 
-    if(it->hash->delFct)
-        it->hash->delFct(node->data);
+    static const char padding[8] = {0};
+    uint64_t bucketsSize = (header.nbBuckets+1) * sizeof(uint32_t);
 
-    free(node);
+    FILE *file = fopen(path, "wb");
+    bool ok = file != NULL;
 
-    it->onNext = true;
+    if(ok) {
+        ok = fwrite(&header, sizeof(HashFileHeader), 1, file) == 1
+            && fwrite(padding, 1, header.bucketsOffset - sizeof(HashFileHeader), file) == header.bucketsOffset - sizeof(HashFileHeader)
+            && fwrite(buckets, 1, bucketsSize, file) == bucketsSize
+            && fwrite(padding, 1, header.entriesOffset - header.bucketsOffset - bucketsSize, file) == header.entriesOffset - header.bucketsOffset - bucketsSize
+            && fwrite(entries, header.entrySize, h->length, file) == h->length;
+
+        // Strings are written in the order their offsets were given
+        for(HashIt it = hashItNew(h); ok && strKeys && hashItExists(&it); hashItNext(&it)) {
+            char **key = hashItGetKey_base(&it);
+            ok = fwrite(*key, 1, strlen(*key)+1, file) == strlen(*key)+1;
+        }
+
+        ok = fclose(file) == 0 && ok;
+    }
+
+    free(buckets);
+    free(next);
+    free(entries);
 
-    it->hash->length--;
+    return ok;
 }
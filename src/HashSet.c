@@ -0,0 +1,499 @@
+/**
+ * \file HashSet.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ * The layout follows the SwissTable design of Abseil : one control byte per slot, probed 16 at a time.
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/HashSet.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) && !defined(EXTLIB_NO_SIMD)
+#include <emmintrin.h>
+#define GROUP_SIMD 1
+#else
+#define GROUP_SIMD 0
+#endif
+
+#define GROUP   16   // control bytes probed at once
+#define DEFSIZE 16   // power of 2, at least GROUP
+
+// Control bytes : full slots hold the 7 low bits of the hash of their key, free slots have the sign bit set
+#define EMPTY   ((int8_t)-128)
+#define DELETED ((int8_t)-2)
+
+struct _HashSet {
+    RealType type;
+    ElCmpFct cmpFct;
+
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    int length;
+    int deleted;       // slots marked DELETED, they count in the load until the next rehash
+    bool bitwise;      // keys are integers or pointers, compared with memcmp
+
+    ElHashFct hashFct;
+    int size;          // number of slots, power of 2
+    void *keys;        // size keys, followed by the control bytes in the same block
+    int8_t *ctrl;      // size+GROUP bytes : the last GROUP ones mirror the first ones, so a group never wraps
+};
+
+
+
+// Bit i is set when the control byte i of the group matches c
+static inline unsigned groupMatch(const int8_t *group, int8_t c) {
+#if GROUP_SIMD
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)group), _mm_set1_epi8(c)));
+#else
+    unsigned mask = 0;
+
+    for(int i=0; i<GROUP; i++)
+        mask |= (unsigned)(group[i] == c) << i;
+
+    return mask;
+#endif
+}
+
+// Bit i is set when the slot i of the group is empty or deleted
+static inline unsigned groupMatchFree(const int8_t *group) {
+#if GROUP_SIMD
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    unsigned mask = 0;
+
+    for(int i=0; i<GROUP; i++)
+        mask |= (unsigned)(group[i] < 0) << i;
+
+    return mask;
+#endif
+}
+
+static inline unsigned long hashSetHash(const HashSet s, const Ptr key) {
+    return _elHashMix(s->hashFct(key));
+}
+
+static inline void *slotKey(const HashSet s, int slot) {
+    return s->keys + (size_t)slot*s->elemSize;
+}
+
+static inline void setCtrl(HashSet s, int slot, int8_t c) {
+    s->ctrl[slot] = c;
+
+    if(slot < GROUP)
+        s->ctrl[s->size + slot] = c;
+}
+
+static inline bool keysEqual(const HashSet s, const Ptr key1, const Ptr key2) {
+    if(s->bitwise)
+        return memcmp(key1, key2, s->elemSize) == 0;
+
+    return s->cmpFct(key1, key2) == 0;
+}
+
+// Slot of key, or -1. Groups are probed with triangular steps, which visit every group of a power of 2 table
+static int hashSetFind(const HashSet s, const Ptr key, unsigned long hash) {
+    int mask = s->size - 1;
+    int pos = (hash >> 7) & mask;
+    int8_t h2 = hash & 0x7f;
+
+    for(int step=GROUP; ; step+=GROUP) {
+        const int8_t *group = s->ctrl + pos;
+
+        for(unsigned match = groupMatch(group, h2); match; match &= match-1) {
+            int slot = (pos + __builtin_ctz(match)) & mask;
+
+            if(keysEqual(s, slotKey(s, slot), key))
+                return slot;
+        }
+
+        // An empty slot ends the probe sequence : the key would have been inserted there
+        if(groupMatch(group, EMPTY))
+            return -1;
+
+        pos = (pos + step) & mask;
+    }
+}
+
+// First empty or deleted slot of the probe sequence of hash
+static int hashSetFindFree(const HashSet s, unsigned long hash) {
+    int mask = s->size - 1;
+    int pos = (hash >> 7) & mask;
+
+    for(int step=GROUP; ; step+=GROUP) {
+        unsigned match = groupMatchFree(s->ctrl + pos);
+
+        if(match)
+            return (pos + __builtin_ctz(match)) & mask;
+
+        pos = (pos + step) & mask;
+    }
+}
+
+static void hashSetAlloc(HashSet s, int size) {
+    s->size = size;
+    s->keys = malloc((size_t)size*s->elemSize + size + GROUP);
+    s->ctrl = s->keys + (size_t)size*s->elemSize;
+
+    memset(s->ctrl, EMPTY, size + GROUP);
+}
+
+// Moves the keys bit by bit to a table of newSize slots, which also drops the deleted slots
+static void hashSetRehash(HashSet s, int newSize) {
+    void *oldKeys = s->keys;
+    int8_t *oldCtrl = s->ctrl;
+    int oldSize = s->size;
+
+    hashSetAlloc(s, newSize);
+    s->deleted = 0;
+
+    for(int i=0; i<oldSize; i++) {
+        if(oldCtrl[i] < 0)
+            continue;
+
+        void *key = oldKeys + (size_t)i*s->elemSize;
+        unsigned long hash = hashSetHash(s, key);
+        int slot = hashSetFindFree(s, hash);
+
+        setCtrl(s, slot, hash & 0x7f);
+        memcpy(slotKey(s, slot), key, s->elemSize);
+    }
+
+    free(oldKeys);
+}
+
+static inline bool overLoaded(long used, int size) {
+    return 8*used > 7*(long)size;
+}
+
+
+
+HashSet hashSetNew(int keySize, ElHashFct hashFct) {
+    HashSet s = malloc(sizeof(struct _HashSet));
+
+    s->type = HASHSET;
+
+    if(keySize<=0) {
+        s->elemSize = _elSizeFct(keySize);
+        s->cmpFct = _elCompareFct(keySize);
+    }
+    else {
+        s->elemSize = keySize;
+        s->cmpFct = NULL;
+    }
+
+    s->copyFct = NULL;
+    s->delFct = NULL;
+
+    s->length = 0;
+    s->deleted = 0;
+
+    s->bitwise = keySize > 0 || (keySize <= EL_POINTER && keySize >= EL_ULONGLONG) || keySize == EL_BOOL;
+
+    if(!hashFct && keySize<=0)
+        hashFct = _elHashFct(keySize);
+
+    s->hashFct = hashFct;
+
+    hashSetAlloc(s, DEFSIZE);
+
+    return s;
+}
+
+HashSet hashSetNewStr(void) {
+    HashSet s = hashSetNew(sizeof(char *), _elHashString);
+
+    s->cmpFct = _elCompareString;
+    s->bitwise = false;
+    s->copyFct = _elCopyString;
+    s->delFct = _elDelString;
+
+    return s;
+}
+
+void hashSetDel(HashSet s) {
+    hashSetClear(s);
+
+    free(s->keys);
+    free(s);
+}
+
+
+
+void hashSetComparable(HashSet s, ElCmpFct fct) {
+    s->cmpFct = fct;
+    s->bitwise = false;
+}
+
+void hashSetElementInstanciable(HashSet s, ElCopyFct copyFct, ElDelFct delFct) {
+    s->copyFct = copyFct;
+    s->delFct = delFct;
+}
+
+
+
+// Empty set with the settings of s
+static HashSet hashSetNewLike(const HashSet s) {
+    HashSet s2 = malloc(sizeof(struct _HashSet));
+
+    *s2 = *s;
+    s2->length = 0;
+    s2->deleted = 0;
+
+    hashSetAlloc(s2, DEFSIZE);
+
+    return s2;
+}
+
+HashSet hashSetClone(const HashSet s) {
+    HashSet s2 = malloc(sizeof(struct _HashSet));
+
+    *s2 = *s;
+
+    // Same size and same hashes : every key keeps its slot
+    hashSetAlloc(s2, s->size);
+    memcpy(s2->ctrl, s->ctrl, s->size + GROUP);
+
+    if(s->copyFct) {
+        for(int i=0; i<s->size; i++)
+            if(s->ctrl[i] >= 0)
+                s->copyFct(slotKey(s2, i), slotKey(s, i));
+    }
+    else
+        memcpy(s2->keys, s->keys, (size_t)s->size*s->elemSize);
+
+    return s2;
+}
+
+
+
+void hashSetClear(HashSet s) {
+    if(s->delFct)
+        for(int i=0; i<s->size; i++)
+            if(s->ctrl[i] >= 0)
+                s->delFct(slotKey(s, i));
+
+    free(s->keys);
+    hashSetAlloc(s, DEFSIZE);
+
+    s->length = 0;
+    s->deleted = 0;
+}
+
+void hashSetReserve(HashSet s, int capacity) {
+    int size = s->size;
+
+    while(overLoaded(capacity, size))
+        size *= 2;
+
+    if(size > s->size)
+        hashSetRehash(s, size);
+}
+
+
+
+bool hashSetIsEmpty(const HashSet s) {
+    return s->length == 0;
+}
+
+int hashSetLength(const HashSet s) {
+    return s->length;
+}
+
+
+
+bool hashSetContains_base(const HashSet s, const Ptr key) {
+    return hashSetFind(s, key, hashSetHash(s, key)) >= 0;
+}
+
+bool hashSetInsert_base(HashSet s, const Ptr key) {
+    unsigned long hash = hashSetHash(s, key);
+
+    if(hashSetFind(s, key, hash) >= 0)
+        return false;
+
+    if(overLoaded((long)s->length + s->deleted + 1, s->size)) {
+        // Mostly deleted slots : rehashing at the same size is enough
+        if(overLoaded(2*((long)s->length + 1), s->size))
+            hashSetRehash(s, 2*s->size);
+        else
+            hashSetRehash(s, s->size);
+    }
+
+    int slot = hashSetFindFree(s, hash);
+
+    if(s->ctrl[slot] == DELETED)
+        s->deleted--;
+
+    setCtrl(s, slot, hash & 0x7f);
+
+    if(s->copyFct)
+        s->copyFct(slotKey(s, slot), key);
+    else
+        memcpy(slotKey(s, slot), key, s->elemSize);
+
+    s->length++;
+
+    return true;
+}
+
+static void hashSetRemoveSlot(HashSet s, int slot) {
+    if(s->delFct)
+        s->delFct(slotKey(s, slot));
+
+    // Probes for other keys may have gone through this slot, so it can't become empty
+    setCtrl(s, slot, DELETED);
+
+    s->length--;
+    s->deleted++;
+}
+
+bool hashSetRemove_base(HashSet s, const Ptr key) {
+    int slot = hashSetFind(s, key, hashSetHash(s, key));
+
+    if(slot < 0)
+        return false;
+
+    hashSetRemoveSlot(s, slot);
+
+    return true;
+}
+
+
+
+HashSet hashSetUnion(const HashSet a, const HashSet b) {
+    HashSet big = a->length >= b->length ? a : b;
+    HashSet small = big == a ? b : a;
+    HashSet s = hashSetClone(big);
+
+    for(HashSetIt it = hashSetItNew(small); hashSetItExists(&it); hashSetItNext(&it))
+        hashSetInsert_base(s, hashSetItGet_base(&it));
+
+    return s;
+}
+
+HashSet hashSetIntersection(const HashSet a, const HashSet b) {
+    HashSet big = a->length >= b->length ? a : b;
+    HashSet small = big == a ? b : a;
+    HashSet s = hashSetNewLike(a);
+
+    for(HashSetIt it = hashSetItNew(small); hashSetItExists(&it); hashSetItNext(&it))
+        if(hashSetContains_base(big, hashSetItGet_base(&it)))
+            hashSetInsert_base(s, hashSetItGet_base(&it));
+
+    return s;
+}
+
+HashSet hashSetDifference(const HashSet a, const HashSet b) {
+    if(a->length <= b->length) {
+        HashSet s = hashSetNewLike(a);
+
+        for(HashSetIt it = hashSetItNew(a); hashSetItExists(&it); hashSetItNext(&it))
+            if(!hashSetContains_base(b, hashSetItGet_base(&it)))
+                hashSetInsert_base(s, hashSetItGet_base(&it));
+
+        return s;
+    }
+
+    HashSet s = hashSetClone(a);
+
+    for(HashSetIt it = hashSetItNew(b); hashSetItExists(&it); hashSetItNext(&it))
+        hashSetRemove_base(s, hashSetItGet_base(&it));
+
+    return s;
+}
+
+
+
+// Iteration
+
+// First full slot from index, or size
+static inline int nextFull(const HashSet s, int index) {
+    while(index < s->size && s->ctrl[index] < 0)
+        index++;
+
+    return index;
+}
+
+HashSetIt hashSetItNew(const HashSet s) {
+    HashSetIt it;
+
+    it.set = s;
+    it.index = nextFull(s, 0);
+
+    return it;
+}
+
+
+
+bool hashSetItExists(const HashSetIt *it) {
+    return it->index < it->set->size;
+}
+
+
+
+void hashSetItNext(HashSetIt *it) {
+    it->index = nextFull(it->set, it->index + 1);
+}
+
+
+
+const Ptr hashSetItGet_base(const HashSetIt *it) {
+    return slotKey(it->set, it->index);
+}
+
+
+
+void hashSetItRemove(HashSetIt *it) {
+    hashSetRemoveSlot(it->set, it->index);
+}
+
+
+
+void hashSetForEach(HashSet s, ElActFct actFct, Ptr infos) {
+    // Whole groups of free slots are skipped at once
+    for(int i=0; i<s->size; i+=GROUP)
+        for(unsigned full = ~groupMatchFree(s->ctrl + i) & 0xffff; full; full &= full-1)
+            actFct(slotKey(s, i + __builtin_ctz(full)), infos);
+}
+
+void hashSetAddRaw(HashSet s, Ptr rawData, int nbElements) {
+    hashSetReserve(s, s->length + nbElements);
+
+    for(int i=0; i<nbElements; i++)
+        hashSetInsert_base(s, rawData + (size_t)i*s->elemSize);
+}
+
+void hashSetCopyToRaw(const HashSet s, Ptr dest) {
+    for(int i=0; i<s->size; i+=GROUP) {
+        for(unsigned full = ~groupMatchFree(s->ctrl + i) & 0xffff; full; full &= full-1, dest += s->elemSize)
+            memcpy(dest, slotKey(s, i + __builtin_ctz(full)), s->elemSize);
+    }
+}
+
+
+
+void hashSetDump(const HashSet s) {
+    long elts = s->length;
+    long effcost = elts*s->elemSize;
+    long opcost = sizeof(struct _HashSet) + s->size + GROUP;
+    long preallcost = (long)(s->size-elts)*s->elemSize;
+
+    printf("Hash set at %p\n", s);
+    printf("\t%ld elements, each using %d bytes\n", elts, s->elemSize);
+    printf("\t%ld bytes used for elements\n", effcost);
+    printf("\t%ld bytes used as operating cost\n", opcost);
+    printf("\t%ld bytes used as preallocated\n", preallcost);
+    printf("\t%ld bytes total used\n", effcost+opcost+preallcost);
+}
@@ -11,6 +11,8 @@
 #include "ExtLib/Collection.h"
 #include "ExtLib/Heap.h"
 
+#include "CollectionMove.h"
+
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -30,6 +32,8 @@ struct _Heap {
     unsigned int length;
 
 	unsigned int size;
+    float growth;
+    int shrinkDivisor;
     Ptr *data;
 };
 
@@ -54,6 +58,8 @@ Heap heapNew(int elemSize) {
     h->length = 0;
 
     h->size = DEFSIZE;
+    h->growth = EL_DEFGROWTH;
+    h->shrinkDivisor = EL_DEFSHRINK;
     h->data = malloc(DEFSIZE * sizeof(Ptr));
 
 	return h;
@@ -76,6 +82,16 @@ void heapElementInstanciable(Heap h, ElCopyFct copyFct, ElDelFct delFct) {
     collectionElementInstanciable((Collection)h, copyFct, delFct);
 }
 
+void heapCapacityPolicy(Heap h, float growthFactor, int shrinkDivisor) {
+    h->growth = growthFactor > 1 ? growthFactor : EL_DEFGROWTH;
+
+    // A shrunk heap must be able to grow back without reaching the shrink threshold again
+    if(shrinkDivisor != EL_NEVER_SHRINK && shrinkDivisor <= h->growth)
+        shrinkDivisor = (int)h->growth + 1;
+
+    h->shrinkDivisor = shrinkDivisor;
+}
+
 
 
 Heap heapClone(const Heap h) {
@@ -94,6 +110,8 @@ Heap heapClone(const Heap h) {
     h2->size = h->length * 2;
     if(h2->size < DEFSIZE)
         h2->size = DEFSIZE;
+    h2->growth = h->growth;
+    h2->shrinkDivisor = h->shrinkDivisor;
     h2->data = malloc(h2->size * sizeof(Ptr));
 
     for(int i=0; i<h->length; i++)
@@ -115,8 +133,11 @@ void heapClear(Heap h) {
     }
 
     h->length = 0;
-    h->size = DEFSIZE;
-    h->data = realloc(h->data, DEFSIZE * sizeof(Ptr));
+
+    if(h->shrinkDivisor != EL_NEVER_SHRINK) {
+        h->size = DEFSIZE;
+        h->data = realloc(h->data, DEFSIZE * sizeof(Ptr));
+    }
 }
 
 
@@ -130,6 +151,14 @@ int heapLength(const Heap h) {
 }
 
 
+void heapReserve(Heap h, int capacity) {
+    if(capacity > (int)h->size) {
+        h->size = capacity;
+        h->data = realloc(h->data, h->size*sizeof(Ptr));
+    }
+}
+
+
 
 const Ptr heapGet_base(const Heap h) {
     return h->ptrTransform(&h->data[0]);
@@ -142,7 +171,7 @@ void heapPush_base(Heap h, const Ptr value)
 	unsigned int index, parent;
 
 	if (h->length >= h->size) {
-		h->size *= 2;
+		h->size = _elGrowSize(h->size, h->length+1, h->growth);
 		h->data = realloc(h->data, h->size*sizeof(Ptr));
 	}
 
@@ -208,8 +237,9 @@ void heapPop(Heap h)
 	h->data[index] = h->data[h->length];
 
 
-    if ((h->length <= (h->size / 4)) && (h->size / 2 >= DEFSIZE)) {
-		h->size /= 2;
+    unsigned int size = _elShrinkSize(h->size, h->length, DEFSIZE, h->growth, h->shrinkDivisor);
+    if (size != h->size) {
+		h->size = size;
 		h->data = realloc(h->data, h->size * sizeof(Ptr));
 	}
 }
@@ -237,32 +267,67 @@ void heapDump(const Heap h) {
 
 
 
-// Heapifies a non-empty array
-/*void heapify(type data[restrict], unsigned int count)
-{
-	unsigned int item, index, swap, other;
-	type temp;
+// Reorders all the slots into a heap, moving every parent down its subtree from the last one to the root
+static void heapHeapify(Heap h) {
+    unsigned int index, swap, other;
 
-	// Move every non-leaf element to the right position in its subtree
-	item = (count >> 1) - 1;
-	while (1)
-	{
-		// Find the position of the current element in its subtree
-		temp = data[item];
-		for(index = item; 1; index = swap)
-		{
-			// Find the child to swap with
-			swap = (index << 1) + 1;
-			if (swap >= count) break; // If there are no children, the current element is positioned
-			other = swap + 1;
-			if ((other < count) && CMP(data[other], data[swap])) swap = other;
-			if CMP(temp, data[swap]) break; // If the bigger child is smaller than or equal to the parent, the heap is reordered
-
-			data[index] = data[swap];
-		}
-		if (index != item) data[index] = temp;
-
-		if (!item) return;
-		--item;
-	}
-}*/
+    for(int item = h->length/2 - 1; item >= 0; item--) {
+        Ptr temp = h->data[item];
+
+        for(index = item; true; index = swap) {
+            swap = (index * 2) + 1;
+
+            if(swap >= h->length)
+                break;
+
+            other = swap + 1;
+            if((other < h->length) && h->cmpFct(h->ptrTransform(&h->data[other]), h->ptrTransform(&h->data[swap])) >= 0)
+                swap = other;
+
+            if(h->cmpFct(h->ptrTransform(&temp), h->ptrTransform(&h->data[swap])) >= 0)
+                break;
+
+            h->data[index] = h->data[swap];
+        }
+
+        h->data[index] = temp;
+    }
+}
+
+Ptr *_heapRelease(Heap h, int *length, int *size) {
+    Ptr *data = h->data;
+
+    *length = h->length;
+    *size = h->size;
+
+    free(h);
+
+    return data;
+}
+
+void _heapAdopt(Heap h, Ptr *ct, int length, int size) {
+    free(h->data);
+
+    h->length = length;
+    h->size = size;
+    h->data = ct;
+
+    heapHeapify(h);
+}
+
+
+
+void heapForEach(Heap h, ElActFct actFct, Ptr infos) {
+    for(int i=0; i<h->length; i++)
+        actFct(h->ptrTransform(&h->data[i]), infos);
+}
+
+void heapCopyToRaw(const Heap h, Ptr dest) {
+    if(!h->needsAllocation && h->elemSize == sizeof(Ptr)) {
+        memcpy(dest, h->data, h->length*sizeof(Ptr));
+        return;
+    }
+
+    for(int i=0; i<h->length; i++)
+        memcpy(dest + i*h->elemSize, h->ptrTransform(&h->data[i]), h->elemSize);
+}
@@ -13,66 +13,209 @@
 #include "ExtLib/Array.h"
 #include "ExtLib/List.h"
 #include "ExtLib/String.h"
+#include "ExtLib/Deque.h"
+#include "ExtLib/Heap.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/HashSet.h"
+
+#include "CollectionMove.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-typedef void(*ForEachFct)(Collection, ElActFct, Ptr);
-
-static ForEachFct getForEachFct(Collection c) {
-    switch(collectionGetType(c)) {
-    case ARRAY:
-        return (ForEachFct)arrayForEach;
-    case SIMPLELIST:
-        return (ForEachFct)simpleListForEach;
-    case LIST:
-        return (ForEachFct)listForEach;
-    case STRING:
-        return (ForEachFct)stringForEach;
-    default:
-        return NULL;
-    }
-}
-
+// Operations of a type of collection. Structures don't share a common prefix past the element functions, so everything
+// else goes through this table, indexed by RealType. NULL entries aren't supported by the type.
 typedef struct {
-    SimpleList list;
-    SimpleListIt it;
-} SimpleListAddData;
+    int (*length)(Collection c);
+    void (*forEach)(Collection c, ElActFct actFct, Ptr infos);
+    void (*addRaw)(Collection c, Ptr rawData, int nbElements);
+    void (*copyToRaw)(Collection c, Ptr dest);
+    void (*reserve)(Collection c, int capacity);
+    void (*clear)(Collection c);
+    bool contiguous; // elements are stored in a few blocks, so copyToRaw is cheaper than forEach
+} CollectionOps;
 
 static void toArrayAddElt(Ptr obj, Array a) {
     arrayPush_base(a, obj);
 }
 
-static void toSimpleListAddElt(Ptr obj, SimpleListAddData *data) {
-    if(simpleListGetFirst_base(data->list)) {
-        simpleListAddFirst_base(data->list, obj);
-        data->it = simpleListItNew(data->list);
+static void toListAddElt(Ptr obj, List l) {
+    listAddLast_base(l, obj);
+}
+
+static void toHeapAddElt(Ptr obj, Heap h) {
+    heapPush_base(h, obj);
+}
+
+static void toDequeAddElt(Ptr obj, Deque d) {
+    dequeAddLast_base(d, obj);
+}
+
+static void toHashSetAddElt(Ptr obj, HashSet s) {
+    hashSetInsert_base(s, obj);
+}
+
+// Appends to a singly-linked list with an iterator on its last node, so that each element is added in constant time
+static void toSimpleListAddElt(Ptr obj, SimpleListIt *it) {
+    if(!simpleListItExists(it)) {
+        simpleListAddFirst_base(it->list, obj);
+        *it = simpleListItNew(it->list);
     }
     else {
-        simpleListItAddAfter_base(&(data->it), obj);
-        simpleListItNext(&(data->it));
+        simpleListItAddAfter_base(it, obj);
+        simpleListItNext(it);
     }
 }
 
-static void toListAddElt(Ptr obj, List l) {
-    listAddLast_base(l, obj);
+static SimpleListIt simpleListItLast(SimpleList l) {
+    SimpleListIt it = simpleListItNew(l);
+
+    for(int i=1; i<simpleListLength(l); i++)
+        simpleListItNext(&it);
+
+    return it;
 }
 
-static void toHeapAddElt(Ptr obj, Heap h) {
-    heapPush_base(h, obj);
+static void simpleListForEachAdd(SimpleList l, Collection src, void (*forEach)(Collection, ElActFct, Ptr)) {
+    SimpleListIt it = simpleListItLast(l);
+
+    forEach(src, (ElActFct)toSimpleListAddElt, &it);
+}
+
+
+
+static void simpleListAddRaw(SimpleList l, Ptr rawData, int nbElements) {
+    SimpleListIt it = simpleListItLast(l);
+    int elemSize = collectionGetElemSize((Collection)l);
+
+    for(int i=0; i<nbElements; i++)
+        toSimpleListAddElt(rawData + i*elemSize, &it);
 }
 
+static void listAddRaw(List l, Ptr rawData, int nbElements) {
+    int elemSize = collectionGetElemSize((Collection)l);
+
+    for(int i=0; i<nbElements; i++)
+        listAddLast_base(l, rawData + i*elemSize);
+}
+
+static void heapAddRaw(Heap h, Ptr rawData, int nbElements) {
+    int elemSize = collectionGetElemSize((Collection)h);
+
+    heapReserve(h, heapLength(h) + nbElements);
+
+    for(int i=0; i<nbElements; i++)
+        heapPush_base(h, rawData + i*elemSize);
+}
+
+static void dequeAddRaw(Deque d, Ptr rawData, int nbElements) {
+    int elemSize = collectionGetElemSize((Collection)d);
+
+    dequeReserve(d, dequeLength(d) + nbElements);
+
+    for(int i=0; i<nbElements; i++)
+        dequeAddLast_base(d, rawData + i*elemSize);
+}
+
+static void stringCopyToRaw(String str, Ptr dest) {
+    memcpy(dest, stringCStr(str), stringLength(str));
+}
+
+
+
+static const CollectionOps collectionOps[] = {
+    [ARRAY] = {
+        (int (*)(Collection))arrayLength,
+        (void (*)(Collection, ElActFct, Ptr))arrayForEach,
+        (void (*)(Collection, Ptr, int))arrayPushMany,
+        (void (*)(Collection, Ptr))arrayCopyToRaw,
+        (void (*)(Collection, int))arrayReserve,
+        (void (*)(Collection))arrayClear,
+        true
+    },
+    [SIMPLELIST] = {
+        (int (*)(Collection))simpleListLength,
+        (void (*)(Collection, ElActFct, Ptr))simpleListForEach,
+        (void (*)(Collection, Ptr, int))simpleListAddRaw,
+        (void (*)(Collection, Ptr))simpleListCopyToRaw,
+        NULL,
+        (void (*)(Collection))simpleListClear,
+        false
+    },
+    [LIST] = {
+        (int (*)(Collection))listLength,
+        (void (*)(Collection, ElActFct, Ptr))listForEach,
+        (void (*)(Collection, Ptr, int))listAddRaw,
+        (void (*)(Collection, Ptr))listCopyToRaw,
+        NULL,
+        (void (*)(Collection))listClear,
+        false
+    },
+    [STRING] = {
+        (int (*)(Collection))stringLength,
+        (void (*)(Collection, ElActFct, Ptr))stringForEach,
+        NULL,
+        (void (*)(Collection, Ptr))stringCopyToRaw,
+        NULL,
+        (void (*)(Collection))stringClear,
+        true
+    },
+    [HEAP] = {
+        (int (*)(Collection))heapLength,
+        (void (*)(Collection, ElActFct, Ptr))heapForEach,
+        (void (*)(Collection, Ptr, int))heapAddRaw,
+        (void (*)(Collection, Ptr))heapCopyToRaw,
+        (void (*)(Collection, int))heapReserve,
+        (void (*)(Collection))heapClear,
+        true
+    },
+    [HASH] = {
+        (int (*)(Collection))hashLength,
+        (void (*)(Collection, ElActFct, Ptr))hashForEach,
+        NULL,
+        (void (*)(Collection, Ptr))hashCopyToRaw,
+        NULL,
+        (void (*)(Collection))hashClear,
+        false
+    },
+    [DEQUE] = {
+        (int (*)(Collection))dequeLength,
+        (void (*)(Collection, ElActFct, Ptr))dequeForEach,
+        (void (*)(Collection, Ptr, int))dequeAddRaw,
+        (void (*)(Collection, Ptr))dequeCopyToRaw,
+        (void (*)(Collection, int))dequeReserve,
+        (void (*)(Collection))dequeClear,
+        true
+    },
+    [HASHSET] = {
+        (int (*)(Collection))hashSetLength,
+        (void (*)(Collection, ElActFct, Ptr))hashSetForEach,
+        (void (*)(Collection, Ptr, int))hashSetAddRaw,
+        (void (*)(Collection, Ptr))hashSetCopyToRaw,
+        (void (*)(Collection, int))hashSetReserve,
+        (void (*)(Collection))hashSetClear,
+        true
+    }
+};
+
+static inline const CollectionOps *getOps(Collection c) {
+    return &collectionOps[collectionGetType(c)];
+}
+
+// Function adding one element, given as an ElActFct whose infos is the destination collection
 static ElActFct getAddFct(Collection c) {
     switch(collectionGetType(c)) {
     case ARRAY:
         return (ElActFct)toArrayAddElt;
-    case SIMPLELIST:
-        return (ElActFct)toSimpleListAddElt;
     case LIST:
         return (ElActFct)toListAddElt;
     case HEAP:
         return (ElActFct)toHeapAddElt;
+    case DEQUE:
+        return (ElActFct)toDequeAddElt;
+    case HASHSET:
+        return (ElActFct)toHashSetAddElt;
     default:
         return NULL;
     }
@@ -80,20 +223,60 @@ static ElActFct getAddFct(Collection c) {
 
 
 
-Array toArray(Collection src) {
+// Empty collections with the element settings of src
+
+static Array newArrayLike(Collection src) {
     Array a = arrayNew(collectionGetElemSize(src));
-    arrayComparable(a, collectionGetCmpFct((Collection)src));
+    arrayComparable(a, collectionGetCmpFct(src));
     collectionElementInstanciable((Collection)a, collectionGetCopyFunction(src), collectionGetDelFunction(src));
 
+    return a;
+}
+
+static SimpleList newSimpleListLike(Collection src) {
+    SimpleList l = simpleListNew(collectionGetElemSize(src));
+    simpleListComparable(l, collectionGetCmpFct(src));
+    collectionElementInstanciable((Collection)l, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+
+    return l;
+}
+
+static List newListLike(Collection src) {
+    List l = listNew(collectionGetElemSize(src));
+    listComparable(l, collectionGetCmpFct(src));
+    collectionElementInstanciable((Collection)l, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+
+    return l;
+}
+
+static Heap newHeapLike(Collection src) {
+    Heap h = heapNew(collectionGetElemSize(src));
+    heapComparable(h, collectionGetCmpFct(src));
+    collectionElementInstanciable((Collection)h, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+
+    return h;
+}
+
+static Deque newDequeLike(Collection src) {
+    Deque d = dequeNew(collectionGetElemSize(src));
+    dequeComparable(d, collectionGetCmpFct(src));
+    collectionElementInstanciable((Collection)d, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+
+    return d;
+}
+
+
+
+Array toArray(Collection src) {
+    Array a = newArrayLike(src);
+
     collectionAddAll((Collection)a, src);
 
     return a;
 }
 
 SimpleList toSimpleList(Collection src) {
-    SimpleList l = simpleListNew(collectionGetElemSize(src));
-    simpleListComparable(l, collectionGetCmpFct((Collection)src));
-    collectionElementInstanciable((Collection)l, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+    SimpleList l = newSimpleListLike(src);
 
     collectionAddAll((Collection)l, src);
 
@@ -101,9 +284,7 @@ SimpleList toSimpleList(Collection src) {
 }
 
 List toList(Collection src) {
-    List l = listNew(collectionGetElemSize(src));
-    listComparable(l, collectionGetCmpFct((Collection)src));
-    collectionElementInstanciable((Collection)l, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+    List l = newListLike(src);
 
     collectionAddAll((Collection)l, src);
 
@@ -111,50 +292,156 @@ List toList(Collection src) {
 }
 
 Heap toHeap(Collection src) {
-    Heap h = heapNew(collectionGetElemSize(src));
-    heapComparable(h, collectionGetCmpFct((Collection)src));
-    collectionElementInstanciable((Collection)h, collectionGetCopyFunction(src), collectionGetDelFunction(src));
+    Heap h = newHeapLike(src);
 
     collectionAddAll((Collection)h, src);
 
     return h;
 }
 
+Deque toDeque(Collection src) {
+    Deque d = newDequeLike(src);
 
+    collectionAddAll((Collection)d, src);
 
-void collectionAddAll(Collection dest, Collection src) {
-    ForEachFct forEachFct = getForEachFct(src);
-    ElActFct addFct = getAddFct(dest);
+    return d;
+}
 
-    SimpleListAddData simpleListAddData;
-    Ptr data;
 
-    if(collectionInstanceOf(dest, SIMPLELIST)) {
-        simpleListAddData.list = (SimpleList)dest;
-        data = &simpleListAddData;
-    }
-    else
-        data = dest;
 
-    forEachFct(src, addFct, data);
+// Move conversions : elements change owner bit by bit, their copy and delete functions are never called
+
+static void moveToArray(Ptr obj, Array a) {
+    _arrayPushMove(a, obj);
 }
 
+Array arrayFromListMove(List l) {
+    Array a = newArrayLike((Collection)l);
 
+    arrayReserve(a, listLength(l));
+    listForEach(l, (ElActFct)moveToArray, a);
 
-void collectionAddRaw(Collection dest, Ptr rawData, int nbElements) {
-    ElActFct addFct = getAddFct(dest);
-    int elemSize = collectionGetElemSize(dest);
+    // The elements belong to the array now, only the nodes are freed
+    listElementInstanciable(l, NULL, NULL);
+    listDel(l);
+
+    return a;
+}
+
+Array arrayFromSimpleListMove(SimpleList l) {
+    Array a = newArrayLike((Collection)l);
+
+    arrayReserve(a, simpleListLength(l));
+    simpleListForEach(l, (ElActFct)moveToArray, a);
+
+    simpleListElementInstanciable(l, NULL, NULL);
+    simpleListDel(l);
+
+    return a;
+}
+
+Array arrayFromHeapMove(Heap h) {
+    Array a = newArrayLike((Collection)h);
+    int length, size;
+
+    Ptr *ct = _heapRelease(h, &length, &size);
+    _arrayAdopt(a, ct, length, size);
+
+    return a;
+}
+
+Heap heapFromArrayMove(Array a) {
+    Heap h = newHeapLike((Collection)a);
+    int length, size;
+
+    Ptr *ct = _arrayRelease(a, &length, &size);
+    _heapAdopt(h, ct, length, size);
+
+    return h;
+}
+
+List listFromArrayMove(Array a) {
+    List l = listNew(collectionGetElemSize((Collection)a));
+    listComparable(l, collectionGetCmpFct((Collection)a));
 
-    SimpleListAddData simpleListAddData;
-    Ptr data;
+    // Bitwise copies into the nodes, then the array frees its storage without deleting the elements
+    arrayForEach(a, (ElActFct)toListAddElt, l);
+    listElementInstanciable(l, collectionGetCopyFunction((Collection)a), collectionGetDelFunction((Collection)a));
+
+    _arrayForget(a);
+
+    return l;
+}
+
+
+
+int collectionLength(Collection c) {
+    return getOps(c)->length(c);
+}
+
+void collectionForEach(Collection c, ElActFct actFct, Ptr infos) {
+    getOps(c)->forEach(c, actFct, infos);
+}
+
+void collectionClear(Collection c) {
+    getOps(c)->clear(c);
+}
+
+
+
+int collectionGetRawElemSize(Collection c) {
+    if(collectionInstanceOf(c, HASH))
+        return hashGetPairSize((Hash)c);
+
+    return collectionGetElemSize(c);
+}
+
+void collectionCopyToRaw(Collection c, Ptr dest) {
+    getOps(c)->copyToRaw(c, dest);
+}
+
+Ptr collectionToRaw(Collection c) {
+    Ptr raw = malloc(collectionLength(c) * collectionGetRawElemSize(c));
+
+    collectionCopyToRaw(c, raw);
+
+    return raw;
+}
+
+
+
+void collectionAddAll(Collection dest, Collection src) {
+    const CollectionOps *srcOps = getOps(src);
+    const CollectionOps *destOps = getOps(dest);
+    int length = srcOps->length(src);
+
+    if(length == 0)
+        return;
+
+    // Contiguous sources are exported in one pass, then added in bulk if no copy function is needed
+    if(srcOps->contiguous && destOps->addRaw && !collectionGetCopyFunction(dest)) {
+        Ptr raw = malloc(length * collectionGetElemSize(src));
+
+        srcOps->copyToRaw(src, raw);
+        destOps->addRaw(dest, raw, length);
+
+        free(raw);
+        return;
+    }
 
     if(collectionInstanceOf(dest, SIMPLELIST)) {
-        simpleListAddData.list = (SimpleList)dest;
-        data = &simpleListAddData;
+        simpleListForEachAdd((SimpleList)dest, src, srcOps->forEach);
+        return;
     }
-    else
-        data = dest;
 
-    for(int i=0; i<nbElements; i++)
-        addFct(rawData + i*elemSize, data);
+    if(destOps->reserve)
+        destOps->reserve(dest, destOps->length(dest) + length);
+
+    srcOps->forEach(src, getAddFct(dest), dest);
+}
+
+
+
+void collectionAddRaw(Collection dest, Ptr rawData, int nbElements) {
+    getOps(dest)->addRaw(dest, rawData, nbElements);
 }
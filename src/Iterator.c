@@ -0,0 +1,491 @@
+/**
+ * \file Iterator.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Collection.h"
+#include "ExtLib/Array.h"
+#include "ExtLib/SimpleList.h"
+#include "ExtLib/List.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/HashSet.h"
+#include "ExtLib/Iterator.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every kind of iterator starts with this structure, followed by its own state
+struct _Iterator {
+    Ptr (*next)(Iterator it);
+    void (*del)(Iterator it); // frees what the iterator owns besides itself, may be NULL
+
+    int elemSize;
+    ElCmpFct cmpFct;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    int firstSize; // size of the first object for pairs made by iteratorZip, 0 otherwise
+};
+
+typedef struct {
+    struct _Iterator base;
+    ArrayIt it;
+} ArraySource;
+
+typedef struct {
+    struct _Iterator base;
+    ListIt it;
+} ListSource;
+
+typedef struct {
+    struct _Iterator base;
+    SimpleListIt it;
+} SimpleListSource;
+
+typedef struct {
+    struct _Iterator base;
+    HashIt it;
+    bool keys;
+} HashSource;
+
+typedef struct {
+    struct _Iterator base;
+    HashSetIt it;
+} HashSetSource;
+
+typedef struct {
+    struct _Iterator base;
+    Iterator src;
+    ElPredFct predFct;
+    Ptr infos;
+} FilterIterator;
+
+typedef struct {
+    struct _Iterator base;
+    Iterator src;
+    ElMapFct mapFct;
+    Ptr infos;
+    uint64_t image[]; // elemSize bytes
+} MapIterator;
+
+typedef struct {
+    struct _Iterator base;
+    Iterator src;
+    int count; // elements left to give for take, to skip for skip
+} CountIterator;
+
+typedef struct {
+    struct _Iterator base;
+    Iterator first;
+    Iterator second;
+    uint64_t pair[]; // elemSize bytes
+} PairIterator;
+
+
+
+static Iterator iteratorAlloc(int size, Ptr (*next)(Iterator), void (*del)(Iterator)) {
+    Iterator it = malloc(size);
+
+    it->next = next;
+    it->del = del;
+
+    it->elemSize = 0;
+    it->cmpFct = NULL;
+    it->copyFct = NULL;
+    it->delFct = NULL;
+    it->firstSize = 0;
+
+    return it;
+}
+
+// Adaptors giving elements of their source keep its element settings
+static void iteratorInherit(Iterator it, const Iterator src) {
+    it->elemSize = src->elemSize;
+    it->cmpFct = src->cmpFct;
+    it->copyFct = src->copyFct;
+    it->delFct = src->delFct;
+    it->firstSize = src->firstSize;
+}
+
+
+
+// Sources
+
+static Ptr arraySourceNext(ArraySource *it) {
+    if(!arrayItExists(&it->it))
+        return NULL;
+
+    Ptr obj = arrayItGet_base(&it->it);
+    arrayItNext(&it->it);
+
+    return obj;
+}
+
+static Ptr listSourceNext(ListSource *it) {
+    if(!listItExists(&it->it))
+        return NULL;
+
+    Ptr obj = listItGet_base(&it->it);
+    listItNext(&it->it);
+
+    return obj;
+}
+
+static Ptr simpleListSourceNext(SimpleListSource *it) {
+    if(!simpleListItExists(&it->it))
+        return NULL;
+
+    Ptr obj = simpleListItGet_base(&it->it);
+    simpleListItNext(&it->it);
+
+    return obj;
+}
+
+static Ptr hashSourceNext(HashSource *it) {
+    if(!hashItExists(&it->it))
+        return NULL;
+
+    Ptr obj = it->keys ? hashItGetKey_base(&it->it) : hashItGet_base(&it->it);
+    hashItNext(&it->it);
+
+    return obj;
+}
+
+static Ptr hashSetSourceNext(HashSetSource *it) {
+    if(!hashSetItExists(&it->it))
+        return NULL;
+
+    Ptr obj = hashSetItGet_base(&it->it);
+    hashSetItNext(&it->it);
+
+    return obj;
+}
+
+Iterator iteratorNew(Collection c) {
+    Iterator it;
+
+    switch(collectionGetType(c)) {
+    case ARRAY:
+        it = iteratorAlloc(sizeof(ArraySource), (Ptr (*)(Iterator))arraySourceNext, NULL);
+        ((ArraySource *)it)->it = arrayItNew((Array)c);
+        break;
+    case LIST:
+        it = iteratorAlloc(sizeof(ListSource), (Ptr (*)(Iterator))listSourceNext, NULL);
+        ((ListSource *)it)->it = listItNew((List)c);
+        break;
+    case SIMPLELIST:
+        it = iteratorAlloc(sizeof(SimpleListSource), (Ptr (*)(Iterator))simpleListSourceNext, NULL);
+        ((SimpleListSource *)it)->it = simpleListItNew((SimpleList)c);
+        break;
+    case HASH:
+        it = iteratorAlloc(sizeof(HashSource), (Ptr (*)(Iterator))hashSourceNext, NULL);
+        ((HashSource *)it)->it = hashItNew((Hash)c);
+        ((HashSource *)it)->keys = false;
+
+        // The comparison function of a hash table is for its keys
+        it->elemSize = collectionGetElemSize(c);
+        it->copyFct = collectionGetCopyFunction(c);
+        it->delFct = collectionGetDelFunction(c);
+        return it;
+    case HASHSET:
+        it = iteratorAlloc(sizeof(HashSetSource), (Ptr (*)(Iterator))hashSetSourceNext, NULL);
+        ((HashSetSource *)it)->it = hashSetItNew((HashSet)c);
+        break;
+    default:
+        return NULL;
+    }
+
+    it->elemSize = collectionGetElemSize(c);
+    it->cmpFct = collectionGetCmpFct(c);
+    it->copyFct = collectionGetCopyFunction(c);
+    it->delFct = collectionGetDelFunction(c);
+
+    return it;
+}
+
+Iterator iteratorNewKeys(Hash h) {
+    Iterator it = iteratorAlloc(sizeof(HashSource), (Ptr (*)(Iterator))hashSourceNext, NULL);
+
+    ((HashSource *)it)->it = hashItNew(h);
+    ((HashSource *)it)->keys = true;
+
+    it->elemSize = hashGetKeySize(h);
+    it->cmpFct = collectionGetCmpFct((Collection)h);
+    it->copyFct = hashGetKeyCopyFunction(h);
+    it->delFct = hashGetKeyDelFunction(h);
+
+    return it;
+}
+
+void iteratorDel(Iterator it) {
+    if(it->del)
+        it->del(it);
+
+    free(it);
+}
+
+Ptr iteratorNext(Iterator it) {
+    return it->next(it);
+}
+
+int iteratorGetElemSize(const Iterator it) {
+    return it->elemSize;
+}
+
+
+
+// Adaptors
+
+static Ptr filterNext(FilterIterator *it) {
+    Ptr obj;
+
+    while((obj = it->src->next(it->src)) && !it->predFct(obj, it->infos));
+
+    return obj;
+}
+
+static void filterDel(FilterIterator *it) {
+    iteratorDel(it->src);
+}
+
+Iterator iteratorFilter(Iterator src, ElPredFct predFct, Ptr infos) {
+    FilterIterator *it = (FilterIterator *)iteratorAlloc(sizeof(FilterIterator), (Ptr (*)(Iterator))filterNext, (void (*)(Iterator))filterDel);
+
+    iteratorInherit(&it->base, src);
+
+    it->src = src;
+    it->predFct = predFct;
+    it->infos = infos;
+
+    return &it->base;
+}
+
+
+
+static Ptr mapNext(MapIterator *it) {
+    Ptr obj = it->src->next(it->src);
+
+    if(!obj)
+        return NULL;
+
+    it->mapFct(it->image, obj, it->infos);
+
+    return it->image;
+}
+
+static void mapDel(MapIterator *it) {
+    iteratorDel(it->src);
+}
+
+Iterator iteratorMap(Iterator src, int elemSize, ElMapFct mapFct, Ptr infos) {
+    int size = elemSize<=0 ? _elSizeFct(elemSize) : elemSize;
+    MapIterator *it = (MapIterator *)iteratorAlloc(sizeof(MapIterator) + size, (Ptr (*)(Iterator))mapNext, (void (*)(Iterator))mapDel);
+
+    it->base.elemSize = size;
+    if(elemSize<=0)
+        it->base.cmpFct = _elCompareFct(elemSize);
+
+    it->src = src;
+    it->mapFct = mapFct;
+    it->infos = infos;
+
+    return &it->base;
+}
+
+
+
+static Ptr takeNext(CountIterator *it) {
+    if(it->count <= 0)
+        return NULL;
+
+    it->count--;
+
+    return it->src->next(it->src);
+}
+
+static Ptr skipNext(CountIterator *it) {
+    for(; it->count > 0; it->count--) {
+        if(!it->src->next(it->src))
+            return NULL;
+    }
+
+    return it->src->next(it->src);
+}
+
+static void countDel(CountIterator *it) {
+    iteratorDel(it->src);
+}
+
+static Iterator countIteratorNew(Iterator src, int n, Ptr (*next)(Iterator)) {
+    CountIterator *it = (CountIterator *)iteratorAlloc(sizeof(CountIterator), next, (void (*)(Iterator))countDel);
+
+    iteratorInherit(&it->base, src);
+
+    it->src = src;
+    it->count = n;
+
+    return &it->base;
+}
+
+Iterator iteratorTake(Iterator src, int n) {
+    return countIteratorNew(src, n, (Ptr (*)(Iterator))takeNext);
+}
+
+Iterator iteratorSkip(Iterator src, int n) {
+    return countIteratorNew(src, n, (Ptr (*)(Iterator))skipNext);
+}
+
+
+
+static Ptr zipNext(PairIterator *it) {
+    Ptr obj1 = it->first->next(it->first);
+
+    if(!obj1)
+        return NULL;
+
+    Ptr obj2 = it->second->next(it->second);
+
+    if(!obj2)
+        return NULL;
+
+    memcpy(it->pair, obj1, it->first->elemSize);
+    memcpy(iteratorPairSecond(it->pair, it->first->elemSize), obj2, it->second->elemSize);
+
+    return it->pair;
+}
+
+// Chain reads the first iterator until it ends, then forgets it
+static Ptr chainNext(PairIterator *it) {
+    if(it->first) {
+        Ptr obj = it->first->next(it->first);
+
+        if(obj)
+            return obj;
+
+        iteratorDel(it->first);
+        it->first = NULL;
+    }
+
+    return it->second->next(it->second);
+}
+
+static void pairDel(PairIterator *it) {
+    if(it->first)
+        iteratorDel(it->first);
+
+    iteratorDel(it->second);
+}
+
+Iterator iteratorZip(Iterator first, Iterator second) {
+    int size = ((first->elemSize + 7) & ~7) + second->elemSize; // see iteratorPairSecond
+    PairIterator *it = (PairIterator *)iteratorAlloc(sizeof(PairIterator) + size, (Ptr (*)(Iterator))zipNext, (void (*)(Iterator))pairDel);
+
+    it->base.elemSize = size;
+    it->base.firstSize = first->elemSize;
+
+    it->first = first;
+    it->second = second;
+
+    return &it->base;
+}
+
+Iterator iteratorChain(Iterator first, Iterator second) {
+    PairIterator *it = (PairIterator *)iteratorAlloc(sizeof(PairIterator), (Ptr (*)(Iterator))chainNext, (void (*)(Iterator))pairDel);
+
+    iteratorInherit(&it->base, first);
+
+    it->first = first;
+    it->second = second;
+
+    return &it->base;
+}
+
+
+
+// Terminal operations
+
+Array iteratorCollectArray(Iterator it) {
+    Array a = arrayNew(it->elemSize);
+    Ptr obj;
+
+    arrayComparable(a, it->cmpFct);
+    arrayElementInstanciable(a, it->copyFct, it->delFct);
+
+    while((obj = it->next(it)))
+        arrayPush_base(a, obj);
+
+    iteratorDel(it);
+
+    return a;
+}
+
+void iteratorCollectHash(Iterator it, Hash h) {
+    Ptr obj;
+
+    assert(it->firstSize > 0);
+
+    while((obj = it->next(it)))
+        hashSet_base(h, obj, iteratorPairSecond(obj, it->firstSize));
+
+    iteratorDel(it);
+}
+
+void iteratorForEach(Iterator it, ElActFct actFct, Ptr infos) {
+    Ptr obj;
+
+    while((obj = it->next(it)))
+        actFct(obj, infos);
+
+    iteratorDel(it);
+}
+
+void iteratorReduce(Iterator it, Ptr acc, ElReduceFct reduceFct, Ptr infos) {
+    Ptr obj;
+
+    while((obj = it->next(it)))
+        reduceFct(acc, obj, infos);
+
+    iteratorDel(it);
+}
+
+int iteratorCount(Iterator it) {
+    int count = 0;
+
+    while(it->next(it))
+        count++;
+
+    iteratorDel(it);
+
+    return count;
+}
+
+bool iteratorAny(Iterator it, ElPredFct predFct, Ptr infos) {
+    Ptr obj;
+    bool found = false;
+
+    while(!found && (obj = it->next(it)))
+        found = predFct(obj, infos);
+
+    iteratorDel(it);
+
+    return found;
+}
+
+bool iteratorAll(Iterator it, ElPredFct predFct, Ptr infos) {
+    Ptr obj;
+    bool holds = true;
+
+    while(holds && (obj = it->next(it)))
+        holds = predFct(obj, infos);
+
+    iteratorDel(it);
+
+    return holds;
+}
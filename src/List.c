@@ -25,6 +25,8 @@ struct _List {
 
     int length;
 
+    int nodeCapacity; // 0 for one element per node, else number of elements per unrolled node
+
     ListNode first;
     ListNode last;
 };
@@ -34,6 +36,198 @@ struct _ListNode {
     ListNode prev;
 };
 
+// Unrolled node : elements are stored contiguously after the header
+typedef struct {
+    struct _ListNode link;
+    int count;
+} ListBlock;
+
+#define DEFNODESIZE 256 // bytes of elements per unrolled node
+
+// Keeps elements of unrolled nodes aligned like malloc'd memory
+#define BLOCKHEADER ((sizeof(ListBlock) + 15) & ~(size_t)15)
+
+
+
+// Unrolled nodes
+
+static inline int blockCount(const ListNode node) {
+    return ((ListBlock *)node)->count;
+}
+
+static inline void *blockElt(const List l, const ListNode node, int pos) {
+    return (void *)node + BLOCKHEADER + pos*l->elemSize;
+}
+
+// Allocates an empty node and links it between prev and next
+static ListNode blockNew(List l, ListNode prev, ListNode next) {
+    ListNode node = malloc(BLOCKHEADER + l->nodeCapacity*l->elemSize);
+
+    ((ListBlock *)node)->count = 0;
+
+    node->prev = prev;
+    node->next = next;
+
+    if(prev)
+        prev->next = node;
+    else
+        l->first = node;
+
+    if(next)
+        next->prev = node;
+    else
+        l->last = node;
+
+    return node;
+}
+
+static void blockFree(List l, ListNode node) {
+    if(node->next)
+        node->next->prev = node->prev;
+    else
+        l->last = node->prev;
+
+    if(node->prev)
+        node->prev->next = node->next;
+    else
+        l->first = node->next;
+
+    free(node);
+}
+
+// Inserts data at position pos of node, splitting it in halves if full. it (may be NULL) keeps pointing at the same element.
+static void blockInsert(List l, ListNode node, int pos, const Ptr data, ListIt *it) {
+    ListBlock *block = (ListBlock *)node;
+    void *tmp = NULL;
+
+    // data may be an element of this node, which is about to move
+    if((void *)data >= blockElt(l, node, 0) && (void *)data < blockElt(l, node, l->nodeCapacity)) {
+        tmp = malloc(l->elemSize);
+        memcpy(tmp, data, l->elemSize);
+    }
+
+    if(block->count == l->nodeCapacity) {
+        int mid = block->count/2;
+        ListNode next = blockNew(l, node, node->next);
+
+        ((ListBlock *)next)->count = block->count - mid;
+        memcpy(blockElt(l, next, 0), blockElt(l, node, mid), (block->count - mid)*l->elemSize);
+        block->count = mid;
+
+        if(it && it->node == node && it->index >= mid) {
+            it->node = next;
+            it->index -= mid;
+        }
+
+        if(pos > mid) {
+            node = next;
+            block = (ListBlock *)next;
+            pos -= mid;
+        }
+    }
+
+    memmove(blockElt(l, node, pos+1), blockElt(l, node, pos), (block->count - pos)*l->elemSize);
+
+    if(l->copyFct)
+        l->copyFct(blockElt(l, node, pos), tmp ? tmp : data);
+    else
+        memcpy(blockElt(l, node, pos), tmp ? tmp : data, l->elemSize);
+
+    free(tmp);
+
+    block->count++;
+    l->length++;
+
+    if(it && it->node == node && it->index >= pos)
+        it->index++;
+}
+
+// Removes the element at position pos of node, and frees node if it becomes empty
+static void blockRemove(List l, ListNode node, int pos) {
+    ListBlock *block = (ListBlock *)node;
+
+    if(l->delFct)
+        l->delFct(blockElt(l, node, pos));
+
+    block->count--;
+    l->length--;
+
+    if(block->count == 0)
+        blockFree(l, node);
+    else
+        memmove(blockElt(l, node, pos), blockElt(l, node, pos+1), (block->count - pos)*l->elemSize);
+}
+
+// Stable bottom-up merge sort of a contiguous buffer
+static void bufferSort(List l, void *buf, int method) {
+    int n = l->length;
+    int size = l->elemSize;
+    void *tmp = malloc(n*size);
+    void *src = buf, *dest = tmp;
+
+    for(int width=1; width<n; width*=2) {
+        for(int lo=0; lo<n; lo+=2*width) {
+            int mid = lo+width < n ? lo+width : n;
+            int hi = lo+2*width < n ? lo+2*width : n;
+            int i=lo, j=mid, k=lo;
+
+            while(i<mid && j<hi) {
+                if(method*l->cmpFct(src+j*size, src+i*size) < 0)
+                    memcpy(dest+(k++)*size, src+(j++)*size, size);
+                else
+                    memcpy(dest+(k++)*size, src+(i++)*size, size);
+            }
+
+            memcpy(dest+k*size, src+i*size, (mid-i)*size);
+            k += mid-i;
+            memcpy(dest+k*size, src+j*size, (hi-j)*size);
+        }
+
+        void *swap = src;
+        src = dest;
+        dest = swap;
+    }
+
+    if(src != buf)
+        memcpy(buf, src, n*size);
+
+    free(tmp);
+}
+
+static void listSortUnrolled(List l, int method) {
+    void *buf = malloc(l->length*l->elemSize);
+    int pos = 0;
+
+    // Elements are moved bit by bit, ownership follows them
+    for(ListNode node = l->first; node; node = node->next) {
+        memcpy(buf + pos*l->elemSize, blockElt(l, node, 0), blockCount(node)*l->elemSize);
+        pos += blockCount(node);
+    }
+
+    bufferSort(l, buf, method);
+
+    // Repacks the elements into full nodes, the remaining nodes are freed
+    ListNode node = l->first;
+    pos = 0;
+
+    while(pos < l->length) {
+        int count = l->length - pos < l->nodeCapacity ? l->length - pos : l->nodeCapacity;
+
+        memcpy(blockElt(l, node, 0), buf + pos*l->elemSize, count*l->elemSize);
+        ((ListBlock *)node)->count = count;
+        pos += count;
+        node = node->next;
+    }
+
+    while(node) {
+        ListNode next = node->next;
+        blockFree(l, node);
+        node = next;
+    }
+
+    free(buf);
+}
+
 
 
 List listNew(int elemSize) {
@@ -55,12 +249,29 @@ List listNew(int elemSize) {
 
     l->length = 0;
 
+    l->nodeCapacity = 0;
+
     l->first = NULL;
     l->last = NULL;
 
     return l;
 }
 
+List listNewUnrolled(int elemSize, int nodeSize) {
+    List l = listNew(elemSize);
+
+    if(nodeSize <= 0)
+        nodeSize = DEFNODESIZE;
+
+    l->nodeCapacity = nodeSize / l->elemSize;
+
+    // Splitting a full node must leave room in both halves
+    if(l->nodeCapacity < 2)
+        l->nodeCapacity = 2;
+
+    return l;
+}
+
 void listDel(List l) {
     listClear(l);
 
@@ -86,6 +297,15 @@ List listClone(const List l) {
     l2->cmpFct = l->cmpFct;
     l2->copyFct = l->copyFct;
     l2->delFct = l->delFct;
+    l2->nodeCapacity = l->nodeCapacity;
+
+    if(l->nodeCapacity) {
+        for(ListNode node = l->first; node; node = node->next)
+            for(int i=0; i<blockCount(node); i++)
+                listAddLast_base(l2, blockElt(l, node, i));
+
+        return l2;
+    }
 
     ListNode node = l->first;
 
@@ -105,8 +325,14 @@ void listClear(List l) {
 
     while(node) {
 
-        if(l->delFct)
-            l->delFct((void *)node+sizeof(struct _ListNode));
+        if(l->delFct) {
+            if(l->nodeCapacity) {
+                for(int i=0; i<blockCount(node); i++)
+                    l->delFct(blockElt(l, node, i));
+            }
+            else
+                l->delFct((void *)node+sizeof(struct _ListNode));
+        }
 
         nodeSave = node;
         node = node->next;
@@ -133,6 +359,19 @@ int listLength(const List l) {
 bool listContains(const List l, const Ptr data) {
     ListNode node = l->first;
 
+    if(l->nodeCapacity) {
+        for(; node; node = node->next) {
+            void *elt = blockElt(l, node, 0);
+            void *end = blockElt(l, node, blockCount(node));
+
+            for(; elt<end; elt+=l->elemSize)
+                if(l->cmpFct(elt, data) == 0)
+                    return true;
+        }
+
+        return false;
+    }
+
     while(node) {
         if(l->cmpFct((void *)node+sizeof(struct _ListNode), data) == 0)
             return true;
@@ -146,38 +385,56 @@ bool listContains(const List l, const Ptr data) {
 
 
 const Ptr listGetFirst_base(const List l) {
+    if(l->nodeCapacity)
+        return blockElt(l, l->first, 0);
+
     return (void *)l->first+sizeof(struct _ListNode);
 }
 
 const Ptr listGetLast_base(const List l) {
+    if(l->nodeCapacity)
+        return blockElt(l, l->last, blockCount(l->last)-1);
+
     return (void *)l->last+sizeof(struct _ListNode);
 }
 
 
 
 void listSetFirst_base(List l, const Ptr data) {
+    void *elt = listGetFirst_base(l);
+
     if(l->delFct)
-        l->delFct((void *)l->first+sizeof(struct _ListNode));
+        l->delFct(elt);
 
     if(l->copyFct)
-        l->copyFct((void *)l->first+sizeof(struct _ListNode), data);
+        l->copyFct(elt, data);
     else
-        memcpy((void *)l->first+sizeof(struct _ListNode), data, l->elemSize);
+        memcpy(elt, data, l->elemSize);
 }
 
 void listSetLast_base(List l, const Ptr data) {
+    void *elt = listGetLast_base(l);
+
     if(l->delFct)
-        l->delFct((void *)l->last+sizeof(struct _ListNode));
+        l->delFct(elt);
 
     if(l->copyFct)
-        l->copyFct((void *)l->last+sizeof(struct _ListNode), data);
+        l->copyFct(elt, data);
     else
-        memcpy((void *)l->last+sizeof(struct _ListNode), data, l->elemSize);
+        memcpy(elt, data, l->elemSize);
 }
 
 
 
 void listAddFirst_base(List l, const Ptr data) {
+    if(l->nodeCapacity) {
+        if(!l->first || blockCount(l->first) == l->nodeCapacity)
+            blockNew(l, NULL, l->first);
+
+        blockInsert(l, l->first, 0, data, NULL);
+        return;
+    }
+
     ListNode node = malloc(sizeof(struct _ListNode) + l->elemSize);
 
     node->next = l->first;
@@ -198,6 +455,14 @@ void listAddFirst_base(List l, const Ptr data) {
 }
 
 void listAddLast_base(List l, const Ptr data) {
+    if(l->nodeCapacity) {
+        if(!l->last || blockCount(l->last) == l->nodeCapacity)
+            blockNew(l, l->last, NULL);
+
+        blockInsert(l, l->last, blockCount(l->last), data, NULL);
+        return;
+    }
+
     ListNode node = malloc(sizeof(struct _ListNode) + l->elemSize);
 
     node->prev = l->last;
@@ -222,6 +487,11 @@ void listAddLast_base(List l, const Ptr data) {
 void listRemoveFirst(List l) {
     ListNode node = l->first;
 
+    if(l->nodeCapacity) {
+        blockRemove(l, node, 0);
+        return;
+    }
+
     l->first = node->next;
 
     if(node->next)
@@ -240,6 +510,11 @@ void listRemoveFirst(List l) {
 void listRemoveLast(List l) {
     ListNode node = l->last;
 
+    if(l->nodeCapacity) {
+        blockRemove(l, node, blockCount(node)-1);
+        return;
+    }
+
     l->last = node->prev;
 
     if(node->prev)
@@ -263,6 +538,12 @@ void listSort(List l, int method) {
     int listSize=1, numMerges, leftSize, rightSize;
     ListNode tail, left, right, next;
 
+    if(l->nodeCapacity) {
+        if(l->length > 1)
+            listSortUnrolled(l, method);
+        return;
+    }
+
     if (first && first->next) {
         do { // For each power of two<=list length
             numMerges=0,left=first;
@@ -299,6 +580,27 @@ void listSort(List l, int method) {
 
 
 void listDump(const List l) {
+    if(l->nodeCapacity) {
+        int elts = l->length;
+        int nodes = 0;
+
+        for(ListNode node = l->first; node; node = node->next)
+            nodes++;
+
+        int effcost = elts*l->elemSize;
+        int opcost = sizeof(struct _List) + nodes*BLOCKHEADER;
+        int preallcost = (nodes*l->nodeCapacity - elts)*l->elemSize;
+
+        printf("Unrolled doubly-linked list at %p\n", l);
+        printf("\t%d elements, each using %d bytes\n", elts, l->elemSize);
+        printf("\t%d nodes of %d elements\n", nodes, l->nodeCapacity);
+        printf("\t%d bytes used for elements\n", effcost);
+        printf("\t%d bytes used as operating cost\n", opcost);
+        printf("\t%d bytes used as preallocated\n", preallcost);
+        printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+        return;
+    }
+
     int elts = l->length;
     int effcost = elts*l->elemSize;
     int opcost = sizeof(struct _List) + elts*sizeof(struct _ListNode);
@@ -319,6 +621,7 @@ ListIt listItNew(const List l) {
 
     it.list = l;
     it.node = l->first;
+    it.index = 0;
     it.onNext = false;
 
     return it;
@@ -329,6 +632,7 @@ ListIt listItNewBack(const List l) {
 
     it.list = l;
     it.node = l->last;
+    it.index = l->nodeCapacity && l->last ? blockCount(l->last)-1 : 0;
     it.onNext = false;
 
     return it;
@@ -345,35 +649,58 @@ bool listItExists(const ListIt *it) {
 void listItNext(ListIt *it) {
     if(it->onNext)
         it->onNext = false;
+    else if(it->list->nodeCapacity) {
+        if(++it->index == blockCount(it->node)) {
+            it->node = it->node->next;
+            it->index = 0;
+        }
+    }
     else
         it->node = it->node->next;
 }
 
 void listItPrev(ListIt *it) {
-    it->node = it->node->prev;
+    if(it->list->nodeCapacity) {
+        if(--it->index < 0) {
+            it->node = it->node->prev;
+            it->index = it->node ? blockCount(it->node)-1 : 0;
+        }
+    }
+    else
+        it->node = it->node->prev;
 }
 
 
 
 const Ptr listItGet_base(const ListIt *it) {
+    if(it->list->nodeCapacity)
+        return blockElt(it->list, it->node, it->index);
+
     return (void *)it->node+sizeof(struct _ListNode);
 }
 
 
 
 void listItSet_base(ListIt *it, const Ptr data) {
+    void *elt = listItGet_base(it);
+
     if(it->list->delFct)
-        it->list->delFct((void *)it->node+sizeof(struct _ListNode));
+        it->list->delFct(elt);
 
     if(it->list->copyFct)
-        it->list->copyFct((void *)it->node+sizeof(struct _ListNode), data);
+        it->list->copyFct(elt, data);
     else
-        memcpy((void *)it->node+sizeof(struct _ListNode), data, it->list->elemSize);
+        memcpy(elt, data, it->list->elemSize);
 }
 
 
 
 void listItAddAfter_base(ListIt *it, const Ptr data) {
+    if(it->list->nodeCapacity) {
+        blockInsert(it->list, it->node, it->index+1, data, it);
+        return;
+    }
+
     ListNode newnode = malloc(sizeof(struct _ListNode) + it->list->elemSize);
 
     newnode->next = it->node->next;
@@ -394,6 +721,11 @@ void listItAddAfter_base(ListIt *it, const Ptr data) {
 }
 
 void listItAddBefore_base(ListIt *it, const Ptr data) {
+    if(it->list->nodeCapacity) {
+        blockInsert(it->list, it->node, it->index, data, it);
+        return;
+    }
+
     ListNode newnode = malloc(sizeof(struct _ListNode) + it->list->elemSize);
 
     newnode->prev = it->node->prev;
@@ -418,6 +750,35 @@ void listItAddBefore_base(ListIt *it, const Ptr data) {
 void listItRemove(ListIt *it) {
     ListNode node = it->node;
 
+    if(it->list->nodeCapacity) {
+        List l = it->list;
+        ListNode next = node->next;
+        bool freed = blockCount(node) == 1;
+
+        blockRemove(l, node, it->index);
+
+        if(freed) {
+            it->node = next;
+            it->index = 0;
+        }
+        else {
+            // Merges sparse neighbours so that scans stay dense after many removals
+            if(next && blockCount(node) + blockCount(next) <= l->nodeCapacity/2) {
+                memcpy(blockElt(l, node, blockCount(node)), blockElt(l, next, 0), blockCount(next)*l->elemSize);
+                ((ListBlock *)node)->count += blockCount(next);
+                blockFree(l, next);
+            }
+
+            if(it->index == blockCount(node)) {
+                it->node = node->next;
+                it->index = 0;
+            }
+        }
+
+        it->onNext = true;
+        return;
+    }
+
     if(node->next)
         node->next->prev = node->prev;
     else
@@ -435,6 +796,8 @@ void listItRemove(ListIt *it) {
 
     free(node);
 
+    it->list->length--;
+
     it->onNext = true;
 }
 
@@ -443,8 +806,36 @@ void listItRemove(ListIt *it) {
 void listForEach(List l, ElActFct actFct, Ptr infos) {
     ListNode node = l->first;
 
+    if(l->nodeCapacity) {
+        for(; node; node = node->next) {
+            void *elt = blockElt(l, node, 0);
+            void *end = blockElt(l, node, blockCount(node));
+
+            for(; elt<end; elt+=l->elemSize)
+                actFct(elt, infos);
+        }
+
+        return;
+    }
+
     while(node) {
         actFct((void *)node+sizeof(struct _ListNode), infos);
         node = node->next;
     }
 }
+
+void listCopyToRaw(const List l, Ptr dest) {
+    ListNode node = l->first;
+
+    if(l->nodeCapacity) {
+        for(; node; node = node->next) {
+            memcpy(dest, blockElt(l, node, 0), blockCount(node)*l->elemSize);
+            dest += blockCount(node)*l->elemSize;
+        }
+
+        return;
+    }
+
+    for(; node; node = node->next, dest += l->elemSize)
+        memcpy(dest, (void *)node+sizeof(struct _ListNode), l->elemSize);
+}
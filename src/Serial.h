@@ -0,0 +1,102 @@
+/**
+ * \file Serial.h
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Binary file formats written by arraySave, hashSave, frozenHashSave and the filters, and read by arrayLoad, the views,
+ * frozenHashOpen and the filters.
+ * Numbers are stored in the byte order of the machine : a file made on another one fails the magic number check.
+ * Every section starts on a multiple of 8 bytes, so that a mapped file can be read in place.
+ * Private header.
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#ifndef EXTLIB_SERIAL_H
+#define EXTLIB_SERIAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SERIAL_VERSION 1
+
+#define ARRAY_MAGIC  0x52414c45 // "ELAR"
+#define HASH_MAGIC   0x48414c45 // "ELAH"
+#define FROZEN_MAGIC 0x46414c45 // "ELAF"
+#define BLOOM_MAGIC  0x42414c45 // "ELAB"
+#define CUCKOO_MAGIC 0x43414c45 // "ELAC"
+#define XOR_MAGIC    0x58414c45 // "ELAX"
+
+#define SERIAL_ALIGN(size) (((size) + 7) & ~(uint64_t)7)
+
+// Array file : the header, then length elements of elemSize bytes, packed
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t elemSize;
+    int32_t elType;    // EL_* constant the array was created with, or a positive size
+    uint64_t length;
+} ArrayFileHeader;
+
+// Hash file : the header, then the sections at their offsets.
+// Buckets are nbBuckets+1 indices of entries : the entries of bucket b are those from buckets[b] to buckets[b+1] (excluded).
+// An entry holds the hash of its key (hashBytes of the key bytes, or of the characters for string keys), then the key at
+// offset 8, then the value at valueOffset. String keys are replaced by the offset of their characters (NUL-terminated)
+// from the start of the strings section.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t keySize;       // 0 for string keys
+    uint32_t elemSize;
+    uint32_t entrySize;     // multiple of 8
+    uint32_t valueOffset;
+    uint32_t nbBuckets;     // power of 2
+    uint32_t reserved;
+    uint64_t length;
+    uint64_t bucketsOffset;
+    uint64_t entriesOffset;
+    uint64_t stringsOffset;
+    uint64_t fileSize;
+} HashFileHeader;
+
+// Frozen hash file : the header, then the sections at their offsets.
+// Keys are spread over nbBuckets buckets, and the pilot of a bucket gives the slot of each of its keys (see FrozenHash.c).
+// Slots are entries of entrySize bytes : the key at offset 0, the value at valueOffset. String keys are replaced by the
+// offset of their characters (NUL-terminated) from the start of the strings section.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t keySize;       // 0 for string keys
+    uint32_t elemSize;
+    uint32_t entrySize;     // multiple of 8
+    uint32_t valueOffset;
+    uint32_t nbBuckets;
+    uint32_t length;        // number of slots and of keys
+    uint64_t seed;
+    uint64_t pilotsOffset;  // nbBuckets uint32_t
+    uint64_t entriesOffset;
+    uint64_t stringsOffset;
+    uint64_t fileSize;
+} FrozenHashFileHeader;
+
+
+// Filter file : the header, then the table of the filter (dataSize bytes)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t keySize;        // EL_* constant the filter was created with, or a positive size
+    uint32_t fpBits;        // bits of the fingerprints, 0 for Bloom filters
+    uint64_t seed;
+    uint64_t nbBuckets;     // blocks of a Bloom filter, buckets of a cuckoo filter, slots per segment of a xor filter
+    uint64_t length;
+    uint64_t victim;        // cuckoo filters : bucket << 16 | fingerprint of a key which found no slot, 0 if none
+    uint64_t dataSize;
+} FilterFileHeader;
+
+
+
+// Maps a whole file read-only, returns NULL if it can't or if it is smaller than minSize (defined in View.c)
+void *_elMapFile(const char *path, size_t minSize, size_t *size);
+
+#endif
@@ -350,3 +350,8 @@ void simpleListForEach(SimpleList l, ElActFct actFct, Ptr infos) {
         node = node->next;
     }
 }
+
+void simpleListCopyToRaw(const SimpleList l, Ptr dest) {
+    for(SimpleListNode node = l->first; node; node = node->next, dest += l->elemSize)
+        memcpy(dest, (void *)node+sizeof(struct _SimpleListNode), l->elemSize);
+}
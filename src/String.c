@@ -9,11 +9,14 @@
 
 #include "ExtLib/Common.h"
 #include "ExtLib/String.h"
+#include "StringTables.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <limits.h>
 
 #define DEFSIZE 8
 
@@ -28,6 +31,9 @@ struct _String {
 
 
 static void stringResize(String str, int minimumNeeded) {
+    if(str->capacity < 1)
+        str->capacity = 1;
+
     do {
          str->capacity*=2;
     } while(str->capacity < minimumNeeded);
@@ -37,6 +43,636 @@ static void stringResize(String str, int minimumNeeded) {
 
 
 
+// Number formatting
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static inline int countDigits(uint64_t v) {
+    int n = 1;
+
+    while(true) {
+        if(v < 10) return n;
+        if(v < 100) return n+1;
+        if(v < 1000) return n+2;
+        if(v < 10000) return n+3;
+        v /= 10000u;
+        n += 4;
+    }
+}
+
+// Writes the digits of v backward, end is the position just after the last digit
+static inline void writeDigits(char *end, uint64_t v) {
+    while(v >= 100) {
+        int r = (int)(v % 100) * 2;
+        v /= 100;
+        end -= 2;
+        memcpy(end, digitPairs + r, 2);
+    }
+
+    if(v >= 10) {
+        end -= 2;
+        memcpy(end, digitPairs + v*2, 2);
+    }
+    else
+        *--end = (char)('0' + v);
+}
+
+static void stringAppendUnsigned(String str, uint64_t v, bool negative) {
+    int len = countDigits(v) + negative;
+
+    if(str->capacity < str->length+len)
+        stringResize(str, str->length+len);
+
+    char *ct = str->ct + str->length;
+    if(negative)
+        *ct = '-';
+    writeDigits(ct + len, v);
+
+    str->length += len;
+}
+
+static inline void stringAppendSigned(String str, int64_t v) {
+    if(v < 0)
+        stringAppendUnsigned(str, 0u - (uint64_t)v, true);
+    else
+        stringAppendUnsigned(str, (uint64_t)v, false);
+}
+
+
+
+// Shortest round-trip floating point formatting (Ryu, Ulf Adams 2018)
+
+static inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t *high) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *high = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    uint64_t aLo = (uint32_t)a, aHi = a >> 32;
+    uint64_t bLo = (uint32_t)b, bHi = b >> 32;
+
+    uint64_t b00 = aLo * bLo;
+    uint64_t b01 = aLo * bHi;
+    uint64_t b10 = aHi * bLo;
+    uint64_t b11 = aHi * bHi;
+
+    uint64_t mid1 = b10 + (b00 >> 32);
+    uint64_t mid2 = b01 + (uint32_t)mid1;
+
+    *high = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | (uint32_t)b00;
+#endif
+}
+
+static inline uint64_t mulShift64(uint64_t m, const uint64_t *mul, int j) {
+    uint64_t high1, high0;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+    umul128(m, mul[0], &high0);
+
+    uint64_t sum = high0 + low1;
+    if(sum < high0)
+        high1++;
+
+    // 64 <= j-64 < 128 : shift the 128-bit (high1, sum) right by j-64
+    int shift = j - 64;
+    if(shift >= 64)
+        return high1 >> (shift - 64);
+    return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+static inline int pow5bits(int e) {
+    return ((e * 1217359) >> 19) + 1;
+}
+
+static inline int log10Pow2(int e) {
+    return (e * 78913) >> 18;
+}
+
+static inline int log10Pow5(int e) {
+    return (e * 732923) >> 20;
+}
+
+static inline bool multipleOfPowerOf5(uint64_t value, int p) {
+    int count = 0;
+
+    while(value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+
+    return count >= p;
+}
+
+static inline bool multipleOfPowerOf2(uint64_t value, int p) {
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+// Computes the shortest decimal (*output * 10^return) that rounds to the binary value
+static int shortestDecimal(uint64_t ieeeMantissa, int ieeeExponent, int mantissaBits, int bias, uint64_t *output) {
+    int e2;
+    uint64_t m2;
+
+    if(ieeeExponent == 0) {
+        e2 = 1 - bias - mantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = ieeeExponent - bias - mantissaBits - 2;
+        m2 = (1ull << mantissaBits) | ieeeMantissa;
+    }
+
+    bool acceptBounds = (m2 & 1) == 0;
+
+    uint64_t mv = 4 * m2;
+    int mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false, vrIsTrailingZeros = false;
+
+    if(e2 >= 0) {
+        int q = log10Pow2(e2) - (e2 > 3);
+        int k = POW5_INV_BITCOUNT + pow5bits(q) - 1;
+        int i = -e2 + q + k;
+
+        e10 = q;
+        vr = mulShift64(4*m2, pow5InvSplit[q], i);
+        vp = mulShift64(4*m2 + 2, pow5InvSplit[q], i);
+        vm = mulShift64(4*m2 - 1 - mmShift, pow5InvSplit[q], i);
+
+        if(q <= 21) {
+            if(mv % 5 == 0)
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            else if(acceptBounds)
+                vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            else
+                vp -= multipleOfPowerOf5(mv + 2, q);
+        }
+    }
+    else {
+        int q = log10Pow5(-e2) - (-e2 > 1);
+        int i = -e2 - q;
+        int k = pow5bits(i) - POW5_BITCOUNT;
+        int j = q - k;
+
+        e10 = q + e2;
+        vr = mulShift64(4*m2, pow5Split[i], j);
+        vp = mulShift64(4*m2 + 2, pow5Split[i], j);
+        vm = mulShift64(4*m2 - 1 - mmShift, pow5Split[i], j);
+
+        if(q <= 1) {
+            vrIsTrailingZeros = true;
+            if(acceptBounds)
+                vmIsTrailingZeros = mmShift == 1;
+            else
+                vp--;
+        }
+        else if(q < 63)
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+    }
+
+    // Removes the digits that are not needed to identify the value
+    int removed = 0;
+    int lastRemovedDigit = 0;
+
+    if(vmIsTrailingZeros || vrIsTrailingZeros) {
+        while(vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = (int)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        if(vmIsTrailingZeros) {
+            while(vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = (int)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+
+        if(vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+            lastRemovedDigit = 4; // Round to even
+
+        *output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    }
+    else {
+        bool roundUp = false;
+
+        while(vp / 10 > vm / 10) {
+            roundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+
+        *output = vr + (vr == vm || roundUp);
+    }
+
+    return e10 + removed;
+}
+
+// Writes a floating point value in buff (at least 32 chars) and returns its length
+static int formatFloating(uint64_t ieeeMantissa, int ieeeExponent, bool sign, int mantissaBits, int exponentBits, char *buff) {
+    int bias = (1 << (exponentBits - 1)) - 1;
+    char *p = buff;
+
+    if(ieeeExponent == (1 << exponentBits) - 1) {
+        if(ieeeMantissa) {
+            memcpy(p, "nan", 3);
+            return 3;
+        }
+
+        if(sign)
+            *p++ = '-';
+        memcpy(p, "inf", 3);
+        return p - buff + 3;
+    }
+
+    if(sign)
+        *p++ = '-';
+
+    if(ieeeExponent == 0 && ieeeMantissa == 0) {
+        *p++ = '0';
+        return p - buff;
+    }
+
+    uint64_t digits;
+    int exp = shortestDecimal(ieeeMantissa, ieeeExponent, mantissaBits, bias, &digits);
+    int olength = countDigits(digits);
+    int sciExp = exp + olength - 1;
+
+    if(sciExp >= -4 && sciExp < 16) {
+        if(exp >= 0) { // Integer value
+            writeDigits(p + olength, digits);
+            p += olength;
+            memset(p, '0', exp);
+            p += exp;
+        }
+        else if(sciExp >= 0) { // Decimal point inside the digits
+            int intLength = sciExp + 1;
+            writeDigits(p + olength + 1, digits);
+            memmove(p, p + 1, intLength);
+            p[intLength] = '.';
+            p += olength + 1;
+        }
+        else { // 0.000ddd
+            int zeros = -sciExp - 1;
+            memcpy(p, "0.", 2);
+            memset(p + 2, '0', zeros);
+            p += 2 + zeros;
+            writeDigits(p + olength, digits);
+            p += olength;
+        }
+    }
+    else {
+        writeDigits(p + olength + 1, digits);
+        p[0] = p[1];
+        if(olength > 1) {
+            p[1] = '.';
+            p += olength + 1;
+        }
+        else
+            p++;
+
+        *p++ = 'e';
+        if(sciExp < 0) {
+            *p++ = '-';
+            sciExp = -sciExp;
+        }
+        else
+            *p++ = '+';
+
+        int expLength = sciExp < 10 ? 2 : countDigits(sciExp);
+        writeDigits(p + expLength, sciExp);
+        if(sciExp < 10)
+            *p = '0';
+        p += expLength;
+    }
+
+    return p - buff;
+}
+
+
+
+// Number parsing
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SWAR_DIGITS 1
+#else
+#define SWAR_DIGITS 0
+#endif
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Tells whether the 8 bytes loaded in v are all ASCII digits
+static inline bool isEightDigits(uint64_t v) {
+    return ((v & 0xF0F0F0F0F0F0F0F0u) | (((v + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) >> 4)) == 0x3333333333333333u;
+}
+
+// Converts 8 ASCII digits loaded in v (first digit in the low byte) in 3 multiplications
+static inline uint64_t parseEightDigits(uint64_t v) {
+    v -= 0x3030303030303030u;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFu) * 0x000F424000000064u) + (((v >> 16) & 0x000000FF000000FFu) * 0x0000271000000001u)) >> 32;
+    return (uint32_t)v;
+}
+
+// Accumulates at most maxDigits digits from ct into *acc, returns the position after them
+static inline const char *parseDigits(const char *ct, const char *end, uint64_t *acc, int maxDigits) {
+    uint64_t v = *acc;
+    const char *start = ct;
+
+#if SWAR_DIGITS
+    uint64_t chunk;
+    while(end - ct >= 8 && ct - start + 8 <= maxDigits) {
+        memcpy(&chunk, ct, 8);
+        if(!isEightDigits(chunk))
+            break;
+        v = v * 100000000u + parseEightDigits(chunk);
+        ct += 8;
+    }
+#endif
+
+    while(ct < end && ct - start < maxDigits && isDigit(*ct))
+        v = v * 10 + (*ct++ - '0');
+
+    *acc = v;
+    return ct;
+}
+
+// Parses a signed decimal integer clamped to [min, max], returns the number of characters read
+static int parseInteger(const char *ct, const char *end, long long *value, long long min, long long max) {
+    const char *start = ct;
+    bool negative = false;
+
+    if(ct < end && (*ct == '-' || *ct == '+')) {
+        negative = *ct == '-';
+        ct++;
+    }
+
+    if(ct >= end || !isDigit(*ct))
+        return 0;
+
+    while(ct < end && *ct == '0')
+        ct++;
+
+    // 19 digits always fit in 64 bits
+    uint64_t magnitude = 0;
+    ct = parseDigits(ct, end, &magnitude, 19);
+
+    bool overflow = false;
+    while(ct < end && isDigit(*ct)) {
+        overflow = true;
+        ct++;
+    }
+
+    if(negative) {
+        if(overflow || magnitude > (uint64_t)-(min + 1) + 1)
+            *value = min;
+        else
+            *value = (long long)(0u - magnitude);
+    }
+    else {
+        if(overflow || magnitude > (uint64_t)max)
+            *value = max;
+        else
+            *value = (long long)magnitude;
+    }
+
+    return ct - start;
+}
+
+static inline int leadingZeros64(uint64_t v) {
+#ifdef __GNUC__
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+    while(!(v & (1ull << 63))) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Computes man * 10^exp10 rounded to nearest (Eisel-Lemire), returns false when the result can't be decided this way
+static bool eiselLemire(uint64_t man, int exp10, bool negative, double *value) {
+    if(exp10 < POW5_NORMALIZED_MIN || exp10 > POW5_NORMALIZED_MAX)
+        return false;
+
+    const uint64_t *pow5 = pow5Normalized[exp10 - POW5_NORMALIZED_MIN];
+
+    int clz = leadingZeros64(man);
+    man <<= clz;
+    uint64_t retExp2 = (uint64_t)(((217706 * exp10) >> 16) + 64 + 1023) - clz;
+
+    uint64_t xHi, xLo = umul128(man, pow5[1], &xHi);
+
+    // The truncated product may be too low : widen the approximation with the low half of the power
+    if((xHi & 0x1FF) == 0x1FF && xLo + man < man) {
+        uint64_t yHi, yLo = umul128(man, pow5[0], &yHi);
+        uint64_t mergedHi = xHi, mergedLo = xLo + yHi;
+
+        if(mergedLo < xLo)
+            mergedHi++;
+
+        if((mergedHi & 0x1FF) == 0x1FF && mergedLo + 1 == 0 && yLo + man < man)
+            return false;
+
+        xHi = mergedHi;
+        xLo = mergedLo;
+    }
+
+    uint64_t msb = xHi >> 63;
+    uint64_t retMantissa = xHi >> (msb + 9);
+    retExp2 -= 1 ^ msb;
+
+    // Exactly half-way between 2 doubles
+    if(xLo == 0 && (xHi & 0x1FF) == 0 && (retMantissa & 3) == 1)
+        return false;
+
+    retMantissa += retMantissa & 1;
+    retMantissa >>= 1;
+    if(retMantissa >> 53) {
+        retMantissa >>= 1;
+        retExp2++;
+    }
+
+    // Subnormal, infinite or NaN results are left to strtod
+    if(retExp2 - 1 >= 0x7FF - 1)
+        return false;
+
+    uint64_t bits = retExp2 << 52 | (retMantissa & ((1ull << 52) - 1));
+    if(negative)
+        bits |= 1ull << 63;
+
+    memcpy(value, &bits, sizeof(double));
+    return true;
+}
+
+static int parseDoubleSlow(const char *ct, int length, double *value) {
+    char buff[64];
+    char *cStr = length < 64 ? buff : malloc(length+1);
+    char *endPtr;
+
+    memcpy(cStr, ct, length);
+    cStr[length] = '\0';
+
+    // strtod returns 0.0 when it reads nothing, the value must stay unchanged then
+    double result = strtod(cStr, &endPtr);
+    int consumed = endPtr - cStr;
+
+    if(consumed > 0)
+        *value = result;
+
+    if(cStr != buff)
+        free(cStr);
+
+    return consumed;
+}
+
+// Parses a decimal floating point number, returns the number of characters read
+static int parseDouble(const char *ct, const char *end, double *value) {
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *start = ct;
+    bool negative = false;
+
+    if(ct < end && (*ct == '-' || *ct == '+')) {
+        negative = *ct == '-';
+        ct++;
+    }
+
+    if(ct < end && (*ct == 'i' || *ct == 'I' || *ct == 'n' || *ct == 'N'))
+        return parseDoubleSlow(start, end - start < 16 ? end - start : 16, value);
+
+    // Mantissa : up to 19 significant digits in man, the others only shift the exponent
+    uint64_t man = 0;
+    int exp10 = 0;
+    bool truncated = false;
+    bool hasDigits = false;
+
+    while(ct < end && *ct == '0') {
+        ct++;
+        hasDigits = true;
+    }
+
+    const char *digits = ct;
+    ct = parseDigits(ct, end, &man, 19);
+    int nbDigits = ct - digits;
+
+    for(; ct < end && isDigit(*ct); ct++) {
+        exp10++;
+        truncated |= *ct != '0';
+    }
+
+    hasDigits |= ct != digits;
+
+    if(ct < end && *ct == '.') {
+        ct++;
+
+        if(nbDigits == 0) {
+            for(; ct < end && *ct == '0'; ct++) {
+                exp10--;
+                hasDigits = true;
+            }
+        }
+
+        digits = ct;
+        ct = parseDigits(ct, end, &man, 19 - nbDigits);
+        nbDigits += ct - digits;
+        exp10 -= ct - digits;
+        hasDigits |= ct != digits;
+
+        for(; ct < end && isDigit(*ct); ct++) {
+            truncated |= *ct != '0';
+            hasDigits = true;
+        }
+    }
+
+    if(!hasDigits)
+        return 0;
+
+    if(ct < end && (*ct == 'e' || *ct == 'E')) {
+        const char *expCt = ct + 1;
+        bool expNegative = false;
+
+        if(expCt < end && (*expCt == '-' || *expCt == '+')) {
+            expNegative = *expCt == '-';
+            expCt++;
+        }
+
+        if(expCt < end && isDigit(*expCt)) {
+            int exp = 0;
+
+            for(; expCt < end && isDigit(*expCt); expCt++)
+                if(exp < 100000)
+                    exp = exp * 10 + (*expCt - '0');
+
+            exp10 += expNegative ? -exp : exp;
+            ct = expCt;
+        }
+    }
+
+    if(man == 0) {
+        *value = negative ? -0.0 : 0.0;
+        return ct - start;
+    }
+
+    if(!truncated) {
+        // Both man and 10^exp10 are exact doubles : a single rounding
+        if(man <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+            double d = (double)man;
+
+            if(exp10 < 0)
+                d /= pow10[-exp10];
+            else
+                d *= pow10[exp10];
+
+            *value = negative ? -d : d;
+            return ct - start;
+        }
+
+        if(eiselLemire(man, exp10, negative, value))
+            return ct - start;
+    }
+    else {
+        // The exact value lies between man and man+1 : both must round to the same double
+        double upper;
+
+        if(eiselLemire(man, exp10, negative, value) && eiselLemire(man + 1, exp10, negative, &upper) && *value == upper)
+            return ct - start;
+    }
+
+    parseDoubleSlow(start, ct - start, value);
+    return ct - start;
+}
+
+
+
 String stringNew() {
     String str=malloc(sizeof(struct _String));
 
@@ -112,6 +748,24 @@ void stringClear(String str) {
 
 
 
+void stringReserve(String str, int capacity) {
+    if(str->capacity < capacity) {
+        str->capacity = capacity;
+        str->ct = realloc(str->ct, str->capacity*sizeof(char));
+    }
+}
+
+void stringTrimCapacity(String str) {
+    int capacity = str->length > 0 ? str->length : 1;
+
+    if(str->capacity > capacity) {
+        str->capacity = capacity;
+        str->ct = realloc(str->ct, str->capacity*sizeof(char));
+    }
+}
+
+
+
 bool stringIsEmpty(String str) {
     return str->length == 0;
 }
@@ -154,24 +808,41 @@ int stringCompare(String str1, String str2) {
     return strncmp(str1->ct, str2->ct, len);
 }
 
+unsigned long stringHash(String str) {
+    return hashBytes(str->ct, str->length);
+}
+
 
 
 void stringAppend(String str, const char *cStr) {
-    int cStrLen = strlen(cStr);
+    stringAppendN(str, cStr, strlen(cStr));
+}
 
-    if(str->capacity < str->length+cStrLen)
-        stringResize(str, str->length+cStrLen);
+void stringAppendN(String str, const char *data, int length) {
+    if(str->capacity < str->length+length) {
+        // data may point into str itself (e.g. stringCStr(str)), it must be found back after the reallocation
+        if(data >= str->ct && data < str->ct+str->capacity) {
+            int offset = data - str->ct;
+            stringResize(str, str->length+length);
+            data = str->ct + offset;
+        }
+        else
+            stringResize(str, str->length+length);
+    }
 
-    memcpy(str->ct+str->length*sizeof(char), cStr, cStrLen);
-    str->length += cStrLen;
+    memcpy(str->ct+str->length*sizeof(char), data, length);
+    str->length += length;
 }
 
 void stringAppendString(String str, const String str2) {
-    if(str->capacity < str->length+str2->length)
-        stringResize(str, str->length+str2->length);
+    // Length is read before the resize so that str2 == str appends str once
+    int length = str2->length;
 
-    memcpy(str->ct+str->length*sizeof(char), str2->ct, str2->length);
-    str->length += str2->length;
+    if(str->capacity < str->length+length)
+        stringResize(str, str->length+length);
+
+    memcpy(str->ct+str->length*sizeof(char), str2->ct, length);
+    str->length += length;
 }
 
 void stringAppendChar(String str, const char c) {
@@ -182,28 +853,98 @@ void stringAppendChar(String str, const char c) {
 }
 
 void stringAppendInt(String str, const int i) {
-    char buff[15];
+    stringAppendSigned(str, i);
+}
 
-    sprintf(buff, "%d", i);
-    int len = strlen(buff);
+void stringAppendUint(String str, const unsigned int i) {
+    stringAppendUnsigned(str, i, false);
+}
 
-    if(str->capacity < str->length+len)
-        stringResize(str, str->length+len);
+void stringAppendLong(String str, const long i) {
+    stringAppendSigned(str, i);
+}
 
-    memcpy(str->ct+str->length*sizeof(char), buff, len);
-    str->length += len;
+void stringAppendUlong(String str, const unsigned long i) {
+    stringAppendUnsigned(str, i, false);
+}
+
+void stringAppendLonglong(String str, const long long i) {
+    stringAppendSigned(str, i);
+}
+
+void stringAppendUlonglong(String str, const unsigned long long i) {
+    stringAppendUnsigned(str, i, false);
+}
+
+void stringAppendFloat(String str, const float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(float));
+
+    if(str->capacity < str->length+32)
+        stringResize(str, str->length+32);
+
+    str->length += formatFloating(bits & ((1u << 23) - 1), (bits >> 23) & 0xFF, bits >> 31, 23, 8, str->ct + str->length);
+}
+
+void stringAppendDouble(String str, const double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(double));
+
+    if(str->capacity < str->length+32)
+        stringResize(str, str->length+32);
+
+    str->length += formatFloating(bits & ((1ull << 52) - 1), (bits >> 52) & 0x7FF, bits >> 63, 52, 11, str->ct + str->length);
 }
 
 void stringAppendF(String str, const char *format, ...) {
-    va_list args;
-    char buff[4096];
+    va_list args, argsCopy;
     va_start(args, format);
+    va_copy(argsCopy, args);
 
-    vsprintf(buff, format, args);
+    // vsnprintf needs room for its terminating '\0'
+    int available = str->capacity - str->length;
+    int len = vsnprintf(str->ct + str->length, available, format, args);
 
+    if(len >= available) {
+        stringResize(str, str->length+len+1);
+        vsnprintf(str->ct + str->length, len+1, format, argsCopy);
+    }
+
+    va_end(argsCopy);
     va_end(args);
 
-    stringAppend(str, buff);
+    if(len > 0)
+        str->length += len;
+}
+
+
+
+int stringParseInt(String str, int start, int end, int *value) {
+    long long v;
+    int consumed = parseInteger(str->ct+start, str->ct+end, &v, INT_MIN, INT_MAX);
+
+    if(consumed)
+        *value = (int)v;
+
+    return consumed;
+}
+
+int stringParseLong(String str, int start, int end, long *value) {
+    long long v;
+    int consumed = parseInteger(str->ct+start, str->ct+end, &v, LONG_MIN, LONG_MAX);
+
+    if(consumed)
+        *value = (long)v;
+
+    return consumed;
+}
+
+int stringParseLonglong(String str, int start, int end, long long *value) {
+    return parseInteger(str->ct+start, str->ct+end, value, LLONG_MIN, LLONG_MAX);
+}
+
+int stringParseDouble(String str, int start, int end, double *value) {
+    return parseDouble(str->ct+start, str->ct+end, value);
 }
 
 
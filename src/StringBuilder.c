@@ -0,0 +1,247 @@
+/**
+ * \file StringBuilder.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/String.h"
+#include "ExtLib/StringBuilder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#define MINCHUNK 4096
+#define MAXCHUNK (4*1024*1024)
+
+typedef struct _StringChunk *StringChunk;
+
+struct _StringChunk {
+    StringChunk next;
+    int length;
+    int capacity;
+};
+
+struct _StringBuilder {
+    int length;
+
+    int nbChunks;
+    int nextChunkSize;
+    StringChunk first;
+    StringChunk last;
+};
+
+
+
+static inline char *chunkData(StringChunk chunk) {
+    return (char *)chunk + sizeof(struct _StringChunk);
+}
+
+// Adds a chunk able to store at least minimumNeeded characters, chunk sizes grow geometrically up to MAXCHUNK
+static StringChunk stringBuilderAddChunk(StringBuilder sb, int minimumNeeded) {
+    int capacity = sb->nextChunkSize;
+
+    if(capacity < minimumNeeded)
+        capacity = minimumNeeded;
+    else if(sb->nextChunkSize < MAXCHUNK)
+        sb->nextChunkSize *= 2;
+
+    StringChunk chunk = malloc(sizeof(struct _StringChunk) + capacity);
+    chunk->next = NULL;
+    chunk->length = 0;
+    chunk->capacity = capacity;
+
+    if(sb->last)
+        sb->last->next = chunk;
+    else
+        sb->first = chunk;
+    sb->last = chunk;
+
+    sb->nbChunks++;
+
+    return chunk;
+}
+
+
+
+StringBuilder stringBuilderNew() {
+    StringBuilder sb = malloc(sizeof(struct _StringBuilder));
+
+    sb->length = 0;
+
+    sb->nbChunks = 0;
+    sb->nextChunkSize = MINCHUNK;
+    sb->first = NULL;
+    sb->last = NULL;
+
+    return sb;
+}
+
+void stringBuilderDel(StringBuilder sb) {
+    stringBuilderClear(sb);
+
+    free(sb);
+}
+
+String stringBuilderDelKeepString(StringBuilder sb) {
+    String str = stringNew();
+    stringReserve(str, sb->length+1);
+
+    StringChunk chunk = sb->first;
+    StringChunk chunkSave;
+
+    while(chunk) {
+        stringAppendN(str, chunkData(chunk), chunk->length);
+
+        chunkSave = chunk;
+        chunk = chunk->next;
+        free(chunkSave);
+    }
+
+    free(sb);
+
+    return str;
+}
+
+
+
+void stringBuilderClear(StringBuilder sb) {
+    StringChunk chunk = sb->first;
+    StringChunk chunkSave;
+
+    while(chunk) {
+        chunkSave = chunk;
+        chunk = chunk->next;
+        free(chunkSave);
+    }
+
+    sb->length = 0;
+
+    sb->nbChunks = 0;
+    sb->nextChunkSize = MINCHUNK;
+    sb->first = NULL;
+    sb->last = NULL;
+}
+
+
+
+int stringBuilderLength(StringBuilder sb) {
+    return sb->length;
+}
+
+
+
+void stringBuilderAppend(StringBuilder sb, const char *cStr) {
+    stringBuilderAppendN(sb, cStr, strlen(cStr));
+}
+
+void stringBuilderAppendN(StringBuilder sb, const char *data, int length) {
+    StringChunk chunk = sb->last;
+
+    if(chunk && chunk->capacity - chunk->length >= length) {
+        memcpy(chunkData(chunk) + chunk->length, data, length);
+        chunk->length += length;
+    }
+    else {
+        // Fills the current chunk, the rest goes in a new one
+        int available = chunk ? chunk->capacity - chunk->length : 0;
+
+        if(available > 0) {
+            memcpy(chunkData(chunk) + chunk->length, data, available);
+            chunk->length += available;
+        }
+
+        chunk = stringBuilderAddChunk(sb, length - available);
+        memcpy(chunkData(chunk), data + available, length - available);
+        chunk->length = length - available;
+    }
+
+    sb->length += length;
+}
+
+void stringBuilderAppendString(StringBuilder sb, const String str) {
+    stringBuilderAppendN(sb, stringCStr(str), stringLength(str));
+}
+
+void stringBuilderAppendChar(StringBuilder sb, const char c) {
+    StringChunk chunk = sb->last;
+
+    if(!chunk || chunk->length == chunk->capacity)
+        chunk = stringBuilderAddChunk(sb, 1);
+
+    chunkData(chunk)[chunk->length++] = c;
+
+    sb->length++;
+}
+
+void stringBuilderAppendF(StringBuilder sb, const char *format, ...) {
+    va_list args, argsCopy;
+    va_start(args, format);
+    va_copy(argsCopy, args);
+
+    // vsnprintf needs room for its terminating '\0'
+    StringChunk chunk = sb->last;
+    if(!chunk)
+        chunk = stringBuilderAddChunk(sb, 1);
+
+    int available = chunk->capacity - chunk->length;
+    int len = vsnprintf(chunkData(chunk) + chunk->length, available, format, args);
+
+    if(len >= available) {
+        chunk = stringBuilderAddChunk(sb, len+1);
+        vsnprintf(chunkData(chunk), len+1, format, argsCopy);
+    }
+
+    va_end(argsCopy);
+    va_end(args);
+
+    if(len > 0) {
+        chunk->length += len;
+        sb->length += len;
+    }
+}
+
+
+
+String stringBuilderToString(StringBuilder sb) {
+    String str = stringNew();
+    stringReserve(str, sb->length+1);
+
+    for(StringChunk chunk = sb->first; chunk; chunk = chunk->next)
+        stringAppendN(str, chunkData(chunk), chunk->length);
+
+    return str;
+}
+
+bool stringBuilderWrite(StringBuilder sb, FILE *file) {
+    for(StringChunk chunk = sb->first; chunk; chunk = chunk->next) {
+        if(fwrite(chunkData(chunk), sizeof(char), chunk->length, file) != (size_t)chunk->length)
+            return false;
+    }
+
+    return true;
+}
+
+
+
+void stringBuilderDump(StringBuilder sb) {
+    int elts = sb->length;
+    int effcost = elts*sizeof(char);
+    int opcost = sizeof(struct _StringBuilder) + sb->nbChunks*sizeof(struct _StringChunk);
+    int preallcost = 0;
+
+    for(StringChunk chunk = sb->first; chunk; chunk = chunk->next)
+        preallcost += (chunk->capacity - chunk->length)*sizeof(char);
+
+    printf("String builder at %p\n", sb);
+    printf("\t%d characters in %d chunks\n", elts, sb->nbChunks);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
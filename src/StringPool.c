@@ -0,0 +1,224 @@
+/**
+ * \file StringPool.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/String.h"
+#include "ExtLib/StringPool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFSIZE 64 // power of 2
+#define BLOCKSIZE 65536
+
+typedef struct _PoolBlock *PoolBlock;
+
+struct _PoolBlock {
+    PoolBlock next;
+    int used;
+    int capacity;
+};
+
+// Header stored just before the characters of every interned string
+typedef struct {
+    unsigned long hash;
+    int length;
+} InternedHeader;
+
+struct _StringPool {
+    int length;
+
+    int size;
+    const char **ct;
+
+    int nbBlocks;
+    int memUsed;
+    PoolBlock blocks;
+};
+
+
+
+static inline InternedHeader *internedHeader(const char *interned) {
+    return (InternedHeader *)(interned - sizeof(InternedHeader));
+}
+
+// Allocates room for an interned string in the current block, or in a new one
+static char *stringPoolAlloc(StringPool pool, int length) {
+    int needed = (sizeof(InternedHeader) + length + 1 + sizeof(unsigned long) - 1) & ~(sizeof(unsigned long) - 1);
+    PoolBlock block = pool->blocks;
+
+    if(!block || block->capacity - block->used < needed) {
+        int capacity = needed > BLOCKSIZE ? needed : BLOCKSIZE;
+
+        block = malloc(sizeof(struct _PoolBlock) + capacity);
+        block->used = 0;
+        block->capacity = capacity;
+        block->next = pool->blocks;
+        pool->blocks = block;
+
+        pool->nbBlocks++;
+    }
+
+    char *mem = (char *)block + sizeof(struct _PoolBlock) + block->used;
+    block->used += needed;
+    pool->memUsed += needed;
+
+    return mem + sizeof(InternedHeader);
+}
+
+// Returns the slot of the table where data is, or the empty slot where it should be
+static inline int stringPoolFind(const StringPool pool, const char *data, int length, unsigned long hash) {
+    int mask = pool->size - 1;
+    int index = hash & mask;
+
+    while(pool->ct[index]) {
+        const char *interned = pool->ct[index];
+        InternedHeader *header = internedHeader(interned);
+
+        if(header->hash == hash && header->length == length && memcmp(interned, data, length) == 0)
+            break;
+
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+static void stringPoolResize(StringPool pool) {
+    int oldSize = pool->size;
+    const char **oldCt = pool->ct;
+
+    pool->size *= 2;
+    pool->ct = calloc(pool->size, sizeof(const char *));
+
+    int mask = pool->size - 1;
+
+    for(int i=0; i<oldSize; i++) {
+        if(oldCt[i]) {
+            int index = internedHeader(oldCt[i])->hash & mask;
+
+            while(pool->ct[index])
+                index = (index + 1) & mask;
+
+            pool->ct[index] = oldCt[i];
+        }
+    }
+
+    free(oldCt);
+}
+
+
+
+StringPool stringPoolNew() {
+    StringPool pool = malloc(sizeof(struct _StringPool));
+
+    pool->length = 0;
+
+    pool->size = DEFSIZE;
+    pool->ct = calloc(DEFSIZE, sizeof(const char *));
+
+    pool->nbBlocks = 0;
+    pool->memUsed = 0;
+    pool->blocks = NULL;
+
+    return pool;
+}
+
+void stringPoolDel(StringPool pool) {
+    PoolBlock block = pool->blocks;
+    PoolBlock blockSave;
+
+    while(block) {
+        blockSave = block;
+        block = block->next;
+        free(blockSave);
+    }
+
+    free(pool->ct);
+    free(pool);
+}
+
+
+
+int stringPoolLength(const StringPool pool) {
+    return pool->length;
+}
+
+
+
+const char *stringPoolIntern(StringPool pool, const char *cStr) {
+    return stringPoolInternN(pool, cStr, strlen(cStr));
+}
+
+const char *stringPoolInternN(StringPool pool, const char *data, int length) {
+    unsigned long hash = hashBytes(data, length);
+    int index = stringPoolFind(pool, data, length, hash);
+
+    if(pool->ct[index])
+        return pool->ct[index];
+
+    // Load factor kept under 1/2 so that probe sequences stay short
+    if(2*(pool->length+1) > pool->size) {
+        stringPoolResize(pool);
+        index = stringPoolFind(pool, data, length, hash);
+    }
+
+    char *interned = stringPoolAlloc(pool, length);
+    InternedHeader *header = internedHeader(interned);
+
+    header->hash = hash;
+    header->length = length;
+    memcpy(interned, data, length);
+    interned[length] = '\0';
+
+    pool->ct[index] = interned;
+    pool->length++;
+
+    return interned;
+}
+
+const char *stringPoolInternString(StringPool pool, const String str) {
+    return stringPoolInternN(pool, stringCStr(str), stringLength(str));
+}
+
+const char *stringPoolGet(const StringPool pool, const char *cStr) {
+    int length = strlen(cStr);
+
+    return pool->ct[stringPoolFind(pool, cStr, length, hashBytes(cStr, length))];
+}
+
+
+
+unsigned long stringPoolHash(const char *interned) {
+    return internedHeader(interned)->hash;
+}
+
+int stringPoolStrLength(const char *interned) {
+    return internedHeader(interned)->length;
+}
+
+
+
+void stringPoolDump(const StringPool pool) {
+    int elts = pool->length;
+    int effcost = pool->memUsed;
+    int opcost = sizeof(struct _StringPool) + pool->size*sizeof(const char *) + pool->nbBlocks*sizeof(struct _PoolBlock);
+    int preallcost = -pool->memUsed;
+
+    for(PoolBlock block = pool->blocks; block; block = block->next)
+        preallcost += block->capacity;
+
+    printf("String pool at %p\n", pool);
+    printf("\t%d strings in %d blocks\n", elts, pool->nbBlocks);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
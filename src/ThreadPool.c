@@ -0,0 +1,352 @@
+/**
+ * \file ThreadPool.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ExtLib/Common.h"
+#include "ExtLib/Deque.h"
+#include "ExtLib/ThreadPool.h"
+#include "ExtLib/WorkDeque.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    ElTaskFct fct;
+    Ptr infos;
+    Future future;
+} Task;
+
+#define PENDING 0
+#define WAITING 1 // a thread may sleep on doneCond for this future
+#define DONE    2
+
+struct _Future {
+    ThreadPool pool;
+    int state;
+};
+
+typedef struct {
+    ThreadPool pool;
+    int id;
+    unsigned seed;
+    WorkDeque tasks;
+    pthread_t thread;
+} Worker;
+
+struct _ThreadPool {
+    int nbThreads;
+    Worker *workers;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t workCond;
+    pthread_cond_t doneCond;
+
+    Deque injected;     // tasks submitted from outside the pool, protected by mutex
+    int nbInjected;     // length of injected, readable without the mutex
+    int sleeping;       // number of workers waiting on workCond
+    unsigned long signals; // increased whenever a task is made available
+    bool stopping;
+};
+
+// Worker running on the current thread, NULL outside of any pool
+static __thread Worker *currentWorker = NULL;
+
+static ThreadPool defaultPool = NULL;
+static pthread_once_t defaultPoolOnce = PTHREAD_ONCE_INIT;
+
+
+
+static inline bool isOwnWorker(ThreadPool pool) {
+    return currentWorker && currentWorker->pool == pool;
+}
+
+// Wakes a sleeping worker if any. Must be called after the task is made available.
+static void notifyWork(ThreadPool pool) {
+    __atomic_add_fetch(&pool->signals, 1, __ATOMIC_SEQ_CST);
+
+    if(__atomic_load_n(&pool->sleeping, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_signal(&pool->workCond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static bool findTask(ThreadPool pool, Task *task) {
+    Worker *self = isOwnWorker(pool) ? currentWorker : NULL;
+
+    if(self && workDequePop(self->tasks, *task))
+        return true;
+
+    if(__atomic_load_n(&pool->nbInjected, __ATOMIC_ACQUIRE) > 0) {
+        bool found = false;
+
+        pthread_mutex_lock(&pool->mutex);
+        if(!dequeIsEmpty(pool->injected)) {
+            *task = dequeGetFirst(pool->injected, Task);
+            dequeRemoveFirst(pool->injected);
+            __atomic_sub_fetch(&pool->nbInjected, 1, __ATOMIC_RELEASE);
+            found = true;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+
+        if(found)
+            return true;
+    }
+
+    // Steals from the other workers, starting at a random one
+    unsigned start = self ? rand_r(&self->seed) : (unsigned)(size_t)task;
+
+    for(int i=0; i<pool->nbThreads; i++) {
+        Worker *victim = &pool->workers[(start + i) % pool->nbThreads];
+
+        if(victim != self && workDequeSteal(victim->tasks, *task))
+            return true;
+    }
+
+    return false;
+}
+
+static void runTask(Task *task) {
+    Future f = task->future;
+    ThreadPool pool = f->pool;
+
+    task->fct(task->infos);
+
+    // f may be freed by its joiner as soon as it is done, it mustn't be read afterwards
+    if(__atomic_exchange_n(&f->state, DONE, __ATOMIC_ACQ_REL) == WAITING) {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_broadcast(&pool->doneCond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static void *workerMain(Worker *self) {
+    ThreadPool pool = self->pool;
+    Task task;
+
+    currentWorker = self;
+
+    for(;;) {
+        unsigned long signals = __atomic_load_n(&pool->signals, __ATOMIC_SEQ_CST);
+
+        if(findTask(pool, &task)) {
+            runTask(&task);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+
+        if(pool->stopping && dequeIsEmpty(pool->injected)) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+
+        __atomic_add_fetch(&pool->sleeping, 1, __ATOMIC_SEQ_CST);
+
+        // Sleeps only if no task was made available since the search began
+        if(__atomic_load_n(&pool->signals, __ATOMIC_SEQ_CST) == signals && !pool->stopping)
+            pthread_cond_wait(&pool->workCond, &pool->mutex);
+
+        __atomic_sub_fetch(&pool->sleeping, 1, __ATOMIC_SEQ_CST);
+
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    currentWorker = NULL;
+
+    return NULL;
+}
+
+
+
+ThreadPool threadPoolNew(int nbThreads) {
+    ThreadPool pool = malloc(sizeof(struct _ThreadPool));
+
+    if(nbThreads <= 0)
+        nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(nbThreads <= 0)
+        nbThreads = 1;
+
+    pool->nbThreads = nbThreads;
+    pool->workers = malloc(nbThreads * sizeof(Worker));
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->workCond, NULL);
+    pthread_cond_init(&pool->doneCond, NULL);
+
+    pool->injected = dequeNew(sizeof(Task));
+    pool->nbInjected = 0;
+    pool->sleeping = 0;
+    pool->signals = 0;
+    pool->stopping = false;
+
+    // All the deques must exist before any worker tries to steal
+    for(int i=0; i<nbThreads; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+        pool->workers[i].seed = i+1;
+        pool->workers[i].tasks = workDequeNew(sizeof(Task));
+    }
+
+    for(int i=0; i<nbThreads; i++)
+        pthread_create(&pool->workers[i].thread, NULL, (void *(*)(void *))workerMain, &pool->workers[i]);
+
+    return pool;
+}
+
+void threadPoolDel(ThreadPool pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->workCond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for(int i=0; i<pool->nbThreads; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    for(int i=0; i<pool->nbThreads; i++)
+        workDequeDel(pool->workers[i].tasks);
+
+    dequeDel(pool->injected);
+
+    pthread_cond_destroy(&pool->doneCond);
+    pthread_cond_destroy(&pool->workCond);
+    pthread_mutex_destroy(&pool->mutex);
+
+    free(pool->workers);
+    free(pool);
+}
+
+static void createDefaultPool() {
+    defaultPool = threadPoolNew(0);
+}
+
+ThreadPool threadPoolGetDefault() {
+    pthread_once(&defaultPoolOnce, createDefaultPool);
+
+    return defaultPool;
+}
+
+int threadPoolSize(const ThreadPool pool) {
+    return pool->nbThreads;
+}
+
+
+
+Future threadPoolSubmit(ThreadPool pool, ElTaskFct fct, Ptr infos) {
+    Future f = malloc(sizeof(struct _Future));
+    Task task = {fct, infos, f};
+
+    f->pool = pool;
+    f->state = PENDING;
+
+    if(isOwnWorker(pool))
+        workDequePush(currentWorker->tasks, task);
+    else {
+        pthread_mutex_lock(&pool->mutex);
+        dequeAddLast(pool->injected, task);
+        __atomic_add_fetch(&pool->nbInjected, 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    notifyWork(pool);
+
+    return f;
+}
+
+bool futureIsDone(const Future f) {
+    return __atomic_load_n(&f->state, __ATOMIC_ACQUIRE) == DONE;
+}
+
+void futureJoin(Future f) {
+    ThreadPool pool = f->pool;
+    Task task;
+
+    while(__atomic_load_n(&f->state, __ATOMIC_ACQUIRE) != DONE) {
+        // Helps the pool rather than blocking, the awaited task may be one of those
+        if(findTask(pool, &task)) {
+            runTask(&task);
+            continue;
+        }
+
+        int state = PENDING;
+        __atomic_compare_exchange_n(&f->state, &state, WAITING, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+        pthread_mutex_lock(&pool->mutex);
+        if(__atomic_load_n(&f->state, __ATOMIC_ACQUIRE) != DONE)
+            pthread_cond_wait(&pool->doneCond, &pool->mutex);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    free(f);
+}
+
+
+
+typedef struct {
+    ElRangeFct fct;
+    Ptr infos;
+    long next; // next index to process, shared by all the participants
+    int to;
+    int grain;
+} ForData;
+
+// Each participant takes chunks until the range is exhausted, so that faster threads take more of them
+static void forRun(ForData *data) {
+    for(;;) {
+        long start = __atomic_fetch_add(&data->next, data->grain, __ATOMIC_RELAXED);
+
+        if(start >= data->to)
+            break;
+
+        int end = start + data->grain < data->to ? start + data->grain : data->to;
+
+        data->fct(start, end, data->infos);
+    }
+}
+
+void threadPoolParallelFor(ThreadPool pool, int from, int to, int grain, ElRangeFct fct, Ptr infos) {
+    if(from >= to)
+        return;
+
+    if(!pool)
+        pool = threadPoolGetDefault();
+
+    long length = (long)to - from;
+
+    // About 8 chunks per thread balances the load without too much scheduling
+    if(grain <= 0) {
+        grain = length / (8*pool->nbThreads);
+        if(grain < 1)
+            grain = 1;
+    }
+
+    long nbChunks = (length + grain - 1) / grain;
+
+    if(nbChunks == 1) {
+        fct(from, to, infos);
+        return;
+    }
+
+    ForData data = {fct, infos, from, to, grain};
+
+    int nbHelpers = nbChunks-1 < pool->nbThreads ? nbChunks-1 : pool->nbThreads;
+    Future *helpers = malloc(nbHelpers * sizeof(Future));
+
+    for(int i=0; i<nbHelpers; i++)
+        helpers[i] = threadPoolSubmit(pool, (ElTaskFct)forRun, &data);
+
+    forRun(&data);
+
+    for(int i=0; i<nbHelpers; i++)
+        futureJoin(helpers[i]);
+
+    free(helpers);
+}
@@ -0,0 +1,233 @@
+/**
+ * \file View.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ExtLib/Common.h"
+#include "ExtLib/View.h"
+
+#include "Serial.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct _ArrayView {
+    void *map;
+    size_t mapSize;
+
+    const ArrayFileHeader *header;
+    const void *elements;
+};
+
+struct _HashView {
+    void *map;
+    size_t mapSize;
+
+    const HashFileHeader *header;
+    const uint32_t *buckets;
+    const void *entries;
+    const char *strings;
+    uint64_t stringsSize;
+};
+
+
+
+// Shared with FrozenHash.c through Serial.h
+void *_elMapFile(const char *path, size_t minSize, size_t *size) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+        return NULL;
+
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < minSize) {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping keeps the file alive
+    close(fd);
+
+    if(map == MAP_FAILED)
+        return NULL;
+
+    *size = st.st_size;
+
+    return map;
+}
+
+
+
+ArrayView arrayViewOpen(const char *path) {
+    size_t size;
+    void *map = _elMapFile(path, sizeof(ArrayFileHeader), &size);
+
+    if(!map)
+        return NULL;
+
+    const ArrayFileHeader *header = map;
+
+    if(header->magic != ARRAY_MAGIC || header->version != SERIAL_VERSION || header->elemSize <= 0
+       || header->length > (size - sizeof(ArrayFileHeader)) / header->elemSize) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    ArrayView v = malloc(sizeof(struct _ArrayView));
+
+    v->map = map;
+    v->mapSize = size;
+    v->header = header;
+    v->elements = map + sizeof(ArrayFileHeader);
+
+    return v;
+}
+
+void arrayViewClose(ArrayView v) {
+    munmap(v->map, v->mapSize);
+    free(v);
+}
+
+int arrayViewLength(const ArrayView v) {
+    return v->header->length;
+}
+
+int arrayViewGetElemSize(const ArrayView v) {
+    return v->header->elemSize;
+}
+
+const Ptr arrayViewGet_base(const ArrayView v, int pos) {
+    return (Ptr)v->elements + (size_t)pos*v->header->elemSize;
+}
+
+
+
+// Checks the header against the size of the file, in constant time : the sections are neither read nor scanned
+static bool hashHeaderValid(const HashFileHeader *header, size_t size) {
+    uint64_t keySize = header->keySize ? header->keySize : sizeof(uint64_t);
+
+    if(header->magic != HASH_MAGIC || header->version != SERIAL_VERSION)
+        return false;
+
+    if(header->nbBuckets == 0 || (header->nbBuckets & (header->nbBuckets-1)) != 0)
+        return false;
+
+    if(header->valueOffset != 8 + SERIAL_ALIGN(keySize) || header->entrySize != SERIAL_ALIGN(header->valueOffset + header->elemSize))
+        return false;
+
+    if(header->fileSize != size || header->bucketsOffset % 8 != 0 || header->entriesOffset % 8 != 0
+       || header->bucketsOffset < sizeof(HashFileHeader)
+       || header->entriesOffset < header->bucketsOffset + (header->nbBuckets+1)*(uint64_t)sizeof(uint32_t)
+       || header->entriesOffset > size || header->length > (size - header->entriesOffset) / header->entrySize
+       || header->stringsOffset != header->entriesOffset + header->length*header->entrySize
+       || header->stringsOffset > size)
+        return false;
+
+    return true;
+}
+
+HashView hashViewOpen(const char *path) {
+    size_t size;
+    void *map = _elMapFile(path, sizeof(HashFileHeader), &size);
+
+    if(!map)
+        return NULL;
+
+    const HashFileHeader *header = map;
+
+    if(!hashHeaderValid(header, size)) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    const uint32_t *buckets = map + header->bucketsOffset;
+    const char *strings = map + header->stringsOffset;
+    uint64_t stringsSize = size - header->stringsOffset;
+
+    // Lookups bound the entries of a bucket by the total, and strings by the final NUL
+    if(buckets[0] != 0 || buckets[header->nbBuckets] != header->length
+       || (header->keySize == 0 && header->length > 0 && (stringsSize == 0 || strings[stringsSize-1] != '\0'))) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    HashView v = malloc(sizeof(struct _HashView));
+
+    v->map = map;
+    v->mapSize = size;
+    v->header = header;
+    v->buckets = buckets;
+    v->entries = map + header->entriesOffset;
+    v->strings = strings;
+    v->stringsSize = stringsSize;
+
+    return v;
+}
+
+void hashViewClose(HashView v) {
+    munmap(v->map, v->mapSize);
+    free(v);
+}
+
+int hashViewLength(const HashView v) {
+    return v->header->length;
+}
+
+bool hashViewHasStringKeys(const HashView v) {
+    return v->header->keySize == 0;
+}
+
+// Scans the entries of the bucket of hash, match tells whether the key of an entry is the searched one
+static const Ptr hashViewFind(const HashView v, uint64_t hash, bool (*match)(const HashView, const void *, const void *), const void *key) {
+    uint32_t bucket = hash & (v->header->nbBuckets-1);
+    uint32_t from = v->buckets[bucket];
+    uint32_t to = v->buckets[bucket+1];
+
+    if(from > to || to > v->header->length)
+        return NULL;
+
+    for(uint32_t e=from; e<to; e++) {
+        const void *entry = v->entries + (uint64_t)e*v->header->entrySize;
+
+        if(*(const uint64_t *)entry == hash && match(v, entry + 8, key))
+            return (Ptr)entry + v->header->valueOffset;
+    }
+
+    return NULL;
+}
+
+static bool matchBytes(const HashView v, const void *entryKey, const void *key) {
+    return memcmp(entryKey, key, v->header->keySize) == 0;
+}
+
+static bool matchString(const HashView v, const void *entryKey, const char *key) {
+    uint64_t offset = *(const uint64_t *)entryKey;
+
+    return offset < v->stringsSize && strcmp(v->strings + offset, key) == 0;
+}
+
+const Ptr hashViewGet_base(const HashView v, const Ptr key) {
+    if(v->header->keySize == 0)
+        return NULL;
+
+    return hashViewFind(v, hashBytes(key, v->header->keySize), matchBytes, key);
+}
+
+const Ptr hashViewGetStr(const HashView v, const char *key) {
+    if(v->header->keySize != 0)
+        return NULL;
+
+    return hashViewFind(v, hashBytes(key, strlen(key)), (bool (*)(const HashView, const void *, const void *))matchString, key);
+}
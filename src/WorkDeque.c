@@ -0,0 +1,217 @@
+/**
+ * \file WorkDeque.c
+ * \author Jason Pindat
+ * \date 2026-10-19
+ *
+ * Copyright 2014-2016
+ *
+ * Follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli, 2013).
+ *
+ */
+
+#include "ExtLib/Common.h"
+#include "ExtLib/WorkDeque.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFSIZE 64 // must be a power of 2
+#define CACHELINE 64
+
+typedef struct _WorkArray *WorkArray;
+
+struct _WorkArray {
+    long size; // power of 2
+    WorkArray retired; // previous array, kept alive while thieves may still read it
+    char ct[];
+};
+
+struct _WorkDeque {
+    int elemSize;
+    ElCopyFct copyFct;
+    ElDelFct delFct;
+
+    WorkArray array;
+
+    char pad0[CACHELINE];
+
+    long top; // next element to steal, only increased
+    char pad1[CACHELINE - sizeof(long)];
+
+    long bottom; // next free position, written by the owner only
+    char pad2[CACHELINE - sizeof(long)];
+};
+
+
+
+static inline void *workSlot(const WorkDeque wd, WorkArray a, long pos) {
+    return a->ct + (pos & (a->size - 1))*wd->elemSize;
+}
+
+static WorkArray workArrayNew(const WorkDeque wd, long size) {
+    WorkArray a = malloc(sizeof(struct _WorkArray) + size*wd->elemSize);
+
+    a->size = size;
+    a->retired = NULL;
+
+    return a;
+}
+
+// Copies the live elements in an array twice as big. The old one can't be freed : a thief may be reading it.
+static WorkArray workDequeGrow(WorkDeque wd, WorkArray a, long top, long bottom) {
+    WorkArray a2 = workArrayNew(wd, 2*a->size);
+
+    for(long i=top; i<bottom; i++)
+        memcpy(workSlot(wd, a2, i), workSlot(wd, a, i), wd->elemSize);
+
+    a2->retired = a;
+
+    __atomic_store_n(&wd->array, a2, __ATOMIC_RELEASE);
+
+    return a2;
+}
+
+
+
+WorkDeque workDequeNew(int elemSize) {
+    WorkDeque wd = malloc(sizeof(struct _WorkDeque));
+
+    wd->elemSize = elemSize<=0 ? _elSizeFct(elemSize) : elemSize;
+    wd->copyFct = NULL;
+    wd->delFct = NULL;
+
+    wd->array = workArrayNew(wd, DEFSIZE);
+
+    wd->top = 0;
+    wd->bottom = 0;
+
+    return wd;
+}
+
+void workDequeDel(WorkDeque wd) {
+    WorkArray a = wd->array;
+
+    if(wd->delFct) {
+        for(long i=wd->top; i<wd->bottom; i++)
+            wd->delFct(workSlot(wd, a, i));
+    }
+
+    while(a) {
+        WorkArray retired = a->retired;
+        free(a);
+        a = retired;
+    }
+
+    free(wd);
+}
+
+void workDequeElementInstanciable(WorkDeque wd, ElCopyFct copyFct, ElDelFct delFct) {
+    wd->copyFct = copyFct;
+    wd->delFct = delFct;
+}
+
+
+
+bool workDequeIsEmpty(const WorkDeque wd) {
+    return workDequeLength(wd) == 0;
+}
+
+int workDequeLength(const WorkDeque wd) {
+    long bottom = __atomic_load_n(&wd->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&wd->top, __ATOMIC_RELAXED);
+
+    return bottom > top ? bottom - top : 0;
+}
+
+
+
+void workDequePush_base(WorkDeque wd, const Ptr data) {
+    long bottom = __atomic_load_n(&wd->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&wd->top, __ATOMIC_ACQUIRE);
+    WorkArray a = __atomic_load_n(&wd->array, __ATOMIC_RELAXED);
+
+    if(bottom - top > a->size - 1)
+        a = workDequeGrow(wd, a, top, bottom);
+
+    if(wd->copyFct)
+        wd->copyFct(workSlot(wd, a, bottom), data);
+    else
+        memcpy(workSlot(wd, a, bottom), data, wd->elemSize);
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&wd->bottom, bottom+1, __ATOMIC_RELAXED);
+}
+
+bool workDequePop_base(WorkDeque wd, Ptr dest) {
+    long bottom = __atomic_load_n(&wd->bottom, __ATOMIC_RELAXED) - 1;
+    WorkArray a = __atomic_load_n(&wd->array, __ATOMIC_RELAXED);
+
+    // Reserves the bottom element before looking at top, thieves see the reservation
+    __atomic_store_n(&wd->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&wd->top, __ATOMIC_RELAXED);
+
+    if(top > bottom) {
+        // Empty
+        __atomic_store_n(&wd->bottom, bottom+1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    if(top == bottom) {
+        // Last element : races with the thieves for it
+        bool won = __atomic_compare_exchange_n(&wd->top, &top, top+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+
+        __atomic_store_n(&wd->bottom, bottom+1, __ATOMIC_RELAXED);
+
+        if(!won)
+            return false;
+    }
+
+    memcpy(dest, workSlot(wd, a, bottom), wd->elemSize);
+
+    return true;
+}
+
+bool workDequeSteal_base(WorkDeque wd, Ptr dest) {
+    for(;;) {
+        long top = __atomic_load_n(&wd->top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        long bottom = __atomic_load_n(&wd->bottom, __ATOMIC_ACQUIRE);
+
+        if(top >= bottom)
+            return false;
+
+        WorkArray a = __atomic_load_n(&wd->array, __ATOMIC_ACQUIRE);
+
+        // Read before claiming : once top moves, the owner may overwrite the slot
+        memcpy(dest, workSlot(wd, a, top), wd->elemSize);
+
+        if(__atomic_compare_exchange_n(&wd->top, &top, top+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            return true;
+
+        // Lost the race against another thief or the owner, try the next element
+    }
+}
+
+
+
+void workDequeDump(const WorkDeque wd) {
+    int elts = workDequeLength(wd);
+    int effcost = elts*wd->elemSize;
+    int opcost = sizeof(struct _WorkDeque);
+    int preallcost = (wd->array->size - elts)*wd->elemSize;
+
+    for(WorkArray a = wd->array; a; a = a->retired)
+        opcost += sizeof(struct _WorkArray);
+
+    for(WorkArray a = wd->array->retired; a; a = a->retired)
+        opcost += a->size*wd->elemSize;
+
+    printf("Work-stealing deque at %p\n", wd);
+    printf("\t%d elements, each using %d bytes\n", elts, wd->elemSize);
+    printf("\t%d bytes used for elements\n", effcost);
+    printf("\t%d bytes used as operating cost\n", opcost);
+    printf("\t%d bytes used as preallocated\n", preallcost);
+    printf("\t%d bytes total used\n", effcost+opcost+preallcost);
+}
@@ -0,0 +1,145 @@
+#include "ExtLib/Array.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every search and reduction is run twice on the same elements : once on an array using the kernels, once on an array
+// whose comparison function is a wrapper of the default one, which makes Array fall back to the comparator path.
+// Lengths around the vector widths check the tails of the kernels.
+// The arrays are then sorted, and searched with the bound searches and with an ArrayIndex of each.
+
+#define POOLSIZE 16
+
+static const int lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 257, 1000, 4099};
+#define NBLENGTHS (int)(sizeof(lengths)/sizeof(lengths[0]))
+
+static ElCmpFct defaultCmp;
+static long checks = 0;
+static long failures = 0;
+
+static int wrapperCmp(Ptr v1, Ptr v2) {
+    return defaultCmp(v1, v2);
+}
+
+static void check(bool ok, const char *type, const char *what, int length) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s : %s differs for length %d\n", type, what, length);
+    }
+}
+
+static uint64_t random64() {
+    return (uint64_t)rand() << 42 ^ (uint64_t)rand() << 21 ^ (uint64_t)rand();
+}
+
+// Elements are drawn from a small pool, so that values repeat, and the pool covers the whole range of the type
+#define TEST_TYPE(name, type, elType, sumType, randomValue) \
+static void test##name() { \
+    type pool[POOLSIZE]; \
+    \
+    defaultCmp = _elCompareFct(elType); \
+    \
+    for(int l=0; l<NBLENGTHS; l++) { \
+        int length = lengths[l]; \
+        Array k = arrayNew(elType); \
+        Array g = arrayNew(elType); \
+        sumType refSum = 0; \
+        \
+        arrayComparable(g, wrapperCmp); \
+        \
+        for(int i=0; i<POOLSIZE; i++) \
+            pool[i] = randomValue; \
+        \
+        for(int i=0; i<length; i++) { \
+            type v = pool[rand()%POOLSIZE]; \
+            arrayPush(k, v); \
+            arrayPush(g, v); \
+            refSum = (sumType)(refSum + (sumType)v); \
+        } \
+        \
+        for(int q=0; q<=POOLSIZE; q++) { \
+            type v = q < POOLSIZE ? pool[q] : randomValue; \
+            \
+            check(arrayIndexOf(k, &v) == arrayIndexOf(g, &v), #name, "arrayIndexOf", length); \
+            check(arrayLastIndexOf(k, &v) == arrayLastIndexOf(g, &v), #name, "arrayLastIndexOf", length); \
+            check(arrayCount(k, &v) == arrayCount(g, &v), #name, "arrayCount", length); \
+            check(arrayContains(k, &v) == arrayContains(g, &v), #name, "arrayContains", length); \
+        } \
+        \
+        check(arrayMinIndex(k) == arrayMinIndex(g), #name, "arrayMinIndex", length); \
+        check(arrayMaxIndex(k) == arrayMaxIndex(g), #name, "arrayMaxIndex", length); \
+        \
+        type sum = 0; \
+        arraySum(k, sum); \
+        check(sum == (type)refSum, #name, "arraySum", length); \
+        \
+        arraySort(k, EL_ASC); \
+        arraySort(g, EL_ASC); \
+        \
+        ArrayIndex idxK = arrayIndexNew(k); \
+        ArrayIndex idxG = arrayIndexNew(g); \
+        \
+        for(int q=0; q<2*POOLSIZE; q++) { \
+            type v = q < POOLSIZE ? pool[q] : randomValue; \
+            int lower = arrayLowerBound(g, &v); \
+            \
+            check(arrayLowerBound(k, &v) == lower, #name, "arrayLowerBound", length); \
+            check(arrayUpperBound(k, &v) == arrayUpperBound(g, &v), #name, "arrayUpperBound", length); \
+            check(arrayBSearch(k, &v) == arrayBSearch(g, &v), #name, "arrayBSearch", length); \
+            \
+            int from, to; \
+            arrayEqualRange(k, &v, &from, &to); \
+            check(from == lower && to == arrayUpperBound(g, &v), #name, "arrayEqualRange", length); \
+            check(arrayBSearch(k, &v) == (from < to ? from : -1), #name, "arrayBSearch (first match)", length); \
+            \
+            check(arrayIndexLowerBound(idxK, &v) == lower, #name, "arrayIndexLowerBound", length); \
+            check(arrayIndexLowerBound(idxG, &v) == lower, #name, "arrayIndexLowerBound (comparator)", length); \
+            check(arrayIndexFind(idxK, &v) == arrayBSearch(g, &v), #name, "arrayIndexFind", length); \
+            check(arrayIndexFind(idxG, &v) == arrayBSearch(g, &v), #name, "arrayIndexFind (comparator)", length); \
+        } \
+        \
+        arrayIndexDel(idxK); \
+        arrayIndexDel(idxG); \
+        arrayDel(k); \
+        arrayDel(g); \
+    } \
+}
+
+TEST_TYPE(Char, char, EL_CHAR, unsigned char, (char)random64())
+TEST_TYPE(Uchar, unsigned char, EL_UCHAR, unsigned char, (unsigned char)random64())
+TEST_TYPE(Short, short, EL_SHORT, unsigned short, (short)random64())
+TEST_TYPE(Ushort, unsigned short, EL_USHORT, unsigned short, (unsigned short)random64())
+TEST_TYPE(Int, int, EL_INT, unsigned int, (int)random64())
+TEST_TYPE(Uint, unsigned int, EL_UINT, unsigned int, (unsigned int)random64())
+TEST_TYPE(Long, long, EL_LONG, unsigned long, (long)random64())
+TEST_TYPE(Ulong, unsigned long, EL_ULONG, unsigned long, (unsigned long)random64())
+TEST_TYPE(Longlong, long long, EL_LONGLONG, unsigned long long, (long long)random64())
+TEST_TYPE(Ulonglong, unsigned long long, EL_ULONGLONG, unsigned long long, (unsigned long long)random64())
+// Quarters of small integers : every sum is exact, whatever the order of the additions
+TEST_TYPE(Float, float, EL_FLOAT, double, (float)(rand()%2001 - 1000) / 4)
+TEST_TYPE(Double, double, EL_DOUBLE, double, (double)(rand()%2001 - 1000) / 4)
+
+int main() {
+    srand(37);
+
+    testChar();
+    testUchar();
+    testShort();
+    testUshort();
+    testInt();
+    testUint();
+    testLong();
+    testUlong();
+    testLonglong();
+    testUlonglong();
+    testFloat();
+    testDouble();
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
@@ -0,0 +1,293 @@
+#include "ExtLib/Cache.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Random gets, puts and removals are replayed on a plain array of the keys, which gives the value of each key and
+// whether it may be cached. The counters of the cache are checked against the outcome of each operation, and an LRU
+// cache against a model evicting the key with the oldest access time.
+
+#define NBKEYS 5000
+#define CAPACITY 1000
+#define NBOPS 300000
+#define NBTHREADS 8
+
+static long checks = 0;
+static long failures = 0;
+
+static const char *policyNames[] = {"LRU", "CLOCK", "TinyLFU"};
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+typedef struct {
+    bool put[NBKEYS];     // The key was put and not removed since, it may be cached
+    long value[NBKEYS];   // Last value put for the key
+    long time[NBKEYS];    // Last access of the key, for the LRU model
+    bool cached[NBKEYS];  // Keys the LRU model holds
+    int length;           // Length of the LRU model
+} Reference;
+
+static void lruAccess(Reference *ref, int k, long now) {
+    ref->time[k] = now;
+
+    if(ref->cached[k])
+        return;
+
+    if(ref->length == CAPACITY) {
+        int oldest = -1;
+
+        for(int i=0; i<NBKEYS; i++)
+            if(ref->cached[i] && (oldest < 0 || ref->time[i] < ref->time[oldest]))
+                oldest = i;
+
+        ref->cached[oldest] = false;
+        ref->length--;
+    }
+
+    ref->cached[k] = true;
+    ref->length++;
+}
+
+// Only keys put and not removed are cached, with their last value
+static bool checkContent(Cache c, const Reference *ref, int policy) {
+    int length = 0;
+    bool ok = cacheLength(c) <= CAPACITY;
+
+    for(int k=0; ok && k<NBKEYS; k++) {
+        if(!cacheContains(c, k))
+            continue;
+
+        length++;
+        ok = ref->put[k];
+    }
+
+    if(policy == EL_CACHE_LRU)
+        for(int k=0; ok && k<NBKEYS; k++)
+            ok = cacheContains(c, k) == ref->cached[k];
+
+    return ok && length == cacheLength(c);
+}
+
+static void testPolicy(int policy) {
+    static Reference ref;
+    Cache c = cacheNew(EL_INT, EL_LONG, NULL, CAPACITY, policy);
+    CacheStats expected = {0, 0, 0};
+    bool ok = cacheCapacity(c) == CAPACITY;
+    char what[64];
+
+    memset(&ref, 0, sizeof(ref));
+    sprintf(what, "%s cache", policyNames[policy]);
+
+    for(long op=0; op<NBOPS; op++) {
+        // Skewed keys, so that some are hot : half of the operations use a tenth of the keys
+        int k = rand()%2 ? rand()%(NBKEYS/10) : rand()%NBKEYS;
+        int action = rand()%10;
+        bool had = cacheContains(c, k);
+        int length = cacheLength(c);
+
+        if(action < 6) {
+            const long *value = cacheGetPtr(c, k, long);
+
+            ok = ok && (value != NULL) == had && (!value || *value == ref.value[k]);
+
+            if(had) {
+                expected.hits++;
+                lruAccess(&ref, k, op);
+            }
+            else
+                expected.misses++;
+        }
+        else if(action < 9) {
+            long v = op;
+            cachePut(c, k, v);
+
+            ref.put[k] = true;
+            ref.value[k] = v;
+
+            // A new key fills an entry, or evicts one (TinyLFU may evict the new key itself)
+            ok = ok && cacheLength(c) <= CAPACITY;
+            if(!had)
+                expected.evictions += length + 1 - cacheLength(c);
+            else
+                ok = ok && cacheLength(c) == length;
+
+            lruAccess(&ref, k, op);
+        }
+        else {
+            ok = ok && cacheRemove(c, k) == had && !cacheContains(c, k);
+
+            ref.put[k] = false;
+            if(ref.cached[k]) {
+                ref.cached[k] = false;
+                ref.length--;
+            }
+        }
+
+        if(op%30000 == 29999) {
+            CacheStats stats = cacheGetStats(c);
+
+            check(ok, what);
+            check(checkContent(c, &ref, policy), what);
+            check(stats.hits == expected.hits && stats.misses == expected.misses && stats.evictions == expected.evictions, what);
+        }
+    }
+
+    // The cache fills up to its capacity
+    for(int k=0; k<NBKEYS; k++)
+        cachePutI(c, k, 0L, long);
+    check(cacheLength(c) == CAPACITY, what);
+
+    cacheResetStats(c);
+    CacheStats stats = cacheGetStats(c);
+    check(stats.hits == 0 && stats.misses == 0 && stats.evictions == 0, what);
+
+    cacheClear(c);
+    memset(&ref, 0, sizeof(ref));
+    check(cacheLength(c) == 0 && checkContent(c, &ref, policy), what);
+
+    cacheDel(c);
+}
+
+// A single entry : every new key evicts the previous one, except when TinyLFU doesn't admit it
+static void testTinyCapacity(int policy) {
+    Cache c = cacheNew(EL_INT, EL_INT, NULL, 1, policy);
+    bool ok = true;
+
+    for(int k=0; k<100; k++) {
+        cachePutI(c, k, -k, int);
+        ok = ok && cacheLength(c) == 1;
+    }
+
+    check(ok && cacheGetStats(c).evictions == 99, "cache of one entry");
+
+    cacheDel(c);
+}
+
+static void testStrings(int policy) {
+    Cache c = cacheNewStr(EL_INT, 100, policy);
+    char buff[32];
+    bool ok = true;
+
+    for(int i=0; i<1000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        cachePutI(c, key, i, int);
+    }
+
+    // The cache copied the strings it kept
+    for(int i=0; i<1000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        const int *value = cacheGetPtr(c, key, int);
+        ok = ok && (!value || *value == i);
+    }
+
+    check(ok && cacheLength(c) == 100, "string keys");
+
+    cacheDel(c);
+}
+
+typedef struct {
+    ShardedCache cache;
+    uint32_t rng;
+    long gets;
+    bool ok;
+} Worker;
+
+// rand isn't meant for threads : each worker has its own xorshift generator
+static int nextRandom(Worker *w) {
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+
+    return w->rng >> 1;
+}
+
+// Values are always 3 times their key : a value read for another key, or half written, is caught
+static void *work(void *arg) {
+    Worker *w = arg;
+
+    for(int op=0; op<NBOPS; op++) {
+        int k = nextRandom(w)%NBKEYS;
+        int action = nextRandom(w)%10;
+
+        if(action < 6) {
+            long value = -1;
+
+            if(shardedCacheGet(w->cache, k, value))
+                w->ok = w->ok && value == 3L*k;
+
+            w->gets++;
+        }
+        else if(action < 9) {
+            shardedCachePutI(w->cache, k, 3L*k, long);
+        }
+        else
+            shardedCacheRemove(w->cache, k);
+
+        if(op%1000 == 0)
+            w->ok = w->ok && shardedCacheLength(w->cache) <= CAPACITY;
+    }
+
+    return NULL;
+}
+
+static void testSharded(int policy, int nbShards) {
+    ShardedCache c = shardedCacheNew(EL_INT, EL_LONG, NULL, CAPACITY, policy, nbShards);
+    pthread_t threads[NBTHREADS];
+    Worker workers[NBTHREADS];
+    bool ok = true;
+    long gets = 0;
+
+    for(int t=0; t<NBTHREADS; t++) {
+        workers[t].cache = c;
+        workers[t].rng = 49 + t;
+        workers[t].gets = 0;
+        workers[t].ok = true;
+        pthread_create(&threads[t], NULL, work, &workers[t]);
+    }
+
+    for(int t=0; t<NBTHREADS; t++) {
+        pthread_join(threads[t], NULL);
+        ok = ok && workers[t].ok;
+        gets += workers[t].gets;
+    }
+
+    CacheStats stats = shardedCacheGetStats(c);
+    int length = shardedCacheLength(c);
+
+    check(ok && length > 0 && length <= CAPACITY && stats.hits + stats.misses == gets, "sharded cache");
+
+    shardedCacheClear(c);
+    check(shardedCacheLength(c) == 0, "sharded cache clear");
+
+    shardedCacheDel(c);
+}
+
+int main() {
+    srand(49);
+
+    for(int policy=EL_CACHE_LRU; policy<=EL_CACHE_TINYLFU; policy++) {
+        testPolicy(policy);
+        testTinyCapacity(policy);
+        testStrings(policy);
+
+        // More shards than entries, then a few entries per shard
+        testSharded(policy, 2048);
+        testSharded(policy, 16);
+    }
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
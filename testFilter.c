@@ -0,0 +1,277 @@
+#include "ExtLib/Filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Keys 0 to NBKEYS-1 are added to the filters, the other ints are absent. A filter must find every key it holds (no
+// false negatives), and find about the requested share of the absent ones. Every filter is also saved and loaded back,
+// and must then give the same answers.
+
+#define NBKEYS 100000
+#define NBABSENT 1000000
+#define SAVED "testFilter.bin"
+
+static long checks = 0;
+static long failures = 0;
+
+static int *keys;
+static int *absent;
+static bool *results;
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+// Rates are measured on a million keys : allows a margin of a few standard deviations over the requested rate
+static void checkRate(int found, double fpRate, const char *what) {
+    double rate = (double)found / NBABSENT;
+
+    if(rate > fpRate*1.2 + 0.0001) {
+        printf("%s : false positive rate %g for %g requested\n", what, rate, fpRate);
+        check(false, what);
+    }
+    else
+        check(true, what);
+}
+
+// Single and batched lookups agree : the keys must all be found, the number of absent ones found is returned
+#define LOOKUPS(prefix, type) \
+static int prefix##Lookups(const type f, int nbKeys, const char *what) { \
+    bool ok = prefix##ContainsMany(f, keys, nbKeys, results) == nbKeys; \
+    \
+    for(int i=0; i<nbKeys; i++) \
+        ok = ok && results[i] && prefix##Contains(f, keys[i]); \
+    \
+    int found = prefix##ContainsMany(f, absent, NBABSENT, results); \
+    int single = 0; \
+    \
+    for(int i=0; i<NBABSENT; i++) { \
+        bool has = prefix##Contains(f, absent[i]); \
+        single += has; \
+        ok = ok && has == results[i]; \
+    } \
+    \
+    check(ok && found == single, what); \
+    \
+    return found; \
+}
+
+LOOKUPS(bloomFilter, BloomFilter)
+LOOKUPS(cuckooFilter, CuckooFilter)
+LOOKUPS(xorFilter, XorFilter)
+
+static void testBloom(double fpRate) {
+    BloomFilter f = bloomFilterNew(EL_INT, NULL, NBKEYS, fpRate);
+
+    // Half the keys one by one, half in a batch
+    for(int i=0; i<NBKEYS/2; i++)
+        bloomFilterAdd(f, keys[i]);
+    bloomFilterAddMany(f, keys + NBKEYS/2, NBKEYS - NBKEYS/2);
+
+    check(bloomFilterLength(f) == NBKEYS, "Bloom filter length");
+
+    int found = bloomFilterLookups(f, NBKEYS, "Bloom filter lookups");
+    checkRate(found, fpRate, "Bloom filter false positive rate");
+
+    check(bloomFilterSave(f, SAVED), "Bloom filter save");
+    BloomFilter f2 = bloomFilterLoad(SAVED, NULL);
+
+    check(f2 && bloomFilterLength(f2) == NBKEYS, "Bloom filter load");
+    if(f2) {
+        check(bloomFilterLookups(f2, NBKEYS, "loaded Bloom filter lookups") == found, "loaded Bloom filter false positives");
+        bloomFilterDel(f2);
+    }
+
+    bloomFilterClear(f);
+    check(bloomFilterLength(f) == 0 && bloomFilterContainsMany(f, keys, NBKEYS, NULL) == 0, "Bloom filter clear");
+
+    bloomFilterDel(f);
+}
+
+static void testCuckoo(double fpRate) {
+    CuckooFilter f = cuckooFilterNew(EL_INT, NULL, NBKEYS, fpRate);
+    bool ok = true;
+
+    for(int i=0; i<NBKEYS; i++)
+        ok = ok && cuckooFilterAdd(f, keys[i]);
+
+    check(ok && cuckooFilterLength(f) == NBKEYS, "cuckoo filter additions");
+
+    int found = cuckooFilterLookups(f, NBKEYS, "cuckoo filter lookups");
+    checkRate(found, fpRate, "cuckoo filter false positive rate");
+
+    check(cuckooFilterSave(f, SAVED), "cuckoo filter save");
+    CuckooFilter f2 = cuckooFilterLoad(SAVED, NULL);
+
+    check(f2 && cuckooFilterLength(f2) == NBKEYS, "cuckoo filter load");
+    if(f2) {
+        check(cuckooFilterLookups(f2, NBKEYS, "loaded cuckoo filter lookups") == found, "loaded cuckoo filter false positives");
+        cuckooFilterDel(f2);
+    }
+
+    // Removing keys sharing fingerprints with others mustn't make the remaining ones disappear
+    ok = true;
+    for(int i=0; i<NBKEYS; i+=2)
+        ok = ok && cuckooFilterRemove(f, keys[i]);
+
+    check(ok && cuckooFilterLength(f) == NBKEYS/2, "cuckoo filter removals");
+
+    ok = true;
+    for(int i=1; i<NBKEYS; i+=2)
+        ok = ok && cuckooFilterContains(f, keys[i]);
+    check(ok, "cuckoo filter keys left after removals");
+
+    // A key added twice is still found after one removal
+    int twice = keys[1];
+    cuckooFilterAdd(f, twice);
+    cuckooFilterRemove(f, twice);
+    check(cuckooFilterContains(f, twice), "cuckoo filter key added twice");
+
+    cuckooFilterDel(f);
+}
+
+// Fills a small cuckoo filter until an addition kicks a fingerprint out for good : that victim must still be found,
+// and removing any key must make room for it again
+static void testCuckooVictim() {
+    CuckooFilter f = cuckooFilterNew(EL_INT, NULL, 1000, 0.001);
+    int added = 0;
+
+    while(cuckooFilterAdd(f, keys[added]))
+        added++;
+
+    bool ok = added >= 1000 && added < NBKEYS && cuckooFilterLength(f) == added;
+    for(int i=0; i<added; i++)
+        ok = ok && cuckooFilterContains(f, keys[i]);
+    check(ok, "cuckoo filter victim found");
+
+    // The victim is saved with the filter
+    check(cuckooFilterSave(f, SAVED), "full cuckoo filter save");
+    CuckooFilter f2 = cuckooFilterLoad(SAVED, NULL);
+
+    ok = f2 && cuckooFilterLength(f2) == added && !cuckooFilterAdd(f2, keys[added]);
+    for(int i=0; ok && i<added; i++)
+        ok = cuckooFilterContains(f2, keys[i]);
+    check(ok, "loaded cuckoo filter victim");
+
+    if(f2)
+        cuckooFilterDel(f2);
+
+    // Removals free slots until one of them, in a bucket of the victim, takes it back : the filter then accepts keys
+    // again, and the keys left are all found
+    int removed = 0;
+    ok = true;
+
+    while(ok && removed < added && !cuckooFilterAdd(f, keys[added])) {
+        ok = cuckooFilterRemove(f, keys[removed]);
+        removed++;
+    }
+
+    ok = ok && removed < added && cuckooFilterLength(f) == added - removed + 1;
+    for(int i=removed; ok && i<=added; i++)
+        ok = cuckooFilterContains(f, keys[i]);
+    check(ok, "cuckoo filter after the victim moved back");
+
+    cuckooFilterClear(f);
+    check(cuckooFilterLength(f) == 0 && cuckooFilterAdd(f, keys[0]), "full cuckoo filter clear");
+
+    cuckooFilterDel(f);
+}
+
+static void testXor(double fpRate) {
+    // Keys given twice count once
+    int *dup = malloc(2*NBKEYS * sizeof(int));
+    for(int i=0; i<NBKEYS; i++) {
+        dup[2*i] = keys[i];
+        dup[2*i+1] = keys[i];
+    }
+
+    XorFilter f = xorFilterNew(EL_INT, NULL, dup, 2*NBKEYS, fpRate);
+    free(dup);
+
+    check(f && xorFilterLength(f) == NBKEYS, "xor filter build");
+
+    if(!f)
+        return;
+
+    int found = xorFilterLookups(f, NBKEYS, "xor filter lookups");
+    checkRate(found, fpRate, "xor filter false positive rate");
+
+    check(xorFilterSave(f, SAVED), "xor filter save");
+    XorFilter f2 = xorFilterLoad(SAVED, NULL);
+
+    check(f2 && xorFilterLength(f2) == NBKEYS, "xor filter load");
+    if(f2) {
+        check(xorFilterLookups(f2, NBKEYS, "loaded xor filter lookups") == found, "loaded xor filter false positives");
+        xorFilterDel(f2);
+    }
+
+    xorFilterDel(f);
+
+    // Keys from an array and from a hash table
+    Array a = arrayNew(EL_INT);
+    Hash h = hashNew(EL_INT, EL_CHAR, NULL);
+
+    for(int i=0; i<1000; i++) {
+        char v = 0;
+        arrayPush(a, keys[i]);
+        hashSet(h, keys[i], v);
+    }
+
+    f = xorFilterNewFromArray(a, EL_INT, NULL, fpRate);
+    XorFilter fh = xorFilterNewFromHash(h, fpRate);
+
+    check(f && fh && xorFilterContainsMany(f, keys, 1000, NULL) == 1000 && xorFilterContainsMany(fh, keys, 1000, NULL) == 1000, "xor filters from collections");
+
+    if(f)
+        xorFilterDel(f);
+    if(fh)
+        xorFilterDel(fh);
+
+    arrayDel(a);
+    hashDel(h);
+
+    // An empty filter only finds the keys whose fingerprint is null, at the requested rate
+    f = xorFilterNew(EL_INT, NULL, keys, 0, fpRate);
+    check(f && xorFilterLength(f) == 0, "empty xor filter");
+
+    if(f) {
+        checkRate(xorFilterContainsMany(f, absent, NBABSENT, NULL), fpRate, "empty xor filter false positive rate");
+        xorFilterDel(f);
+    }
+}
+
+int main() {
+    srand(48);
+
+    keys = malloc(NBKEYS * sizeof(int));
+    absent = malloc(NBABSENT * sizeof(int));
+    results = malloc(NBABSENT * sizeof(bool));
+
+    for(int i=0; i<NBKEYS; i++)
+        keys[i] = i;
+    for(int i=0; i<NBABSENT; i++)
+        absent[i] = NBKEYS + i;
+
+    testBloom(0.01);
+    testBloom(0.001);
+    testCuckoo(0.05);
+    testCuckoo(0.001);
+    testCuckooVictim();
+    testXor(0.01);
+    testXor(0.0001);
+
+    remove(SAVED);
+
+    free(keys);
+    free(absent);
+    free(results);
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
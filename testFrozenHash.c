@@ -0,0 +1,204 @@
+#include "ExtLib/FrozenHash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Hash tables are frozen, then saved and mapped back : every key must be found with its value, in the frozen table and
+// in the mapped one, and keys which weren't in the hash table must miss
+
+#define SAVED "testFrozenHash.bin"
+
+static long checks = 0;
+static long failures = 0;
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+// Keys with padding-free bytes of a positive size
+typedef struct {
+    int x;
+    int y;
+    int z;
+} Triple;
+
+static unsigned long hashTriple(Ptr key) {
+    return hashBytes(key, sizeof(Triple));
+}
+
+static int compareTriple(Ptr key1, Ptr key2) {
+    return memcmp(key1, key2, sizeof(Triple));
+}
+
+static bool checkIntKeys(const FrozenHash fh, const Hash h) {
+    bool ok = fh && frozenHashLength(fh) == hashLength(h) && !frozenHashHasStringKeys(fh);
+
+    for(HashIt it = hashItNew(h); ok && hashItExists(&it); hashItNext(&it)) {
+        const long *value = frozenHashGet_base(fh, hashItGetKey_base(&it));
+        ok = value && *value == hashItGet(&it, long);
+    }
+
+    // Keys of the hash table are even
+    for(int i=0; ok && i<10000; i++) {
+        int missing = 2*(rand()%1000000) + 1;
+        ok = frozenHashGet(fh, missing) == NULL;
+    }
+
+    return ok;
+}
+
+static void testIntKeys() {
+    int lengths[] = {0, 1, 2, 3, 100, 100000};
+
+    for(int l=0; l<6; l++) {
+        Hash h = hashNew(EL_INT, EL_LONG, NULL);
+
+        while(hashLength(h) < lengths[l]) {
+            int k = 2*(rand()%1000000);
+            long v = -3L*k;
+            hashSet(h, k, v);
+        }
+
+        FrozenHash fh = hashFreeze(h);
+        check(checkIntKeys(fh, h), "frozen int keys");
+
+        check(fh && frozenHashSave(fh, SAVED), "save of int keys");
+
+        if(fh)
+            frozenHashDel(fh);
+
+        fh = frozenHashOpen(SAVED);
+        check(checkIntKeys(fh, h), "mapped int keys");
+
+        if(fh)
+            frozenHashDel(fh);
+
+        hashDel(h);
+    }
+}
+
+static void testStructKeys() {
+    Hash h = hashNew(sizeof(Triple), EL_SHORT, hashTriple);
+    hashComparable(h, compareTriple);
+
+    for(int i=0; i<20000; i++) {
+        Triple k = {i, i*7, -i};
+        short v = (short)i;
+        hashSet(h, k, v);
+    }
+
+    FrozenHash fh = hashFreeze(h);
+    bool ok = fh && frozenHashLength(fh) == 20000;
+
+    for(int i=0; ok && i<20000; i++) {
+        Triple k = {i, i*7, -i};
+        const short *value = frozenHashGet(fh, k);
+        ok = value && *value == (short)i;
+
+        // Only one field differs
+        Triple missing = {i, i*7, i+1};
+        ok = ok && frozenHashGet(fh, missing) == NULL;
+    }
+
+    check(ok, "frozen struct keys");
+
+    if(fh)
+        frozenHashDel(fh);
+
+    hashDel(h);
+}
+
+static bool checkStringKeys(const FrozenHash fh, int nb) {
+    char buff[32];
+    bool ok = fh && frozenHashLength(fh) == nb && frozenHashHasStringKeys(fh);
+
+    for(int i=0; ok && i<nb; i++) {
+        sprintf(buff, "key%d", i);
+        const int *value = frozenHashGetStr(fh, buff);
+        ok = value && *value == i;
+
+        sprintf(buff, "key%d", i+nb);
+        ok = ok && frozenHashGetStr(fh, buff) == NULL;
+    }
+
+    return ok && frozenHashGetStr(fh, "key") == NULL && frozenHashGetStr(fh, "") == NULL;
+}
+
+static void testStringKeys() {
+    int lengths[] = {0, 1, 50000};
+
+    for(int l=0; l<3; l++) {
+        Hash h = hashNewStr(EL_INT);
+        char buff[32];
+
+        for(int i=0; i<lengths[l]; i++) {
+            char *key = buff;
+            sprintf(buff, "key%d", i);
+            hashSetIV(h, key, i, int);
+        }
+
+        FrozenHash fh = hashFreeze(h);
+        check(checkStringKeys(fh, lengths[l]), "frozen string keys");
+
+        check(fh && frozenHashSave(fh, SAVED), "save of string keys");
+
+        if(fh)
+            frozenHashDel(fh);
+
+        fh = frozenHashOpen(SAVED);
+        check(checkStringKeys(fh, lengths[l]), "mapped string keys");
+
+        if(fh)
+            frozenHashDel(fh);
+
+        hashDel(h);
+    }
+}
+
+// The last file saved holds string keys : none of its truncated copies may be opened
+static void testTruncatedFile() {
+    FILE *file = fopen(SAVED, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buff = malloc(size);
+    bool ok = fread(buff, 1, size, file) == (size_t)size;
+    fclose(file);
+
+    for(long s=0; ok && s<size; s += 1 + rand()%4096) {
+        file = fopen(SAVED, "wb");
+        fwrite(buff, 1, s, file);
+        fclose(file);
+
+        FrozenHash fh = frozenHashOpen(SAVED);
+        ok = fh == NULL;
+
+        if(fh)
+            frozenHashDel(fh);
+    }
+
+    check(ok, "truncated file");
+    free(buff);
+}
+
+int main() {
+    srand(46);
+
+    testIntKeys();
+    testStructKeys();
+    testStringKeys();
+    testTruncatedFile();
+
+    remove(SAVED);
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
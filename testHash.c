@@ -0,0 +1,228 @@
+#include "ExtLib/Hash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Hash keeps its entries in insertion order : each test replays its updates on a plain array of keys in that order,
+// and checks the hash table against it
+
+#define NBKEYS 20000
+
+static long checks = 0;
+static long failures = 0;
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+// order holds the keys in insertion order, live tells which ones are still in h, with the value key*factor
+static void checkContent(Hash h, int *order, const bool *live, int nb, long factor, const char *what) {
+    int length = 0;
+    int pos = 0;
+    bool ok = true;
+
+    for(int i=0; i<nb; i++) {
+        if(!live[i]) {
+            ok = ok && !hashContains(h, order[i]);
+            continue;
+        }
+
+        length++;
+        ok = ok && hashContains(h, order[i]) && hashGet(h, order[i], long) == order[i]*factor;
+    }
+
+    check(ok && hashLength(h) == length, what);
+
+    // The iteration visits the live keys in insertion order
+    HashIt it = hashItNew(h);
+
+    for(int i=0; i<nb && ok; i++) {
+        if(!live[i])
+            continue;
+
+        ok = hashItExists(&it) && hashItGetKey(&it, int) == order[i] && hashItGet(&it, long) == order[i]*factor;
+        hashItNext(&it);
+        pos++;
+    }
+
+    check(ok && !hashItExists(&it) && pos == length, what);
+}
+
+static void testSetUnset() {
+    Hash h = hashNew(EL_INT, EL_LONG, NULL);
+    int *order = malloc(NBKEYS * sizeof(int));
+    bool *live = malloc(NBKEYS * sizeof(bool));
+
+    // Keys in a shuffled order, so that the insertion order isn't the order of the keys
+    for(int i=0; i<NBKEYS; i++)
+        order[i] = i;
+
+    for(int i=NBKEYS-1; i>0; i--) {
+        int j = rand()%(i+1);
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    for(int i=0; i<NBKEYS; i++) {
+        long v = order[i]*2;
+        hashSet(h, order[i], v);
+        live[i] = true;
+    }
+
+    checkContent(h, order, live, NBKEYS, 2, "set");
+
+    // Overwriting a value keeps the position of its key
+    for(int i=0; i<NBKEYS; i++) {
+        long v = order[i]*3;
+        hashSet(h, order[i], v);
+    }
+
+    checkContent(h, order, live, NBKEYS, 3, "overwrite");
+
+    for(int i=0; i<NBKEYS; i++) {
+        if(rand()%3 == 0) {
+            check(hashUnset(h, order[i]), "unset of a present key");
+            live[i] = false;
+        }
+    }
+
+    int missing = NBKEYS;
+    check(!hashUnset(h, missing), "unset of a missing key");
+
+    checkContent(h, order, live, NBKEYS, 3, "iteration after unset");
+
+    // Removing most keys compacts the entries, the remaining ones keep their order
+    for(int i=0; i<NBKEYS; i++) {
+        if(live[i] && rand()%10 != 0) {
+            hashUnset(h, order[i]);
+            live[i] = false;
+        }
+    }
+
+    checkContent(h, order, live, NBKEYS, 3, "iteration after compaction");
+
+    hashClear(h);
+
+    HashIt it = hashItNew(h);
+    check(hashLength(h) == 0 && !hashItExists(&it) && !hashContains(h, order[0]), "clear");
+
+    free(order);
+    free(live);
+    hashDel(h);
+}
+
+// Entries removed by iterators are only compacted when the entry array is full : the next insertions must
+// reuse the room of the removed entries instead of growing, and keep the order
+static void testCompactionOnResize() {
+    Hash h = hashNew(EL_INT, EL_LONG, NULL);
+    int order[3*NBKEYS];
+    bool live[3*NBKEYS];
+    int nb = 0;
+
+    for(int round=0; round<3; round++) {
+        for(int i=0; i<NBKEYS; i++, nb++) {
+            order[nb] = round*NBKEYS + i;
+            live[nb] = true;
+
+            long v = order[nb]*5;
+            hashSet(h, order[nb], v);
+        }
+
+        // Removes 3 keys out of 4 through an iterator, which leaves removed entries in the array
+        int pos = 0;
+        for(HashIt it = hashItNew(h); hashItExists(&it); hashItNext(&it)) {
+            while(!live[pos])
+                pos++;
+
+            if(hashItGetKey(&it, int) % 4 != 0) {
+                hashItRemove(&it);
+                live[pos] = false;
+            }
+
+            pos++;
+        }
+
+        checkContent(h, order, live, nb, 5, "iteration after iterator removal");
+    }
+
+    checkContent(h, order, live, nb, 5, "compaction on resize");
+
+    hashDel(h);
+}
+
+static void testClone() {
+    Hash h = hashNew(EL_INT, EL_LONG, NULL);
+    int order[NBKEYS];
+    bool live[NBKEYS];
+
+    for(int i=0; i<NBKEYS; i++) {
+        order[i] = NBKEYS-i;
+        live[i] = i%5 != 0;
+
+        long v = order[i]*7;
+        hashSet(h, order[i], v);
+    }
+
+    for(int i=0; i<NBKEYS; i++)
+        if(!live[i])
+            hashUnset(h, order[i]);
+
+    Hash h2 = hashClone(h);
+
+    checkContent(h2, order, live, NBKEYS, 7, "clone");
+
+    // The clone is independent of the original
+    for(int i=0; i<NBKEYS; i++)
+        if(live[i])
+            hashUnset(h2, order[i]);
+
+    check(hashLength(h2) == 0, "unset in clone");
+    checkContent(h, order, live, NBKEYS, 7, "original after clone update");
+
+    hashDel(h2);
+    hashDel(h);
+
+    // String keys are copied again by the clone
+    Hash s = hashNewStr(EL_INT);
+    char buff[32];
+
+    for(int i=0; i<1000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        hashSet(s, key, i);
+    }
+
+    Hash s2 = hashClone(s);
+    hashDel(s);
+
+    bool ok = hashLength(s2) == 1000;
+    int i = 0;
+
+    for(HashIt it = hashItNew(s2); hashItExists(&it); hashItNext(&it), i++) {
+        sprintf(buff, "key%d", i);
+        ok = ok && strcmp(hashItGetKey(&it, char *), buff) == 0 && hashItGet(&it, int) == i;
+    }
+
+    check(ok && i == 1000, "clone of string keys");
+
+    hashDel(s2);
+}
+
+int main() {
+    srand(50);
+
+    testSetUnset();
+    testCompactionOnResize();
+    testClone();
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
@@ -0,0 +1,235 @@
+#include "ExtLib/HashSet.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Random insertions and removals are replayed on a bitmap of the keys, and the set is checked against it. A weak hash
+// function, giving the same hash to 64 keys in a row, makes long probe sequences cross groups and the mirrored control
+// bytes at the end of the table.
+
+#define NBKEYS 20000
+#define NBOPS 300000
+
+static long checks = 0;
+static long failures = 0;
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+static unsigned long weakHash(Ptr key) {
+    return *(int*)key / 64;
+}
+
+// The set holds exactly the keys of the bitmap, each once
+static bool sameKeys(const HashSet s, const bool *in, int nbKeys) {
+    bool *seen = calloc(nbKeys, sizeof(bool));
+    int length = 0;
+    bool ok = true;
+
+    for(int k=0; k<nbKeys; k++) {
+        length += in[k];
+        ok = ok && hashSetContains(s, k) == in[k];
+    }
+
+    ok = ok && hashSetLength(s) == length;
+
+    for(HashSetIt it = hashSetItNew(s); ok && hashSetItExists(&it); hashSetItNext(&it)) {
+        int k = hashSetItGet(&it, int);
+
+        ok = k >= 0 && k < nbKeys && in[k] && !seen[k];
+        seen[k] = true;
+        length--;
+    }
+
+    free(seen);
+
+    return ok && length == 0;
+}
+
+static void testRandomUpdates(ElHashFct hashFct, const char *what) {
+    HashSet s = hashSetNew(EL_INT, hashFct);
+    bool in[NBKEYS] = {false};
+    bool ok = true;
+
+    for(int op=0; op<NBOPS; op++) {
+        // Phases of mostly insertions and mostly removals, the removals leave deleted slots which the next insertions
+        // reuse or the rehash reclaims
+        int k = rand()%NBKEYS;
+        bool insert = rand()%4 != 0;
+
+        if((op/20000)%2 == 1)
+            insert = !insert;
+
+        if(insert) {
+            ok = ok && hashSetInsert(s, k) == !in[k];
+            in[k] = true;
+        }
+        else {
+            ok = ok && hashSetRemove(s, k) == in[k];
+            in[k] = false;
+        }
+
+        if(op%20000 == 19999) {
+            check(ok, what);
+            check(sameKeys(s, in, NBKEYS), what);
+        }
+    }
+
+    // Removes the even keys through an iterator
+    for(HashSetIt it = hashSetItNew(s); hashSetItExists(&it); hashSetItNext(&it)) {
+        int k = hashSetItGet(&it, int);
+
+        if(k%2 == 0) {
+            hashSetItRemove(&it);
+            in[k] = false;
+        }
+    }
+
+    check(sameKeys(s, in, NBKEYS), "removal by iterator");
+
+    HashSet s2 = hashSetClone(s);
+    check(sameKeys(s2, in, NBKEYS), "clone");
+    hashSetDel(s2);
+
+    hashSetClear(s);
+    memset(in, 0, sizeof(in));
+    check(sameKeys(s, in, NBKEYS), "clear");
+
+    hashSetDel(s);
+}
+
+// Keeps a few keys while many others come and go : only reclaiming the deleted slots bounds the table
+static void testChurn() {
+    HashSet s = hashSetNew(EL_INT, NULL);
+    bool ok = true;
+
+    for(int k=0; k<100; k++)
+        hashSetInsert(s, k);
+
+    for(int k=100; k<1000000; k++) {
+        hashSetInsert(s, k);
+        hashSetRemove(s, k);
+        ok = ok && hashSetLength(s) == 100;
+    }
+
+    for(int k=0; k<100; k++)
+        ok = ok && hashSetContains(s, k);
+
+    check(ok, "churn");
+
+    hashSetDel(s);
+}
+
+static HashSet randomSet(bool *in, int density, ElHashFct hashFct) {
+    HashSet s = hashSetNew(EL_INT, hashFct);
+
+    for(int k=0; k<NBKEYS; k++) {
+        in[k] = rand()%100 < density;
+
+        if(in[k])
+            hashSetInsert(s, k);
+    }
+
+    return s;
+}
+
+static void testSetOperations(ElHashFct hashFct) {
+    int densities[] = {0, 10, 50, 100};
+    static bool inA[NBKEYS], inB[NBKEYS], expected[NBKEYS];
+
+    for(int da=0; da<4; da++) {
+        for(int db=0; db<4; db++) {
+            HashSet a = randomSet(inA, densities[da], hashFct);
+            HashSet b = randomSet(inB, densities[db], hashFct);
+
+            HashSet u = hashSetUnion(a, b);
+            for(int k=0; k<NBKEYS; k++)
+                expected[k] = inA[k] || inB[k];
+            check(sameKeys(u, expected, NBKEYS), "union");
+
+            HashSet i = hashSetIntersection(a, b);
+            for(int k=0; k<NBKEYS; k++)
+                expected[k] = inA[k] && inB[k];
+            check(sameKeys(i, expected, NBKEYS), "intersection");
+
+            HashSet d = hashSetDifference(a, b);
+            for(int k=0; k<NBKEYS; k++)
+                expected[k] = inA[k] && !inB[k];
+            check(sameKeys(d, expected, NBKEYS), "difference");
+
+            // The operands are left unchanged
+            check(sameKeys(a, inA, NBKEYS) && sameKeys(b, inB, NBKEYS), "operands of set operations");
+
+            hashSetDel(u);
+            hashSetDel(i);
+            hashSetDel(d);
+            hashSetDel(a);
+            hashSetDel(b);
+        }
+    }
+
+    // Operations of a set with itself
+    HashSet a = randomSet(inA, 30, hashFct);
+    HashSet u = hashSetUnion(a, a);
+    HashSet i = hashSetIntersection(a, a);
+    HashSet d = hashSetDifference(a, a);
+
+    memset(expected, 0, sizeof(expected));
+    check(sameKeys(u, inA, NBKEYS) && sameKeys(i, inA, NBKEYS) && sameKeys(d, expected, NBKEYS), "operations of a set with itself");
+
+    hashSetDel(u);
+    hashSetDel(i);
+    hashSetDel(d);
+    hashSetDel(a);
+}
+
+static void testStrings() {
+    HashSet s = hashSetNewStr();
+    char buff[32];
+    bool ok = true;
+
+    for(int i=0; i<10000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        ok = ok && hashSetInsert(s, key);
+    }
+
+    // The set copied the strings
+    for(int i=0; i<10000; i+=2) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        ok = ok && hashSetRemove(s, key);
+    }
+
+    for(int i=0; i<10000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i);
+        ok = ok && hashSetContains(s, key) == (i%2 == 1);
+    }
+
+    check(ok && hashSetLength(s) == 5000, "string keys");
+
+    hashSetDel(s);
+}
+
+int main() {
+    srand(47);
+
+    testRandomUpdates(NULL, "random updates");
+    testRandomUpdates(weakHash, "random updates with a weak hash");
+    testChurn();
+    testSetOperations(NULL);
+    testSetOperations(weakHash);
+    testStrings();
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
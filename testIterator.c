@@ -0,0 +1,246 @@
+#include "ExtLib/Iterator.h"
+#include "ExtLib/List.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Every pipeline is checked against the same operations written as plain loops on an int array
+
+#define NB 1000
+
+static long checks = 0;
+static long failures = 0;
+
+static int values[NB];
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+static Array sourceArray(int from, int to) {
+    Array a = arrayNew(EL_INT);
+
+    for(int i=from; i<to; i++)
+        arrayPush(a, values[i]);
+
+    return a;
+}
+
+// Compares the ints given by an iterator to expected ones, and destroys the iterator
+static void checkInts(Iterator it, const int *expected, int nb, const char *what) {
+    Array res = iteratorCollectArray(it);
+    bool ok = arrayLength(res) == nb;
+
+    for(int i=0; ok && i<nb; i++)
+        ok = arrayGet(res, i, int) == expected[i];
+
+    check(ok, what);
+    arrayDel(res);
+}
+
+static bool isEven(Ptr obj, Ptr infos) {
+    return *(int*)obj % 2 == 0;
+}
+
+// Counts its calls in infos
+static bool isBelowCounted(Ptr obj, Ptr infos) {
+    int *calls = infos;
+
+    calls[0]++;
+
+    return *(int*)obj < calls[1];
+}
+
+static void tripleToLong(Ptr dest, Ptr src, Ptr infos) {
+    *(long*)dest = 3L * *(int*)src;
+}
+
+// Counts the elements read through it in infos
+static void countedCopy(Ptr dest, Ptr src, Ptr infos) {
+    (*(int*)infos)++;
+    *(int*)dest = *(int*)src;
+}
+
+static void sum(Ptr acc, Ptr obj, Ptr infos) {
+    *(long*)acc += *(int*)obj;
+}
+
+static void testAdaptors(Array a) {
+    int expected[2*NB];
+    int nb;
+
+    nb = 0;
+    for(int i=0; i<NB; i++)
+        if(values[i]%2 == 0)
+            expected[nb++] = values[i];
+    checkInts(iteratorFilter(iteratorNew((Collection)a), isEven, NULL), expected, nb, "filter");
+
+    Array mapped = iteratorCollectArray(iteratorMap(iteratorNew((Collection)a), EL_LONG, tripleToLong, NULL));
+    bool ok = arrayLength(mapped) == NB;
+    for(int i=0; ok && i<NB; i++)
+        ok = arrayGet(mapped, i, long) == 3L*values[i];
+    check(ok, "map");
+    arrayDel(mapped);
+
+    int counts[] = {0, 1, 7, NB-1, NB, NB+10};
+
+    for(int c=0; c<6; c++) {
+        int n = counts[c];
+        int kept = n < NB ? n : NB;
+
+        checkInts(iteratorTake(iteratorNew((Collection)a), n), values, kept, "take");
+        // Skipping past the end gives an empty iterator
+        checkInts(iteratorSkip(iteratorNew((Collection)a), n), values+kept, NB-kept, "skip");
+    }
+
+    // take stops reading its source once it has given its elements
+    int read = 0;
+    check(iteratorCount(iteratorTake(iteratorMap(iteratorNew((Collection)a), EL_INT, countedCopy, &read), 10)) == 10 && read == 10, "take reads no more than needed");
+
+    Array empty = arrayNew(EL_INT);
+    Array b = sourceArray(0, NB/2);
+
+    for(int i=0; i<NB; i++)
+        expected[i] = values[i];
+    for(int i=0; i<NB/2; i++)
+        expected[NB+i] = values[i];
+    checkInts(iteratorChain(iteratorNew((Collection)a), iteratorNew((Collection)b)), expected, NB+NB/2, "chain");
+    checkInts(iteratorChain(iteratorNew((Collection)empty), iteratorNew((Collection)a)), values, NB, "chain after an empty iterator");
+    checkInts(iteratorChain(iteratorNew((Collection)a), iteratorNew((Collection)empty)), values, NB, "chain before an empty iterator");
+
+    // Composition : the even elements of a then b, tripled, after the first 100 and at most 300 of them
+    nb = 0;
+    for(int i=0; i<NB+NB/2; i++)
+        if(expected[i]%2 == 0)
+            expected[nb++] = expected[i]*3;
+
+    Iterator it = iteratorChain(iteratorNew((Collection)a), iteratorNew((Collection)b));
+    it = iteratorFilter(it, isEven, NULL);
+    it = iteratorMap(it, EL_LONG, tripleToLong, NULL);
+    it = iteratorSkip(it, 100);
+    it = iteratorTake(it, 300);
+
+    Array composed = iteratorCollectArray(it);
+    ok = arrayLength(composed) == (nb-100 < 300 ? nb-100 : 300);
+    for(int i=0; ok && i<arrayLength(composed); i++)
+        ok = arrayGet(composed, i, long) == expected[100+i];
+    check(ok, "composition");
+    arrayDel(composed);
+
+    long total = 0, refTotal = 0;
+    for(int i=0; i<NB; i++)
+        refTotal += values[i];
+    iteratorReduce(iteratorNew((Collection)a), &total, sum, NULL);
+    check(total == refTotal, "reduce");
+
+    arrayDel(b);
+    arrayDel(empty);
+}
+
+static void testEarlyStop(Array a) {
+    // values[i] == i here : the predicates stop at the element equal to the bound
+    int calls[2] = {0, 0};
+
+    calls[1] = 10;
+    check(iteratorAll(iteratorNew((Collection)a), isBelowCounted, calls) == false && calls[0] == 11, "all stops at the first failure");
+
+    calls[0] = 0;
+    calls[1] = NB;
+    check(iteratorAll(iteratorNew((Collection)a), isBelowCounted, calls) == true && calls[0] == NB, "all");
+
+    calls[0] = 0;
+    calls[1] = 1;
+    check(iteratorAny(iteratorNew((Collection)a), isBelowCounted, calls) == true && calls[0] == 1, "any stops at the first success");
+
+    calls[0] = 0;
+    calls[1] = 0;
+    check(iteratorAny(iteratorNew((Collection)a), isBelowCounted, calls) == false && calls[0] == NB, "any");
+
+    calls[0] = 0;
+    Array empty = arrayNew(EL_INT);
+    check(iteratorAll(iteratorNew((Collection)empty), isBelowCounted, calls) && !iteratorAny(iteratorNew((Collection)empty), isBelowCounted, calls) && calls[0] == 0, "any and all on nothing");
+    arrayDel(empty);
+}
+
+static void testZip(Array a) {
+    // Keys from an array, values from a shorter list : the pairs stop with the list
+    List l = listNew(EL_LONG);
+
+    for(int i=0; i<NB/2; i++)
+        listAddLastI(l, 7L*i, long);
+
+    Hash h = hashNew(EL_INT, EL_LONG, NULL);
+    iteratorCollectHash(iteratorZip(iteratorNew((Collection)a), iteratorNew((Collection)l)), h);
+
+    bool ok = hashLength(h) == NB/2;
+    for(int i=0; ok && i<NB/2; i++)
+        ok = hashContains(h, values[i]) && hashGet(h, values[i], long) == 7L*i;
+    check(ok, "collect of zipped pairs into a hash");
+
+    // The keys and values of a hash, zipped back, rebuild it in the same order
+    Hash h2 = hashNew(EL_INT, EL_LONG, NULL);
+    iteratorCollectHash(iteratorZip(iteratorNewKeys(h), iteratorNew((Collection)h)), h2);
+
+    HashIt it2 = hashItNew(h2);
+    ok = hashLength(h2) == hashLength(h);
+    for(HashIt it = hashItNew(h); ok && hashItExists(&it); hashItNext(&it), hashItNext(&it2))
+        ok = hashItGetKey(&it, int) == hashItGetKey(&it2, int) && hashItGet(&it, long) == hashItGet(&it2, long);
+    check(ok, "zip of the keys and values of a hash");
+
+    // Pairs of differently sized objects : the second one is aligned after the first
+    Array chars = arrayNew(EL_CHAR);
+    for(int i=0; i<NB; i++)
+        arrayPushI(chars, (char)i, char);
+
+    Iterator zip = iteratorZip(iteratorNew((Collection)chars), iteratorMap(iteratorNew((Collection)a), EL_LONG, tripleToLong, NULL));
+    Ptr pair;
+    int i = 0;
+    ok = true;
+    while((pair = iteratorNext(zip))) {
+        ok = ok && *(char*)pair == (char)i && *(long*)iteratorPairSecond(pair, sizeof(char)) == 3L*values[i];
+        i++;
+    }
+    check(ok && i == NB, "zip of a char and a long");
+    iteratorDel(zip);
+
+    arrayDel(chars);
+    hashDel(h2);
+    hashDel(h);
+    listDel(l);
+}
+
+int main() {
+    srand(43);
+
+    // Distinct values in a random order, so that they can be keys
+    for(int i=0; i<NB; i++)
+        values[i] = 7*i;
+
+    for(int i=NB-1; i>0; i--) {
+        int j = rand()%(i+1);
+        int tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+    }
+
+    Array a = sourceArray(0, NB);
+    testAdaptors(a);
+    testZip(a);
+    arrayDel(a);
+
+    for(int i=0; i<NB; i++)
+        values[i] = i;
+
+    a = sourceArray(0, NB);
+    testEarlyStop(a);
+    arrayDel(a);
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
@@ -0,0 +1,247 @@
+#include "ExtLib/List.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every update of an unrolled list is replayed on a plain array, and the list is checked against it. Small nodes make
+// the insertions split nodes and the removals merge them often.
+
+#define NBOPS 20000
+#define MAXLENGTH 3000
+
+static const int nodeSizes[] = {2*sizeof(int), 3*sizeof(int), 16*sizeof(int), 0};
+#define NBNODESIZES (int)(sizeof(nodeSizes)/sizeof(nodeSizes[0]))
+
+static long checks = 0;
+static long failures = 0;
+
+static int ref[2*MAXLENGTH];
+static int length;
+
+static void check(bool ok, const char *what, int nodeSize) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed with nodes of %d bytes\n", what, nodeSize);
+    }
+}
+
+static void refInsert(int pos, int v) {
+    memmove(ref+pos+1, ref+pos, (length-pos)*sizeof(int));
+    ref[pos] = v;
+    length++;
+}
+
+static void refRemove(int pos) {
+    memmove(ref+pos, ref+pos+1, (length-pos-1)*sizeof(int));
+    length--;
+}
+
+static int cmpAsc(const void *v1, const void *v2) {
+    return (*(int*)v1 > *(int*)v2) - (*(int*)v1 < *(int*)v2);
+}
+
+static int cmpDesc(const void *v1, const void *v2) {
+    return cmpAsc(v2, v1);
+}
+
+// Walks the list forwards and backwards
+static void checkContent(List l, const char *what, int nodeSize) {
+    bool ok = listLength(l) == length;
+    int pos = 0;
+
+    for(ListIt it = listItNew(l); ok && listItExists(&it); listItNext(&it), pos++)
+        ok = pos < length && listItGet(&it, int) == ref[pos];
+
+    ok = ok && pos == length;
+    pos = length-1;
+
+    for(ListIt it = listItNewBack(l); ok && listItExists(&it); listItPrev(&it), pos--)
+        ok = pos >= 0 && listItGet(&it, int) == ref[pos];
+
+    ok = ok && pos == -1;
+
+    if(ok && length > 0)
+        ok = listGetFirst(l, int) == ref[0] && listGetLast(l, int) == ref[length-1];
+
+    check(ok, what, nodeSize);
+}
+
+// Iterator on the element at pos, reached from the nearest end
+static ListIt itAt(List l, int pos) {
+    ListIt it;
+
+    if(pos < length/2) {
+        it = listItNew(l);
+        for(int i=0; i<pos; i++)
+            listItNext(&it);
+    }
+    else {
+        it = listItNewBack(l);
+        for(int i=length-1; i>pos; i--)
+            listItPrev(&it);
+    }
+
+    return it;
+}
+
+static void testRandomUpdates(List l, int nodeSize) {
+    length = 0;
+
+    for(int op=0; op<NBOPS; op++) {
+        int v = rand();
+        int choice = rand()%10;
+
+        // Keeps the length moving up and down
+        if(length >= MAXLENGTH || (length > 0 && (op/2000)%2 == 1 && choice < 6))
+            choice = 6 + rand()%4;
+
+        if(length == 0 && choice >= 4)
+            choice = rand()%2;
+
+        switch(choice) {
+            case 0 :
+                listAddFirst(l, v);
+                refInsert(0, v);
+                break;
+            case 1 :
+                listAddLast(l, v);
+                refInsert(length, v);
+                break;
+            case 2 :
+            case 3 :
+                if(length == 0) {
+                    listAddLast(l, v);
+                    refInsert(0, v);
+                }
+                else {
+                    int pos = rand()%length;
+                    ListIt it = itAt(l, pos);
+
+                    if(choice == 2) {
+                        listItAddAfter(&it, v);
+                        refInsert(pos+1, v);
+                    }
+                    else {
+                        listItAddBefore(&it, v);
+                        refInsert(pos, v);
+                    }
+
+                    // The iterator stays on its element
+                    check(listItGet(&it, int) == ref[choice == 2 ? pos : pos+1], "iterator after insertion", nodeSize);
+                }
+                break;
+            case 4 : {
+                int pos = rand()%length;
+                ListIt it = itAt(l, pos);
+
+                listItSet(&it, v);
+                ref[pos] = v;
+                break;
+            }
+            case 5 :
+                if(rand()%2) {
+                    listRemoveFirst(l);
+                    refRemove(0);
+                }
+                else {
+                    listRemoveLast(l);
+                    refRemove(length-1);
+                }
+                break;
+            default : {
+                int pos = rand()%length;
+                ListIt it = itAt(l, pos);
+
+                listItRemove(&it);
+                refRemove(pos);
+
+                // After a removal, the next step goes to the element which followed the removed one
+                listItNext(&it);
+                check(pos < length ? listItExists(&it) && listItGet(&it, int) == ref[pos] : !listItExists(&it), "iterator after removal", nodeSize);
+                break;
+            }
+        }
+
+        if(op%500 == 0)
+            checkContent(l, "random updates", nodeSize);
+    }
+
+    checkContent(l, "random updates", nodeSize);
+}
+
+// Removes every element matching a condition during a single pass, which merges many nodes under the iterator
+static void testRemoveDuringIteration(List l, int nodeSize) {
+    int pos = 0;
+    int kept = 0;
+    bool ok = true;
+
+    for(ListIt it = listItNew(l); listItExists(&it); listItNext(&it), pos++) {
+        ok = ok && pos < length && listItGet(&it, int) == ref[pos];
+
+        if(ref[pos]%3 != 0)
+            listItRemove(&it);
+        else
+            ref[kept++] = ref[pos];
+    }
+
+    check(ok && pos == length, "iteration with removals", nodeSize);
+
+    length = kept;
+    checkContent(l, "content after removals", nodeSize);
+}
+
+static void testSort(List l, int nodeSize) {
+    while(length < MAXLENGTH) {
+        int v = rand()%1000;
+        listAddLast(l, v);
+        refInsert(length, v);
+    }
+
+    listSort(l, EL_ASC);
+    qsort(ref, length, sizeof(int), cmpAsc);
+    checkContent(l, "ascending sort", nodeSize);
+
+    listSort(l, EL_DESC);
+    qsort(ref, length, sizeof(int), cmpDesc);
+    checkContent(l, "descending sort", nodeSize);
+
+    // Insertions into the repacked full nodes split them
+    for(int i=0; i<length; i+=7) {
+        ListIt it = itAt(l, i);
+        int v = -i;
+
+        listItAddBefore(&it, v);
+        refInsert(i, v);
+    }
+
+    checkContent(l, "insertion after sort", nodeSize);
+}
+
+int main() {
+    srand(31);
+
+    for(int n=0; n<NBNODESIZES; n++) {
+        List l = listNewUnrolled(EL_INT, nodeSizes[n]);
+
+        testRandomUpdates(l, nodeSizes[n]);
+        testRemoveDuringIteration(l, nodeSizes[n]);
+        testSort(l, nodeSizes[n]);
+
+        List l2 = listClone(l);
+        checkContent(l2, "clone", nodeSizes[n]);
+
+        listClear(l);
+        length = 0;
+        checkContent(l, "clear", nodeSizes[n]);
+
+        listDel(l2);
+        listDel(l);
+    }
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
@@ -0,0 +1,343 @@
+#include "ExtLib/Array.h"
+#include "ExtLib/Hash.h"
+#include "ExtLib/View.h"
+
+#include "src/Serial.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tables are saved, then read back by arrayLoad and the views. Every truncated copy of a file, and copies with a
+// corrupted header, must then be rejected.
+
+#define SAVED "testSerial.bin"
+#define DAMAGED "testSerialDamaged.bin"
+
+static long checks = 0;
+static long failures = 0;
+
+static void check(bool ok, const char *what) {
+    checks++;
+
+    if(!ok) {
+        failures++;
+        printf("%s failed\n", what);
+    }
+}
+
+static char *readFile(const char *path, long *size) {
+    FILE *file = fopen(path, "rb");
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buff = malloc(*size + 1);
+    if(fread(buff, 1, *size, file) != (size_t)*size)
+        *size = -1;
+
+    fclose(file);
+
+    return buff;
+}
+
+static void writeFile(const char *path, const char *buff, long size) {
+    FILE *file = fopen(path, "wb");
+
+    fwrite(buff, 1, size, file);
+    fclose(file);
+}
+
+// Tells whether every reader rejects the damaged file
+static bool arrayRejected() {
+    Array a = arrayLoad(DAMAGED);
+    ArrayView v = arrayViewOpen(DAMAGED);
+    bool rejected = !a && !v;
+
+    if(a)
+        arrayDel(a);
+    if(v)
+        arrayViewClose(v);
+
+    return rejected;
+}
+
+static bool hashRejected() {
+    HashView v = hashViewOpen(DAMAGED);
+
+    if(v)
+        hashViewClose(v);
+
+    return !v;
+}
+
+// Writes every truncated copy of the saved file, and checks it is rejected
+static void checkTruncations(bool (*rejected)(), const char *what) {
+    long size;
+    char *buff = readFile(SAVED, &size);
+    bool ok = true;
+
+    // Every size for small files, some of them for the others
+    for(long s=0; s<size; s += size < 4096 ? 1 : 1 + rand()%64) {
+        writeFile(DAMAGED, buff, s);
+        ok = ok && rejected();
+    }
+
+    writeFile(DAMAGED, buff, size-1);
+    ok = ok && (size == 0 || rejected());
+
+    check(ok, what);
+    free(buff);
+}
+
+// Overwrites bytes of a copy of the saved file at offset, and checks it is rejected
+static void checkCorruption(bool (*rejected)(), long offset, const void *bytes, int nb, const char *what) {
+    long size;
+    char *buff = readFile(SAVED, &size);
+
+    memcpy(buff + offset, bytes, nb);
+    writeFile(DAMAGED, buff, size);
+
+    check(rejected(), what);
+    free(buff);
+}
+
+#define TEST_ARRAY(name, type, elType, value) \
+static void testArray##name(int length) { \
+    Array a = arrayNew(elType); \
+    \
+    for(int i=0; i<length; i++) \
+        arrayPushI(a, value, type); \
+    \
+    check(arraySave(a, SAVED), #name " save"); \
+    \
+    Array b = arrayLoad(SAVED); \
+    ArrayView v = arrayViewOpen(SAVED); \
+    bool ok = b && v && arrayLength(b) == length && arrayViewLength(v) == length && arrayViewGetElemSize(v) == sizeof(type); \
+    \
+    for(int i=0; ok && i<length; i++) \
+        ok = arrayGet(b, i, type) == arrayGet(a, i, type) && arrayViewGet(v, i, type) == arrayGet(a, i, type); \
+    \
+    check(ok, #name " round trip"); \
+    \
+    /* The comparison function of the type is linked again */ \
+    if(b && length > 0) { \
+        type first = arrayGet(a, 0, type); \
+        check(arrayIndexOf(b, &first) == 0, #name " comparison after load"); \
+    } \
+    \
+    if(b) \
+        arrayDel(b); \
+    if(v) \
+        arrayViewClose(v); \
+    arrayDel(a); \
+}
+
+TEST_ARRAY(Char, char, EL_CHAR, (char)(i*7))
+TEST_ARRAY(Short, short, EL_SHORT, (short)(i*301))
+TEST_ARRAY(Int, int, EL_INT, i*70001)
+TEST_ARRAY(Uint, unsigned int, EL_UINT, (unsigned int)i*2654435761u)
+TEST_ARRAY(Long, long, EL_LONG, -7L*i)
+TEST_ARRAY(Longlong, long long, EL_LONGLONG, (long long)i << 33)
+TEST_ARRAY(Float, float, EL_FLOAT, i*0.5f)
+TEST_ARRAY(Double, double, EL_DOUBLE, i*-0.25)
+TEST_ARRAY(Bool, bool, EL_BOOL, i%3 == 0)
+
+typedef struct {
+    int x;
+    char tag;
+} Point;
+
+static void testArrays() {
+    int lengths[] = {0, 1, 1000};
+
+    for(int l=0; l<3; l++) {
+        testArrayChar(lengths[l]);
+        testArrayShort(lengths[l]);
+        testArrayInt(lengths[l]);
+        testArrayUint(lengths[l]);
+        testArrayLong(lengths[l]);
+        testArrayLonglong(lengths[l]);
+        testArrayFloat(lengths[l]);
+        testArrayDouble(lengths[l]);
+        testArrayBool(lengths[l]);
+    }
+
+    // Elements of a positive size are saved bit by bit
+    Array a = arrayNew(sizeof(Point));
+    for(int i=0; i<100; i++) {
+        Point p = {i*3, 'a' + i%26};
+        arrayPush(a, p);
+    }
+
+    check(arraySave(a, SAVED), "struct save");
+
+    Array b = arrayLoad(SAVED);
+    bool ok = b && arrayLength(b) == 100;
+    for(int i=0; ok && i<100; i++)
+        ok = arrayGet(b, i, Point).x == i*3 && arrayGet(b, i, Point).tag == 'a' + i%26;
+    check(ok, "struct round trip");
+
+    if(b)
+        arrayDel(b);
+
+    checkTruncations(arrayRejected, "truncated array");
+
+    uint32_t badMagic = 0x12345678;
+    uint32_t badVersion = SERIAL_VERSION+1;
+    int32_t zero = 0;
+    int32_t badType = EL_POINTER;
+    uint64_t hugeLength = 1ull << 40;
+    uint64_t longer = 101;
+
+    checkCorruption(arrayRejected, offsetof(ArrayFileHeader, magic), &badMagic, sizeof(badMagic), "array magic");
+    checkCorruption(arrayRejected, offsetof(ArrayFileHeader, version), &badVersion, sizeof(badVersion), "array version");
+    checkCorruption(arrayRejected, offsetof(ArrayFileHeader, elemSize), &zero, sizeof(zero), "array element size");
+    checkCorruption(arrayRejected, offsetof(ArrayFileHeader, length), &hugeLength, sizeof(hugeLength), "array huge length");
+    checkCorruption(arrayRejected, offsetof(ArrayFileHeader, length), &longer, sizeof(longer), "array length beyond the file");
+
+    // Only arrayLoad creates an array of the saved type, the view only reads bytes
+    long size;
+    char *buff = readFile(SAVED, &size);
+    memcpy(buff + offsetof(ArrayFileHeader, elType), &badType, sizeof(badType));
+    writeFile(DAMAGED, buff, size);
+    check(arrayLoad(DAMAGED) == NULL, "array of pointers");
+    free(buff);
+
+    arrayDel(a);
+
+    // Pointers can't be saved
+    Array p = arrayNew(EL_POINTER);
+    arrayPushI(p, &a, Ptr);
+    check(!arraySave(p, SAVED), "save of pointers");
+    arrayDel(p);
+}
+
+static void testHashes() {
+    // EL_* keys, and an empty table
+    int lengths[] = {0, 1, 5000};
+
+    for(int l=0; l<3; l++) {
+        Hash h = hashNew(EL_LONGLONG, EL_DOUBLE, NULL);
+
+        for(int i=0; i<lengths[l]; i++) {
+            long long k = (long long)i*1000003 - 7;
+            double v = i*0.5;
+            hashSet(h, k, v);
+        }
+
+        check(hashSave(h, SAVED), "hash save");
+
+        HashView v = hashViewOpen(SAVED);
+        bool ok = v && hashViewLength(v) == lengths[l] && !hashViewHasStringKeys(v);
+
+        for(HashIt it = hashItNew(h); ok && hashItExists(&it); hashItNext(&it)) {
+            const double *value = hashViewGet_base(v, hashItGetKey_base(&it));
+            ok = value && *value == hashItGet(&it, double);
+        }
+
+        for(int i=0; ok && i<100; i++) {
+            long long missing = (long long)i*1000003 - 6;
+            ok = hashViewGet(v, missing) == NULL;
+        }
+
+        check(ok, "hash round trip");
+
+        if(v)
+            hashViewClose(v);
+
+        hashDel(h);
+    }
+
+    // String keys
+    Hash h = hashNewStr(EL_INT);
+    char buff[32];
+
+    for(int i=0; i<3000; i++) {
+        char *key = buff;
+        sprintf(buff, "key%d", i*13);
+        hashSetIV(h, key, i, int);
+    }
+
+    check(hashSave(h, SAVED), "string hash save");
+
+    HashView v = hashViewOpen(SAVED);
+    bool ok = v && hashViewLength(v) == 3000 && hashViewHasStringKeys(v);
+
+    for(int i=0; ok && i<3000; i++) {
+        sprintf(buff, "key%d", i*13);
+        const int *value = hashViewGetStr(v, buff);
+        ok = value && *value == i;
+
+        sprintf(buff, "key%d", i*13+1);
+        ok = ok && hashViewGetStr(v, buff) == NULL;
+    }
+
+    check(ok, "string hash round trip");
+
+    if(v)
+        hashViewClose(v);
+
+    hashDel(h);
+
+    // The string file is the last one saved : it has every section
+    checkTruncations(hashRejected, "truncated hash");
+
+    long size;
+    char *file = readFile(SAVED, &size);
+    const HashFileHeader *header = (const HashFileHeader *)file;
+
+    uint32_t badMagic = 0x12345678;
+    uint32_t badVersion = SERIAL_VERSION+1;
+    uint32_t badBuckets = header->nbBuckets+1;
+    uint32_t badElemSize = header->elemSize+8;
+    uint64_t misaligned = header->bucketsOffset+4;
+    uint64_t badFileSize = header->fileSize+1;
+    uint64_t hugeLength = 1ull << 40;
+    uint32_t badTotal = header->length+1;
+    char notTerminated = 'x';
+
+    checkCorruption(hashRejected, offsetof(HashFileHeader, magic), &badMagic, sizeof(badMagic), "hash magic");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, version), &badVersion, sizeof(badVersion), "hash version");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, nbBuckets), &badBuckets, sizeof(badBuckets), "hash bucket count");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, elemSize), &badElemSize, sizeof(badElemSize), "hash entry layout");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, bucketsOffset), &misaligned, sizeof(misaligned), "hash buckets offset");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, fileSize), &badFileSize, sizeof(badFileSize), "hash file size");
+    checkCorruption(hashRejected, offsetof(HashFileHeader, length), &hugeLength, sizeof(hugeLength), "hash huge length");
+    checkCorruption(hashRejected, header->bucketsOffset + header->nbBuckets*sizeof(uint32_t), &badTotal, sizeof(badTotal), "hash bucket total");
+    checkCorruption(hashRejected, size-1, &notTerminated, 1, "hash strings end");
+
+    // A corrupted bucket inside the table isn't checked at opening, but lookups stay in the file
+    uint32_t badIndex = UINT32_MAX;
+    memcpy(file + header->bucketsOffset + sizeof(uint32_t), &badIndex, sizeof(badIndex));
+    writeFile(DAMAGED, file, size);
+
+    v = hashViewOpen(DAMAGED);
+    ok = v != NULL;
+    for(int i=0; ok && i<3000; i++) {
+        sprintf(buff, "key%d", i*13);
+        const int *value = hashViewGetStr(v, buff);
+        ok = !value || *value == i;
+    }
+    check(ok, "lookups in a corrupted bucket");
+
+    if(v)
+        hashViewClose(v);
+
+    free(file);
+}
+
+int main() {
+    srand(45);
+
+    testArrays();
+    testHashes();
+
+    remove(SAVED);
+    remove(DAMAGED);
+
+    printf("%ld checks, %ld failures\n", checks, failures);
+
+    return failures != 0;
+}
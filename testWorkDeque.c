@@ -0,0 +1,91 @@
+#define _GNU_SOURCE
+
+#include "ExtLib/WorkDeque.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NBITEMS 2000000
+#define NBTHIEVES 4
+
+static WorkDeque wd;
+static int *seen;
+static bool done;
+
+static void *thief(long *stolen) {
+    int v;
+
+    while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE) || !workDequeIsEmpty(wd)) {
+        if(workDequeSteal(wd, v)) {
+            __atomic_add_fetch(&seen[v], 1, __ATOMIC_RELAXED);
+            (*stolen)++;
+        }
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+// The owner pushes every item, and pops some of them back in bursts so that it often races the thieves for the last elements
+int main() {
+    pthread_t thieves[NBTHIEVES];
+    long stolen[NBTHIEVES] = {0};
+    long popped = 0;
+    int v;
+
+    wd = workDequeNew(EL_INT);
+    seen = calloc(NBITEMS, sizeof(int));
+
+    for(int i=0; i<NBTHIEVES; i++)
+        pthread_create(&thieves[i], NULL, (void *(*)(void *))thief, &stolen[i]);
+
+    srand(7);
+
+    for(int i=0; i<NBITEMS; i++) {
+        workDequePush(wd, i);
+
+        if(rand()%8 == 0) {
+            int burst = rand()%16;
+            for(int k=0; k<burst && workDequePop(wd, v); k++) {
+                seen[v]++;
+                popped++;
+            }
+        }
+
+        if(i%4096 == 0)
+            sched_yield();
+    }
+
+    while(workDequePop(wd, v)) {
+        seen[v]++;
+        popped++;
+    }
+
+    __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+
+    long totalStolen = 0;
+    for(int i=0; i<NBTHIEVES; i++) {
+        pthread_join(thieves[i], NULL);
+        totalStolen += stolen[i];
+    }
+
+    int lost = 0, duplicated = 0;
+    for(int i=0; i<NBITEMS; i++) {
+        if(seen[i] == 0)
+            lost++;
+        else if(seen[i] > 1)
+            duplicated++;
+    }
+
+    printf("%d items : %ld popped, %ld stolen, %d lost, %d duplicated\n", NBITEMS, popped, totalStolen, lost, duplicated);
+
+    workDequeDump(wd);
+
+    workDequeDel(wd);
+    free(seen);
+
+    return lost || duplicated;
+}